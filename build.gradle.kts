@@ -10,4 +10,17 @@ repositories {
 dependencies {
     implementation("org.slf4j:slf4j-api:2.1.0-alpha1")
     implementation("org.apache.logging.log4j:log4j-slf4j2-impl:3.0.0-beta2")
-}
\ No newline at end of file
+}
+
+// ./gradlew packAssets -PassetsDir=<directory> [-PassetPack=<file>], see UefAssetPacker.
+val packAssets by tasks.registering(JavaExec::class) {
+    group = "build"
+    description = "Packs a directory of assets into a pack for UefPlatform.mountAssetPack."
+    classpath = sourceSets["main"].runtimeClasspath
+    mainClass.set("net.rk4z.juef.UefAssetPacker")
+
+    val assetsDir = providers.gradleProperty("assetsDir").orElse("assets")
+    val assetPack = providers.gradleProperty("assetPack")
+        .orElse(layout.buildDirectory.file("assets.uefpack").map { it.asFile.path })
+    argumentProviders.add(CommandLineArgumentProvider { listOf(assetsDir.get(), assetPack.get()) })
+}
@@ -0,0 +1,186 @@
+#include "AssetPack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr char kAssetPackMagic[8] = {'U', 'E', 'F', 'P', 'A', 'C', 'K', '\0'};
+static constexpr size_t kAlignment = 64;
+
+static void KeepMapped(void *userData, void *data) {
+}
+
+std::shared_ptr<AssetPack> AssetPack::open(const std::string &path, std::string &error) {
+    const uint8_t *base = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Cannot open asset pack " + path;
+        return nullptr;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        length = static_cast<size_t>(info.st_size);
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping != MAP_FAILED) {
+            base = static_cast<const uint8_t *>(mapping);
+            mapped = true;
+        }
+    }
+    close(fd);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (in) {
+        length = static_cast<size_t>(static_cast<std::streamoff>(in.tellg()));
+        auto copy = static_cast<char *>(::operator new(length ? length : 1, std::align_val_t(kAlignment)));
+        if (in.seekg(0).read(copy, static_cast<std::streamsize>(length))) {
+            base = reinterpret_cast<const uint8_t *>(copy);
+        } else {
+            ::operator delete(copy, std::align_val_t(kAlignment));
+        }
+    }
+#endif
+
+    if (!base) {
+        error = "Cannot read asset pack " + path;
+        return nullptr;
+    }
+
+    std::shared_ptr<AssetPack> pack(new AssetPack(base, length, mapped));
+    if (!pack->validate(error)) {
+        error = path + ": " + error;
+        return nullptr;
+    }
+    return pack;
+}
+
+AssetPack::AssetPack(const uint8_t *base, size_t length, bool mapped) : base_(base), length_(length), mapped_(mapped) {
+}
+
+AssetPack::~AssetPack() {
+#ifndef _WIN32
+    if (mapped_) {
+        munmap(const_cast<uint8_t *>(base_), length_);
+        return;
+    }
+#endif
+    ::operator delete(const_cast<uint8_t *>(base_), std::align_val_t(kAlignment));
+}
+
+bool AssetPack::validate(std::string &error) {
+    if (length_ < sizeof(AssetPackHeader)) {
+        error = "not an asset pack";
+        return false;
+    }
+
+    AssetPackHeader header;
+    memcpy(&header, base_, sizeof(header));
+    if (memcmp(header.magic, kAssetPackMagic, sizeof(kAssetPackMagic)) != 0) {
+        error = "not an asset pack";
+        return false;
+    }
+    if (header.version != kVersion) {
+        error = "unsupported asset pack version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.fileSize != length_ || header.indexOffset % alignof(AssetPackEntry) != 0
+        || header.indexOffset > length_ || header.entryCount > (length_ - header.indexOffset) / sizeof(AssetPackEntry)
+        || header.stringsOffset > length_ || header.stringsSize > length_ - header.stringsOffset) {
+        error = "truncated or corrupt asset pack";
+        return false;
+    }
+
+    entries_ = reinterpret_cast<const AssetPackEntry *>(base_ + header.indexOffset);
+    count_ = header.entryCount;
+    strings_ = base_ + header.stringsOffset;
+    stringsSize_ = header.stringsSize;
+
+    // Checked once here so lookups can trust every offset.
+    auto fits = [](uint64_t offset, uint64_t size, uint64_t limit) { return offset <= limit && size <= limit - offset; };
+    for (uint32_t i = 0; i < count_; i++) {
+        const AssetPackEntry &entry = entries_[i];
+        if (!fits(entry.dataOffset, entry.size, length_) || !fits(entry.pathOffset, entry.pathLength, stringsSize_)
+            || !fits(entry.mimeOffset, entry.mimeLength, stringsSize_)
+            || !fits(entry.charsetOffset, entry.charsetLength, stringsSize_)) {
+            error = "entry " + std::to_string(i) + " points outside the pack";
+            return false;
+        }
+        if (i > 0 && path(entries_[i - 1]) >= path(entry)) {
+            error = "index is not sorted";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string AssetPack::path(const AssetPackEntry &entry) const {
+    return std::string(string(entry.pathOffset), entry.pathLength);
+}
+
+const AssetPackEntry *AssetPack::find(const String &file_path) const {
+    const String8 &utf8 = file_path.utf8();
+    const char *key = utf8.data();
+    size_t keyLength = utf8.length();
+    while (keyLength && *key == '/') {
+        key++;
+        keyLength--;
+    }
+
+    uint32_t low = 0;
+    uint32_t high = count_;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        const AssetPackEntry &entry = entries_[middle];
+        int order = memcmp(string(entry.pathOffset), key, std::min<size_t>(entry.pathLength, keyLength));
+        if (order == 0) {
+            order = entry.pathLength < keyLength ? -1 : entry.pathLength > keyLength ? 1 : 0;
+        }
+        if (order == 0) {
+            return &entry;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return nullptr;
+}
+
+bool AssetPack::FileExists(const String &file_path) {
+    return find(file_path) != nullptr;
+}
+
+String AssetPack::GetFileMimeType(const String &file_path) {
+    const AssetPackEntry *entry = find(file_path);
+    if (!entry || !entry->mimeLength) {
+        return "application/unknown";
+    }
+    return String(string(entry->mimeOffset), entry->mimeLength);
+}
+
+String AssetPack::GetFileCharset(const String &file_path) {
+    const AssetPackEntry *entry = find(file_path);
+    if (!entry || !entry->charsetLength) {
+        return "utf-8";
+    }
+    return String(string(entry->charsetOffset), entry->charsetLength);
+}
+
+RefPtr<Buffer> AssetPack::OpenFile(const String &file_path) {
+    const AssetPackEntry *entry = find(file_path);
+    if (!entry) {
+        return nullptr;
+    }
+    return Buffer::Create(const_cast<uint8_t *>(base_ + entry->dataOffset), static_cast<size_t>(entry->size), nullptr, KeepMapped);
+}
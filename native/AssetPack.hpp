@@ -0,0 +1,80 @@
+#ifndef ASSETPACK_HPP
+#define ASSETPACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <Ultralight/platform/FileSystem.h>
+
+using namespace ultralight;
+
+// On-disk layout written by net.rk4z.juef.UefAssetPacker, little-endian.
+struct AssetPackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t indexOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t fileSize;
+    uint8_t reserved[16];
+};
+
+struct AssetPackEntry {
+    uint64_t dataOffset;
+    uint64_t size;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint32_t mimeOffset;
+    uint32_t mimeLength;
+    uint32_t charsetOffset;
+    uint32_t charsetLength;
+};
+
+static_assert(sizeof(AssetPackHeader) == 64, "AssetPackHeader must match UefAssetPacker");
+static_assert(sizeof(AssetPackEntry) == 40, "AssetPackEntry must match UefAssetPacker");
+
+/**
+ * A read-only bundle of files mapped into memory once. The index is sorted by UTF-8 path, so a lookup
+ * is a binary search, and carries each file's mime type and charset as decided by the packer. Blobs
+ * are 64-byte aligned (page-aligned from 4 KiB up), and OpenFile hands out Buffers that point straight
+ * into the mapping.
+ *
+ * Packs are never unmapped: once mounted they serve the engine for the rest of the process, which is
+ * what lets their Buffers get away without a deallocator.
+ */
+class AssetPack : public FileSystem {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    // nullptr with error set when the file is missing or malformed.
+    static std::shared_ptr<AssetPack> open(const std::string &path, std::string &error);
+    ~AssetPack() override;
+
+    bool FileExists(const String &file_path) override;
+    String GetFileMimeType(const String &file_path) override;
+    String GetFileCharset(const String &file_path) override;
+    RefPtr<Buffer> OpenFile(const String &file_path) override;
+
+    uint32_t size() const { return count_; }
+    const AssetPackEntry &entry(uint32_t index) const { return entries_[index]; }
+    std::string path(const AssetPackEntry &entry) const;
+
+private:
+    AssetPack(const uint8_t *base, size_t length, bool mapped);
+
+    bool validate(std::string &error);
+    const AssetPackEntry *find(const String &file_path) const;
+    const char *string(uint32_t offset) const { return reinterpret_cast<const char *>(strings_) + offset; }
+
+    const uint8_t *base_;
+    size_t length_;
+    bool mapped_;
+    const AssetPackEntry *entries_ = nullptr;
+    uint32_t count_ = 0;
+    const uint8_t *strings_ = nullptr;
+    uint64_t stringsSize_ = 0;
+};
+
+#endif //ASSETPACK_HPP
@@ -0,0 +1,211 @@
+#include "ClasspathFileSystem.hpp"
+#include "JniRegistry.hpp"
+#include "UefFileSystem.hpp"
+#include "UefRenderer.hpp"
+#include "Utils.hpp"
+
+#include <cstring>
+#include <utility>
+
+std::atomic<uint64_t> ClasspathFileSystem::hits_{0};
+std::atomic<uint64_t> ClasspathFileSystem::misses_{0};
+std::atomic<uint64_t> ClasspathFileSystem::notFound_{0};
+std::atomic<uint64_t> ClasspathFileSystem::loadedBytes_{0};
+std::atomic<uint64_t> ClasspathFileSystem::evictions_{0};
+std::atomic<uint64_t> ClasspathFileSystem::cachedEntries_{0};
+std::atomic<uint64_t> ClasspathFileSystem::totalCachedBytes_{0};
+
+static void ReleaseEntry(void *userData, void *data) {
+    delete static_cast<std::shared_ptr<HeapBlob> *>(userData);
+}
+
+ClasspathFileSystem::ClasspathFileSystem(jint mount, size_t maxCachedBytes)
+    : mount_(mount), maxCachedBytes_(maxCachedBytes) {
+}
+
+void ClasspathFileSystem::add(std::string path, const std::string &mime, const std::string &charset) {
+    // A mount lists thousands of files but only a handful of distinct types.
+    uint16_t type = 0;
+    while (type < types_.size()) {
+        const Type &known = types_[type];
+        if (known.mime.utf8().length() == mime.size() && known.charset.utf8().length() == charset.size()
+            && memcmp(known.mime.utf8().data(), mime.data(), mime.size()) == 0
+            && memcmp(known.charset.utf8().data(), charset.data(), charset.size()) == 0) {
+            break;
+        }
+        type++;
+    }
+    if (type == types_.size()) {
+        types_.push_back({String(mime.data(), mime.size()), String(charset.data(), charset.size())});
+    }
+    files_[std::move(path)] = type;
+}
+
+std::string ClasspathFileSystem::key(const String &file_path) {
+    const String8 &utf8 = file_path.utf8();
+    return std::string(utf8.data(), utf8.length());
+}
+
+const ClasspathFileSystem::Type *ClasspathFileSystem::find(const String &file_path) const {
+    auto file = files_.find(key(file_path));
+    return file != files_.end() ? &types_[file->second] : nullptr;
+}
+
+bool ClasspathFileSystem::FileExists(const String &file_path) {
+    return find(file_path) != nullptr;
+}
+
+String ClasspathFileSystem::GetFileMimeType(const String &file_path) {
+    const Type *type = find(file_path);
+    return type && !type->mime.empty() ? type->mime : String("application/unknown");
+}
+
+String ClasspathFileSystem::GetFileCharset(const String &file_path) {
+    const Type *type = find(file_path);
+    return type && !type->charset.empty() ? type->charset : String("utf-8");
+}
+
+RefPtr<Buffer> ClasspathFileSystem::OpenFile(const String &file_path) {
+    std::string path = key(file_path);
+    if (!files_.count(path)) {
+        return nullptr;
+    }
+
+    Entry entry = cached(path);
+    if (entry) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        // Two threads missing the same path both read it; the second insert just replaces the first.
+        entry = load(file_path);
+        if (!entry) {
+            notFound_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        loadedBytes_.fetch_add(entry->size, std::memory_order_relaxed);
+        insert(path, entry);
+    }
+    return Buffer::Create(entry->data, entry->size, new Entry(entry), ReleaseEntry);
+}
+
+ClasspathFileSystem::Entry ClasspathFileSystem::cached(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(path);
+    if (found == index_.end()) {
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, found->second);
+    return found->second->second;
+}
+
+ClasspathFileSystem::Entry ClasspathFileSystem::load(const String &file_path) {
+    JNIEnv *env = JniRegistry::attach();
+    if (!env) {
+        return nullptr;
+    }
+
+    String16 utf16 = file_path.utf16();
+    jstring javaPath = env->NewString(utf16.udata(), static_cast<jsize>(utf16.length()));
+    auto bytes = javaPath ? static_cast<jbyteArray>(env->CallStaticObjectMethod(
+        JniRegistry::uefClasspathResourcesClass_, JniRegistry::classpathRead_, mount_, javaPath)) : nullptr;
+    if (env->ExceptionCheck()) {
+        // A throwing loader reads as a missing file to the engine.
+        env->ExceptionClear();
+        bytes = nullptr;
+    }
+    if (javaPath) {
+        env->DeleteLocalRef(javaPath);
+    }
+    if (!bytes) {
+        return nullptr;
+    }
+
+    auto length = static_cast<size_t>(env->GetArrayLength(bytes));
+    auto entry = std::make_shared<HeapBlob>(length);
+    if (!entry->data) {
+        env->DeleteLocalRef(bytes);
+        return nullptr;
+    }
+    env->GetByteArrayRegion(bytes, 0, static_cast<jsize>(length), static_cast<jbyte *>(entry->data));
+    env->DeleteLocalRef(bytes);
+    return entry;
+}
+
+void ClasspathFileSystem::insert(const std::string &path, const Entry &entry) {
+    // Larger than the whole budget: served this once, read again next time.
+    if (entry->size > maxCachedBytes_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(path);
+    if (found != index_.end()) {
+        cachedBytes_ -= found->second->second->size;
+        totalCachedBytes_.fetch_sub(found->second->second->size, std::memory_order_relaxed);
+        found->second->second = entry;
+        lru_.splice(lru_.begin(), lru_, found->second);
+    } else {
+        lru_.emplace_front(path, entry);
+        index_.emplace(path, lru_.begin());
+        cachedEntries_.fetch_add(1, std::memory_order_relaxed);
+    }
+    cachedBytes_ += entry->size;
+    totalCachedBytes_.fetch_add(entry->size, std::memory_order_relaxed);
+
+    while (cachedBytes_ > maxCachedBytes_ && !lru_.empty()) {
+        const auto &oldest = lru_.back();
+        cachedBytes_ -= oldest.second->size;
+        totalCachedBytes_.fetch_sub(oldest.second->size, std::memory_order_relaxed);
+        cachedEntries_.fetch_sub(1, std::memory_order_relaxed);
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+        index_.erase(oldest.first);
+        lru_.pop_back();
+    }
+}
+
+ClasspathStats ClasspathFileSystem::stats() {
+    ClasspathStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.notFound = notFound_.load(std::memory_order_relaxed);
+    stats.loadedBytes = loadedBytes_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.cachedEntries = cachedEntries_.load(std::memory_order_relaxed);
+    stats.cachedBytes = totalCachedBytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+static std::string ConvertJavaStringToUtf8(JNIEnv *env, jobjectArray array, jsize index) {
+    auto element = static_cast<jstring>(env->GetObjectArrayElement(array, index));
+    String string = ConvertJavaStringToCpp(env, element);
+    std::string result(string.utf8().data(), string.utf8().length());
+    env->DeleteLocalRef(element);
+    return result;
+}
+
+void Java_net_rk4z_juef_UefPlatform_mountClasspath(JNIEnv *env, jclass obj, jint mount, jobjectArray names,
+                                                   jobjectArray mimes, jobjectArray charsets, jlong maxCachedBytes) {
+    if (UefRenderer::renderer_ && !UefFileSystem::installed()) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "The first file system must be mounted before the Renderer is created");
+        return;
+    }
+
+    auto layer = std::make_shared<ClasspathFileSystem>(mount, static_cast<size_t>(maxCachedBytes > 0 ? maxCachedBytes : 0));
+    jsize count = env->GetArrayLength(names);
+    for (jsize i = 0; i < count; i++) {
+        layer->add(ConvertJavaStringToUtf8(env, names, i), ConvertJavaStringToUtf8(env, mimes, i),
+                   ConvertJavaStringToUtf8(env, charsets, i));
+    }
+    UefFileSystem::mount(std::move(layer));
+}
+
+void Java_net_rk4z_juef_UefPlatform_getClasspathStats(JNIEnv *env, jclass obj, jlongArray stats) {
+    ClasspathStats current = ClasspathFileSystem::stats();
+    jlong values[UEF_CLASSPATH_STATS_LENGTH] = {
+        static_cast<jlong>(current.hits), static_cast<jlong>(current.misses),
+        static_cast<jlong>(current.notFound), static_cast<jlong>(current.loadedBytes),
+        static_cast<jlong>(current.evictions), static_cast<jlong>(current.cachedEntries),
+        static_cast<jlong>(current.cachedBytes),
+    };
+    env->SetLongArrayRegion(stats, 0, UEF_CLASSPATH_STATS_LENGTH, values);
+}
@@ -0,0 +1,100 @@
+#ifndef CLASSPATHFILESYSTEM_HPP
+#define CLASSPATHFILESYSTEM_HPP
+
+#include "NativeMemory.hpp"
+
+#include <jni.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Ultralight/platform/FileSystem.h>
+
+using namespace ultralight;
+
+#define UEF_CLASSPATH_STATS_LENGTH 7
+
+struct ClasspathStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t notFound = 0;
+    uint64_t loadedBytes = 0;
+    uint64_t evictions = 0;
+    uint64_t cachedEntries = 0;
+    uint64_t cachedBytes = 0;
+};
+
+/**
+ * A mount layer serving the resources below one classpath directory, listed once by
+ * net.rk4z.juef.UefClasspathResources when it is mounted. FileExists, mime types and charsets come
+ * from that listing without touching Java.
+ *
+ * The first OpenFile of a path reads it through the class loader (one JNI upcall, attaching the engine
+ * thread if it has to) into native memory kept in a byte-bounded LRU; later opens hand out Buffers
+ * pointing into that copy. Each Buffer holds a reference to its entry, so eviction never frees
+ * memory the engine is still reading.
+ */
+class ClasspathFileSystem : public FileSystem {
+public:
+    ClasspathFileSystem(jint mount, size_t maxCachedBytes);
+
+    // Adds one listed resource, before the layer is mounted.
+    void add(std::string path, const std::string &mime, const std::string &charset);
+
+    bool FileExists(const String &file_path) override;
+    String GetFileMimeType(const String &file_path) override;
+    String GetFileCharset(const String &file_path) override;
+    RefPtr<Buffer> OpenFile(const String &file_path) override;
+
+    // Summed over every classpath mount.
+    static ClasspathStats stats();
+
+private:
+    struct Type {
+        String mime;
+        String charset;
+    };
+
+    using Entry = std::shared_ptr<HeapBlob>;
+    using Lru = std::list<std::pair<std::string, Entry>>;
+
+    static std::string key(const String &file_path);
+    const Type *find(const String &file_path) const;
+
+    Entry cached(const std::string &path);
+    Entry load(const String &file_path);
+    void insert(const std::string &path, const Entry &entry);
+
+    jint mount_;
+    size_t maxCachedBytes_;
+    // Written only before mounting, read-only afterwards.
+    std::unordered_map<std::string, uint16_t> files_;
+    std::vector<Type> types_;
+
+    std::mutex mutex_;
+    Lru lru_;
+    std::unordered_map<std::string, Lru::iterator> index_;
+    size_t cachedBytes_ = 0;
+
+    static std::atomic<uint64_t> hits_;
+    static std::atomic<uint64_t> misses_;
+    static std::atomic<uint64_t> notFound_;
+    static std::atomic<uint64_t> loadedBytes_;
+    static std::atomic<uint64_t> evictions_;
+    static std::atomic<uint64_t> cachedEntries_;
+    static std::atomic<uint64_t> totalCachedBytes_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_mountClasspath(JNIEnv *env, jclass obj, jint mount,
+        jobjectArray names, jobjectArray mimes, jobjectArray charsets, jlong maxCachedBytes);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_getClasspathStats(JNIEnv *env, jclass obj, jlongArray stats);
+}
+
+#endif //CLASSPATHFILESYSTEM_HPP
@@ -0,0 +1,263 @@
+#include "DeltaEncoder.hpp"
+#include "JniRegistry.hpp"
+#include "SurfaceFactory.hpp"
+#include "UefView.hpp"
+#include "ViewRegistry.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UEF_DELTA_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define UEF_DELTA_NEON 1
+#endif
+
+static inline bool BlockEqual(const uint8_t *a, const uint8_t *b) {
+#if defined(UEF_DELTA_SSE2)
+    __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(left, right)) == 0xFFFF;
+#elif defined(UEF_DELTA_NEON)
+    return vminvq_u8(vceqq_u8(vld1q_u8(a), vld1q_u8(b))) == 0xFF;
+#else
+    return memcmp(a, b, 16) == 0;
+#endif
+}
+
+static inline void WriteLittleEndian16(uint8_t *out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+static inline void WriteLittleEndian32(uint8_t *out, uint32_t value) {
+    WriteLittleEndian16(out, value);
+    WriteLittleEndian16(out + 2, value >> 16);
+}
+
+// XORs current with previous (or zero) and run-length encodes the result; see the class comment.
+static size_t EncodeXorRle(const uint8_t *current, const uint8_t *previous, size_t length, uint8_t *out) {
+    uint8_t *start = out;
+    size_t literalStart = 0;
+    size_t literalLength = 0;
+
+    auto flushLiteral = [&] {
+        while (literalLength) {
+            size_t chunk = std::min<size_t>(literalLength, 128);
+            *out++ = static_cast<uint8_t>(chunk - 1);
+            for (size_t i = 0; i < chunk; i++) {
+                *out++ = static_cast<uint8_t>(current[literalStart + i] ^ (previous ? previous[literalStart + i] : 0));
+            }
+            literalStart += chunk;
+            literalLength -= chunk;
+        }
+    };
+
+    size_t i = 0;
+    while (i < length) {
+        size_t zeros = 0;
+        while (i + zeros < length && current[i + zeros] == (previous ? previous[i + zeros] : 0)) {
+            zeros++;
+        }
+
+        if (zeros >= 2) {
+            flushLiteral();
+            i += zeros;
+            literalStart = i;
+            while (zeros >= 2) {
+                size_t chunk = std::min<size_t>(zeros, 129);
+                *out++ = static_cast<uint8_t>(chunk + 0x7E);
+                zeros -= chunk;
+            }
+            // A single zero left over joins the next literal.
+            if (zeros) {
+                literalStart = i - 1;
+                literalLength = 1;
+            }
+        } else {
+            if (literalLength == 0) {
+                literalStart = i;
+            }
+            literalLength++;
+            i++;
+        }
+    }
+    flushLiteral();
+    return static_cast<size_t>(out - start);
+}
+
+void DeltaEncoder::resize(uint32_t width, uint32_t height) {
+    width_ = width;
+    height_ = height;
+    previous_.assign(static_cast<size_t>(width) * height * 4, 0);
+
+    // Worst case: every other block changed on every row, all of it incompressible. Sizing for it once
+    // keeps the packet storage (and the ByteBuffer Java holds on it) stable while the size is.
+    size_t blocks = (width + 3) / 4;
+    size_t spansPerRow = (blocks + 1) / 2;
+    size_t rowBytes = static_cast<size_t>(width) * 4;
+    size_t rowPayload = rowBytes + rowBytes / 128 + spansPerRow + 1;
+    packet_.resize(kHeaderSize + height * (spansPerRow * kSpanHeaderSize + rowPayload));
+}
+
+void DeltaEncoder::writeSpan(const uint8_t *row, uint32_t y, uint32_t firstPixel, uint32_t pixelCount, bool againstZero) {
+    uint8_t *header = packet_.data() + packetSize_;
+    uint8_t *reference = previous_.data() + (static_cast<size_t>(y) * width_ + firstPixel) * 4;
+    size_t length = static_cast<size_t>(pixelCount) * 4;
+
+    size_t payload = EncodeXorRle(row + static_cast<size_t>(firstPixel) * 4, againstZero ? nullptr : reference, length,
+                                  header + kSpanHeaderSize);
+    WriteLittleEndian16(header, firstPixel);
+    WriteLittleEndian16(header + 2, y);
+    WriteLittleEndian16(header + 4, pixelCount);
+    WriteLittleEndian32(header + 6, static_cast<uint32_t>(payload));
+
+    memcpy(reference, row + static_cast<size_t>(firstPixel) * 4, length);
+    packetSize_ += kSpanHeaderSize + payload;
+    spanCount_++;
+}
+
+bool DeltaEncoder::encode(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes, const IntRect &dirty) {
+    if (width != width_ || height != height_) {
+        resize(width, height);
+        keyframeRequested_ = true;
+    }
+    if (width == 0 || height == 0) {
+        return false;
+    }
+
+    keyframe_ = keyframeRequested_ || (keyframeInterval_ && sinceKeyframe_ + 1 >= keyframeInterval_);
+    packetSize_ = kHeaderSize;
+    spanCount_ = 0;
+
+    if (keyframe_) {
+        for (uint32_t y = 0; y < height; y++) {
+            writeSpan(pixels + y * rowBytes, y, 0, width, true);
+        }
+    } else {
+        int left = std::max(dirty.left, 0);
+        int top = std::max(dirty.top, 0);
+        int right = std::min(dirty.right, static_cast<int>(width));
+        int bottom = std::min(dirty.bottom, static_cast<int>(height));
+
+        uint32_t firstBlock = right > left ? static_cast<uint32_t>(left) / 4 : 0;
+        uint32_t lastBlock = right > left ? (static_cast<uint32_t>(right) + 3) / 4 : 0;
+        uint32_t fullBlocks = width / 4;
+
+        for (int y = top; y < bottom && right > left; y++) {
+            const uint8_t *row = pixels + static_cast<size_t>(y) * rowBytes;
+            const uint8_t *reference = previous_.data() + static_cast<size_t>(y) * width * 4;
+
+            uint32_t spanStart = 0;
+            uint32_t spanEnd = 0;
+            bool open = false;
+            for (uint32_t block = firstBlock; block < lastBlock; block++) {
+                size_t offset = static_cast<size_t>(block) * 16;
+                bool changed = block < fullBlocks
+                    ? !BlockEqual(row + offset, reference + offset)
+                    : memcmp(row + offset, reference + offset, static_cast<size_t>(width % 4) * 4) != 0;
+                if (!changed) {
+                    continue;
+                }
+
+                if (open && block - spanEnd <= kMergeGap) {
+                    spanEnd = block + 1;
+                    continue;
+                }
+                if (open) {
+                    writeSpan(row, static_cast<uint32_t>(y), spanStart * 4, (spanEnd - spanStart) * 4, false);
+                }
+                spanStart = block;
+                spanEnd = block + 1;
+                open = true;
+            }
+            if (open) {
+                uint32_t pixelEnd = std::min(spanEnd * 4, width);
+                writeSpan(row, static_cast<uint32_t>(y), spanStart * 4, pixelEnd - spanStart * 4, false);
+            }
+        }
+
+        if (spanCount_ == 0) {
+            return false;
+        }
+    }
+
+    frame_++;
+    sinceKeyframe_ = keyframe_ ? 0 : sinceKeyframe_ + 1;
+    keyframeRequested_ = false;
+
+    uint8_t *header = packet_.data();
+    memcpy(header, "UEFD", 4);
+    header[4] = 1;
+    header[5] = keyframe_ ? 1 : 0;
+    WriteLittleEndian16(header + 6, 0);
+    WriteLittleEndian32(header + 8, frame_);
+    WriteLittleEndian32(header + 12, width);
+    WriteLittleEndian32(header + 16, height);
+    WriteLittleEndian32(header + 20, spanCount_);
+    return true;
+}
+
+static DeltaEncoder *LookupDeltaEncoder(JNIEnv *env, jlong handle) {
+    if (!UefView::lookup(env, handle)) {
+        return nullptr;
+    }
+
+    ViewSlot *slot = ViewRegistry::slot(handle);
+    if (!slot->delta) {
+        slot->delta = std::make_unique<DeltaEncoder>();
+    }
+    return slot->delta.get();
+}
+
+jobject Java_net_rk4z_juef_UefView_encodeDelta(JNIEnv *env, jclass obj, jlong handle, jlongArray info) {
+    Surface *surface = UefView::lookupSurface(env, handle);
+    if (!surface) {
+        return nullptr;
+    }
+    if (UefSurfaceFactory::asTripleBuffered(surface)) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "Triple-buffered surfaces are read through UefView#openFrameReader()");
+        return nullptr;
+    }
+
+    ViewSlot *slot = ViewRegistry::slot(handle);
+    if (slot->surfaceLocked) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "UefView surface is locked");
+        return nullptr;
+    }
+    DeltaEncoder *encoder = LookupDeltaEncoder(env, handle);
+
+    auto pixels = static_cast<const uint8_t *>(surface->LockPixels());
+    UefView::collectDamage(slot, surface);
+    IntRect dirty = slot->deltaDamage;
+    slot->deltaDamage.SetEmpty();
+    bool produced = encoder->encode(pixels, surface->width(), surface->height(), surface->row_bytes(), dirty);
+    surface->UnlockPixels();
+
+    jlong values[UEF_DELTA_INFO_LENGTH] = {
+        produced ? static_cast<jlong>(encoder->packetSize()) : 0, encoder->frame(),
+        encoder->keyframe() ? 1 : 0, encoder->spanCount(),
+    };
+    env->SetLongArrayRegion(info, 0, UEF_DELTA_INFO_LENGTH, values);
+
+    // Java keeps the previous buffer; only wrap the packet storage again when it moved.
+    if (encoder->packet() == slot->deltaPacket) {
+        return nullptr;
+    }
+    slot->deltaPacket = encoder->packet();
+    return env->NewDirectByteBuffer(const_cast<uint8_t *>(encoder->packet()), static_cast<jlong>(encoder->packetCapacity()));
+}
+
+void Java_net_rk4z_juef_UefView_setKeyframeInterval(JNIEnv *env, jclass obj, jlong handle, jint frames) {
+    if (DeltaEncoder *encoder = LookupDeltaEncoder(env, handle)) {
+        encoder->setKeyframeInterval(frames > 0 ? static_cast<uint32_t>(frames) : 0);
+    }
+}
+
+void Java_net_rk4z_juef_UefView_requestKeyframe(JNIEnv *env, jclass obj, jlong handle) {
+    if (DeltaEncoder *encoder = LookupDeltaEncoder(env, handle)) {
+        encoder->requestKeyframe();
+    }
+}
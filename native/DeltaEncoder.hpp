@@ -0,0 +1,76 @@
+#ifndef DELTAENCODER_HPP
+#define DELTAENCODER_HPP
+
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <Ultralight/Geometry.h>
+
+#define UEF_DELTA_INFO_LENGTH 4
+
+using namespace ultralight;
+
+/**
+ * Turns successive frames of one surface into compact delta packets for remote mirrors.
+ *
+ * Only the area damaged since the last encode (see UefView::collectDamage) is compared against the
+ * previous frame, 16 bytes (4 pixels) at a time. Changed blocks on a row are grouped into spans (gaps of up to kMergeGap unchanged blocks
+ * are absorbed, a few zero bytes being cheaper than a span header), and each span carries the XOR
+ * of new and old pixels, run-length encoded. Frames whose dirty area turns out byte-identical
+ * produce no packet at all.
+ *
+ * Packet layout, little-endian:
+ *   header  "UEFD", u8 version (1), u8 flags (bit 0: keyframe), u16 0, u32 frame, u32 width,
+ *           u32 height, u32 spanCount
+ *   span    u16 x, u16 y, u16 pixelCount, u32 payloadLength, payload
+ *   payload control byte c, then: c < 0x80: c + 1 literal bytes follow; c >= 0x80: c - 0x7E zero bytes
+ * Applying a span XORs the decoded payload into row y from pixel x on. A keyframe covers the whole
+ * frame and is applied to a zeroed buffer.
+ */
+class DeltaEncoder {
+public:
+    static constexpr uint32_t kMergeGap = 2;
+    static constexpr size_t kHeaderSize = 24;
+    static constexpr size_t kSpanHeaderSize = 10;
+
+    void setKeyframeInterval(uint32_t frames) { keyframeInterval_ = frames; }
+    void requestKeyframe() { keyframeRequested_ = true; }
+
+    // Encodes the next frame into packet(); returns false when nothing changed and no packet was made.
+    bool encode(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes, const IntRect &dirty);
+
+    const uint8_t *packet() const { return packet_.data(); }
+    size_t packetSize() const { return packetSize_; }
+    size_t packetCapacity() const { return packet_.size(); }
+    uint32_t frame() const { return frame_; }
+    bool keyframe() const { return keyframe_; }
+    uint32_t spanCount() const { return spanCount_; }
+
+private:
+    void resize(uint32_t width, uint32_t height);
+    void writeSpan(const uint8_t *row, uint32_t y, uint32_t firstPixel, uint32_t pixelCount, bool againstZero);
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    std::vector<uint8_t> previous_;
+    std::vector<uint8_t> packet_;
+    size_t packetSize_ = 0;
+
+    uint32_t frame_ = 0;
+    uint32_t keyframeInterval_ = 300;
+    uint32_t sinceKeyframe_ = 0;
+    bool keyframeRequested_ = true;
+    bool keyframe_ = false;
+    uint32_t spanCount_ = 0;
+};
+
+extern "C" {
+    JNIEXPORT jobject JNICALL Java_net_rk4z_juef_UefView_encodeDelta(JNIEnv *env, jclass obj, jlong handle, jlongArray info);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_setKeyframeInterval(JNIEnv *env, jclass obj, jlong handle, jint frames);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_requestKeyframe(JNIEnv *env, jclass obj, jlong handle);
+}
+
+#endif //DELTAENCODER_HPP
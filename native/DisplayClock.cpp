@@ -0,0 +1,237 @@
+#include "DisplayClock.hpp"
+#include "ResizeCoalescer.hpp"
+#include "UefRenderer.hpp"
+#include "ViewRegistry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#ifdef _WIN32
+#include <thread>
+#else
+#include <cerrno>
+#include <ctime>
+#endif
+
+std::vector<DisplayTimer> DisplayClock::displays_;
+std::mutex DisplayClock::wakeMutex_;
+std::condition_variable DisplayClock::wakeChanged_;
+std::vector<uint32_t> DisplayClock::woken_;
+
+static uint64_t PeriodNanos(double hz) {
+    return hz > 0 ? static_cast<uint64_t>(1000000000.0 / hz) : 0;
+}
+
+uint64_t DisplayClock::now() {
+#ifdef _WIN32
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000ull + static_cast<uint64_t>(time.tv_nsec);
+#endif
+}
+
+void DisplayClock::sleepUntil(uint64_t deadline, bool interruptible) {
+    if (interruptible) {
+        // steady_clock is the CLOCK_MONOTONIC now() reads, so the deadline carries over unchanged.
+        std::chrono::steady_clock::time_point until{std::chrono::nanoseconds(deadline)};
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeChanged_.wait_until(lock, until, [] { return !woken_.empty(); });
+        return;
+    }
+
+#ifdef _WIN32
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline)));
+#else
+    timespec time{};
+    time.tv_sec = static_cast<time_t>(deadline / 1000000000ull);
+    time.tv_nsec = static_cast<long>(deadline % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, nullptr) == EINTR) {
+    }
+#endif
+}
+
+void DisplayClock::configure(uint32_t displayId, double hz, double idleHz) {
+    auto found = std::find_if(displays_.begin(), displays_.end(), [displayId](const DisplayTimer &timer) {
+        return timer.displayId == displayId;
+    });
+
+    if (hz <= 0) {
+        if (found != displays_.end()) {
+            displays_.erase(found);
+        }
+        return;
+    }
+
+    if (found == displays_.end()) {
+        found = displays_.emplace(displays_.end());
+        found->displayId = displayId;
+        found->next = now();
+    }
+    found->periodNanos = PeriodNanos(hz);
+    found->idlePeriodNanos = idleHz > 0 && idleHz < hz ? PeriodNanos(idleHz) : 0;
+    found->idle = false;
+    found->quietTicks = 0;
+}
+
+void DisplayClock::wake(uint32_t displayId) {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        if (std::find(woken_.begin(), woken_.end(), displayId) != woken_.end()) {
+            return;
+        }
+        woken_.push_back(displayId);
+    }
+    wakeChanged_.notify_all();
+}
+
+void DisplayClock::applyWakes(uint64_t current) {
+    std::vector<uint32_t> woken;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        if (woken_.empty()) {
+            return;
+        }
+        woken.swap(woken_);
+    }
+
+    for (DisplayTimer &timer : displays_) {
+        if (std::find(woken.begin(), woken.end(), timer.displayId) == woken.end()) {
+            continue;
+        }
+        timer.quietTicks = 0;
+        if (timer.idle) {
+            timer.idle = false;
+            timer.next = std::min(timer.next, current);
+        }
+    }
+}
+
+uint64_t DisplayClock::earliestDeadline() {
+    uint64_t earliest = displays_.front().next;
+    for (const DisplayTimer &timer : displays_) {
+        earliest = std::min(earliest, timer.next);
+    }
+    return earliest;
+}
+
+const DisplayTimer *DisplayClock::find(uint32_t displayId) {
+    for (const DisplayTimer &timer : displays_) {
+        if (timer.displayId == displayId) {
+            return &timer;
+        }
+    }
+    return nullptr;
+}
+
+bool DisplayClock::hasPendingPaint(uint32_t displayId) {
+    bool pending = false;
+    ViewRegistry::forEach([displayId, &pending](jlong handle, ViewSlot &slot) {
+        pending = pending || (slot.view->display_id() == displayId && slot.view->needs_paint());
+    });
+    return pending;
+}
+
+int DisplayClock::pump(uint64_t maxWaitNanos) {
+    if (displays_.empty()) {
+        return 0;
+    }
+
+    uint64_t current = now();
+    applyWakes(current);
+    uint64_t earliest = earliestDeadline();
+    if (earliest > current) {
+        // Only an idle display can be late for input; the others tick within a period anyway.
+        bool anyIdle = std::any_of(displays_.begin(), displays_.end(), [](const DisplayTimer &timer) {
+            return timer.idle;
+        });
+        sleepUntil(std::min(earliest, current + maxWaitNanos), anyIdle);
+        current = now();
+        applyWakes(current);
+        if (earliestDeadline() > current) {
+            return 0;
+        }
+    }
+
+    ViewRegistry::drainReleases();
+
+    int refreshed = 0;
+    for (DisplayTimer &timer : displays_) {
+        if (timer.next > current) {
+            continue;
+        }
+
+        UefRenderer::renderer_->RefreshDisplay(timer.displayId);
+        refreshed++;
+
+        uint64_t lateness = current - timer.next;
+        timer.maxLatenessNanos = std::max(timer.maxLatenessNanos, lateness);
+        timer.totalLatenessNanos += lateness;
+        timer.lastIntervalNanos = timer.last ? current - timer.last : 0;
+        timer.last = current;
+        timer.ticks++;
+
+        uint64_t period = timer.idle ? timer.idlePeriodNanos : timer.periodNanos;
+        timer.next += period;
+        if (timer.next <= current) {
+            uint64_t skipped = (current - timer.next) / period + 1;
+            timer.missed += skipped;
+            timer.next += skipped * period;
+        }
+    }
+
+    if (refreshed == 0) {
+        return 0;
+    }
+    ResizeCoalescer::apply();
+    UefRenderer::renderer_->Update();
+
+    // Animations and timers show up as Views needing paint once Update() has run.
+    for (DisplayTimer &timer : displays_) {
+        if (!timer.idlePeriodNanos || timer.last != current) {
+            continue;
+        }
+
+        if (hasPendingPaint(timer.displayId)) {
+            if (timer.idle) {
+                timer.idle = false;
+                timer.next = std::min(timer.next, current + timer.periodNanos);
+            }
+            timer.quietTicks = 0;
+        } else if (!timer.idle && ++timer.quietTicks >= kIdleAfterTicks) {
+            timer.idle = true;
+            timer.next = current + timer.idlePeriodNanos;
+        }
+    }
+    return refreshed;
+}
+
+void Java_net_rk4z_juef_UefRenderer_setDisplayClock(JNIEnv *env, jclass obj, jint displayId, jdouble hz, jdouble idleHz) {
+    DisplayClock::configure(static_cast<uint32_t>(displayId), hz, idleHz);
+}
+
+jint Java_net_rk4z_juef_UefRenderer_pumpDisplays(JNIEnv *env, jclass obj, jlong maxWaitNanos) {
+    return DisplayClock::pump(maxWaitNanos > 0 ? static_cast<uint64_t>(maxWaitNanos) : 0);
+}
+
+void Java_net_rk4z_juef_UefRenderer_wakeDisplay(JNIEnv *env, jclass obj, jint displayId) {
+    DisplayClock::wake(static_cast<uint32_t>(displayId));
+}
+
+jboolean Java_net_rk4z_juef_UefRenderer_getDisplayStats(JNIEnv *env, jclass obj, jint displayId, jlongArray stats) {
+    const DisplayTimer *timer = DisplayClock::find(static_cast<uint32_t>(displayId));
+    if (!timer) {
+        return JNI_FALSE;
+    }
+
+    jlong values[UEF_DISPLAY_STATS_LENGTH] = {
+        static_cast<jlong>(timer->ticks), static_cast<jlong>(timer->missed),
+        static_cast<jlong>(timer->lastIntervalNanos), static_cast<jlong>(timer->maxLatenessNanos),
+        static_cast<jlong>(timer->totalLatenessNanos),
+        static_cast<jlong>(timer->idle ? timer->idlePeriodNanos : timer->periodNanos),
+        timer->idle ? 1 : 0, static_cast<jlong>(timer->quietTicks),
+    };
+    env->SetLongArrayRegion(stats, 0, UEF_DISPLAY_STATS_LENGTH, values);
+    return JNI_TRUE;
+}
@@ -0,0 +1,78 @@
+#ifndef DISPLAYCLOCK_HPP
+#define DISPLAYCLOCK_HPP
+
+#include <jni.h>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#define UEF_DISPLAY_STATS_LENGTH 8
+
+struct DisplayTimer {
+    uint32_t displayId = 0;
+    uint64_t periodNanos = 0;
+    uint64_t idlePeriodNanos = 0;
+    uint64_t next = 0;
+    uint64_t last = 0;
+    uint32_t quietTicks = 0;
+    bool idle = false;
+
+    uint64_t ticks = 0;
+    uint64_t missed = 0;
+    uint64_t lastIntervalNanos = 0;
+    uint64_t maxLatenessNanos = 0;
+    uint64_t totalLatenessNanos = 0;
+};
+
+/**
+ * Per-display refresh clock run on the renderer thread. The engine is not thread-safe, so rather
+ * than owning threads of its own the clock is pumped by the renderer loop: pump() sleeps until the
+ * earliest display deadline, calls RefreshDisplay for every display that is due and Update() once,
+ * and returns. Deadlines are absolute and advance by whole periods, so a late wake-up (a GC pause
+ * in the caller, say) does not shift the following frames; periods that were missed entirely are
+ * skipped and counted.
+ *
+ * A display whose Views have not needed painting for kIdleAfterTicks ticks drops to its idle rate
+ * until one of them does again, or until wake() reports input or an invalidation for it. wake() may
+ * be called from any thread: while a display is idle, pump() sleeps on a condition variable instead
+ * of clock_nanosleep, so a wake cuts the idle period short and the display is refreshed right away.
+ */
+class DisplayClock {
+public:
+    static constexpr uint32_t kIdleAfterTicks = 30;
+
+    // hz <= 0 removes the display; idleHz <= 0 disables throttling for it.
+    static void configure(uint32_t displayId, double hz, double idleHz);
+    static int pump(uint64_t maxWaitNanos);
+    static const DisplayTimer *find(uint32_t displayId);
+    // Brings an idle display back to its full rate on the next pump(); any thread.
+    static void wake(uint32_t displayId);
+
+private:
+    static uint64_t now();
+    static void sleepUntil(uint64_t deadline, bool interruptible);
+    static void applyWakes(uint64_t current);
+    static uint64_t earliestDeadline();
+    static bool hasPendingPaint(uint32_t displayId);
+
+    // Renderer thread only.
+    static std::vector<DisplayTimer> displays_;
+
+    // Displays woken since the last pump(), guarded by wakeMutex_.
+    static std::mutex wakeMutex_;
+    static std::condition_variable wakeChanged_;
+    static std::vector<uint32_t> woken_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_setDisplayClock(JNIEnv *env, jclass obj, jint displayId, jdouble hz, jdouble idleHz);
+
+    JNIEXPORT jint JNICALL Java_net_rk4z_juef_UefRenderer_pumpDisplays(JNIEnv *env, jclass obj, jlong maxWaitNanos);
+
+    JNIEXPORT jboolean JNICALL Java_net_rk4z_juef_UefRenderer_getDisplayStats(JNIEnv *env, jclass obj, jint displayId, jlongArray stats);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_wakeDisplay(JNIEnv *env, jclass obj, jint displayId);
+}
+
+#endif //DISPLAYCLOCK_HPP
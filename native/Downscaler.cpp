@@ -0,0 +1,364 @@
+#include "Downscaler.hpp"
+#include "EnumMapping.hpp"
+#include "JniRegistry.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UEF_SCALE_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define UEF_SCALE_NEON 1
+#endif
+
+// Output rows per parallelFor index.
+static constexpr uint32_t kBandRows = 32;
+
+// One BGRA pixel as four floats.
+#if defined(UEF_SCALE_SSE2)
+using Pixel = __m128;
+
+static inline Pixel LoadPixel(const uint8_t *source) {
+    int32_t bytes;
+    memcpy(&bytes, source, 4);
+    __m128i zero = _mm_setzero_si128();
+    __m128i wide = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+    return _mm_cvtepi32_ps(wide);
+}
+
+static inline Pixel LoadPixel(const float *source) { return _mm_loadu_ps(source); }
+static inline void StorePixel(float *destination, Pixel pixel) { _mm_storeu_ps(destination, pixel); }
+static inline Pixel ZeroPixel() { return _mm_setzero_ps(); }
+static inline Pixel MultiplyAdd(Pixel sum, Pixel pixel, float weight) { return _mm_add_ps(sum, _mm_mul_ps(pixel, _mm_set1_ps(weight))); }
+
+static inline void StorePixel(uint8_t *destination, Pixel pixel) {
+    Pixel alpha = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+    pixel = _mm_max_ps(_mm_min_ps(pixel, _mm_min_ps(alpha, _mm_set1_ps(255.0f))), _mm_setzero_ps());
+    __m128i packed = _mm_cvtps_epi32(pixel);
+    packed = _mm_packs_epi32(packed, packed);
+    packed = _mm_packus_epi16(packed, packed);
+    int32_t bytes = _mm_cvtsi128_si32(packed);
+    memcpy(destination, &bytes, 4);
+}
+#elif defined(UEF_SCALE_NEON)
+using Pixel = float32x4_t;
+
+static inline Pixel LoadPixel(const uint8_t *source) {
+    uint32_t bytes;
+    memcpy(&bytes, source, 4);
+    uint16x8_t wide = vmovl_u8(vcreate_u8(bytes));
+    return vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide)));
+}
+
+static inline Pixel LoadPixel(const float *source) { return vld1q_f32(source); }
+static inline void StorePixel(float *destination, Pixel pixel) { vst1q_f32(destination, pixel); }
+static inline Pixel ZeroPixel() { return vdupq_n_f32(0.0f); }
+static inline Pixel MultiplyAdd(Pixel sum, Pixel pixel, float weight) { return vmlaq_n_f32(sum, pixel, weight); }
+
+static inline void StorePixel(uint8_t *destination, Pixel pixel) {
+    Pixel alpha = vdupq_laneq_f32(pixel, 3);
+    pixel = vmaxq_f32(vminq_f32(pixel, vminq_f32(alpha, vdupq_n_f32(255.0f))), vdupq_n_f32(0.0f));
+    uint16x4_t narrow = vmovn_u32(vcvtnq_u32_f32(pixel));
+    uint8x8_t bytes = vmovn_u16(vcombine_u16(narrow, narrow));
+    vst1_lane_u32(reinterpret_cast<uint32_t *>(destination), vreinterpret_u32_u8(bytes), 0);
+}
+#else
+struct Pixel {
+    float channels[4];
+};
+
+static inline Pixel LoadPixel(const uint8_t *source) { return Pixel{{float(source[0]), float(source[1]), float(source[2]), float(source[3])}}; }
+static inline Pixel LoadPixel(const float *source) { return Pixel{{source[0], source[1], source[2], source[3]}}; }
+static inline void StorePixel(float *destination, Pixel pixel) { memcpy(destination, pixel.channels, sizeof(pixel.channels)); }
+static inline Pixel ZeroPixel() { return Pixel{}; }
+
+static inline Pixel MultiplyAdd(Pixel sum, Pixel pixel, float weight) {
+    for (int i = 0; i < 4; i++) {
+        sum.channels[i] += pixel.channels[i] * weight;
+    }
+    return sum;
+}
+
+static inline void StorePixel(uint8_t *destination, Pixel pixel) {
+    float alpha = std::min(std::max(pixel.channels[3], 0.0f), 255.0f);
+    for (int i = 0; i < 4; i++) {
+        float value = std::min(std::max(pixel.channels[i], 0.0f), alpha);
+        destination[i] = static_cast<uint8_t>(std::lrintf(value));
+    }
+}
+#endif
+
+// Input taps of every output coordinate along one axis. Weights sum to 1.
+struct Taps {
+    std::vector<uint32_t> first;
+    std::vector<uint32_t> count;
+    std::vector<float> weights;
+    uint32_t stride = 0;
+};
+
+static float Lanczos3(float x) {
+    x = std::fabs(x);
+    if (x < 1e-6f) {
+        return 1.0f;
+    }
+    if (x >= 3.0f) {
+        return 0.0f;
+    }
+    const float pi = 3.14159265358979f;
+    return 3.0f * std::sin(pi * x) * std::sin(pi * x / 3.0f) / (pi * pi * x * x);
+}
+
+static Taps BuildTaps(uint32_t in, uint32_t out, ScaleFilter filter) {
+    double scale = static_cast<double>(in) / out;
+    double support = filter == ScaleFilter::Lanczos ? 3.0 * scale : 0.5 * scale;
+
+    Taps taps;
+    taps.stride = static_cast<uint32_t>(std::ceil(support * 2.0)) + 2;
+    taps.first.resize(out);
+    taps.count.resize(out);
+    taps.weights.assign(static_cast<size_t>(out) * taps.stride, 0.0f);
+
+    for (uint32_t i = 0; i < out; i++) {
+        double center = (i + 0.5) * scale;
+        auto first = static_cast<int64_t>(std::floor(center - support));
+        auto last = static_cast<int64_t>(std::ceil(center + support));
+        first = std::max<int64_t>(first, 0);
+        last = std::min<int64_t>(last, in);
+
+        float *weights = taps.weights.data() + static_cast<size_t>(i) * taps.stride;
+        uint32_t count = 0;
+        double total = 0.0;
+        for (int64_t j = first; j < last && count < taps.stride; j++) {
+            double weight;
+            if (filter == ScaleFilter::Lanczos) {
+                weight = Lanczos3(static_cast<float>((j + 0.5 - center) / scale));
+            } else {
+                // Share of the input pixel covered by the output pixel's footprint.
+                weight = std::max(std::min<double>(j + 1, center + support) - std::max<double>(j, center - support), 0.0);
+            }
+            weights[count++] = static_cast<float>(weight);
+            total += weight;
+        }
+
+        // Edge taps outside the image were dropped; renormalize what is left.
+        for (uint32_t k = 0; k < count && total != 0.0; k++) {
+            weights[k] = static_cast<float>(weights[k] / total);
+        }
+        taps.first[i] = static_cast<uint32_t>(first);
+        taps.count[i] = count;
+    }
+    return taps;
+}
+
+static void HalveRows(const uint8_t *source, size_t sourceRowBytes, uint32_t width, uint32_t height,
+                      uint8_t *destination, size_t destinationRowBytes, uint32_t firstRow, uint32_t lastRow) {
+    uint32_t outWidth = std::max(width / 2, 1u);
+    for (uint32_t y = firstRow; y < lastRow; y++) {
+        const uint8_t *top = source + static_cast<size_t>(std::min(2 * y, height - 1)) * sourceRowBytes;
+        const uint8_t *bottom = source + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * sourceRowBytes;
+        uint8_t *out = destination + static_cast<size_t>(y) * destinationRowBytes;
+
+        uint32_t x = 0;
+#if defined(UEF_SCALE_SSE2)
+        // 4 source pixels per row, 2 output pixels per iteration.
+        __m128i zero = _mm_setzero_si128();
+        __m128i two = _mm_set1_epi16(2);
+        for (; 2 * x + 4 <= width; x += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(top + 8 * x));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bottom + 8 * x));
+            __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+            high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+            __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(low, high), two), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(out + 4 * x), _mm_packus_epi16(sum, sum));
+        }
+#endif
+        for (; x < outWidth; x++) {
+            uint32_t left = std::min(2 * x, width - 1) * 4;
+            uint32_t right = std::min(2 * x + 1, width - 1) * 4;
+            for (uint32_t c = 0; c < 4; c++) {
+                out[4 * x + c] = static_cast<uint8_t>((top[left + c] + top[right + c] + bottom[left + c] + bottom[right + c] + 2) >> 2);
+            }
+        }
+    }
+}
+
+void Downscaler::halve(const uint8_t *source, size_t sourceRowBytes, uint32_t width, uint32_t height,
+                       uint8_t *destination, size_t destinationRowBytes) {
+    uint32_t outHeight = std::max(height / 2, 1u);
+    size_t bands = (outHeight + kBandRows - 1) / kBandRows;
+    WorkerPool::shared().parallelFor(bands, [&](size_t band) {
+        auto first = static_cast<uint32_t>(band * kBandRows);
+        HalveRows(source, sourceRowBytes, width, height, destination, destinationRowBytes, first, std::min(first + kBandRows, outHeight));
+    });
+}
+
+void Downscaler::resample(const uint8_t *source, size_t sourceRowBytes, uint32_t sourceWidth, uint32_t sourceHeight,
+                          uint8_t *destination, size_t destinationRowBytes, uint32_t width, uint32_t height, ScaleFilter filter) {
+    Taps horizontal = BuildTaps(sourceWidth, width, filter);
+    Taps vertical = BuildTaps(sourceHeight, height, filter);
+
+    size_t bands = (height + kBandRows - 1) / kBandRows;
+    WorkerPool::shared().parallelFor(bands, [&](size_t band) {
+        auto firstRow = static_cast<uint32_t>(band * kBandRows);
+        uint32_t lastRow = std::min(firstRow + kBandRows, height);
+
+        // Horizontal pass over just the input rows this band's output rows read.
+        uint32_t inFirst = vertical.first[firstRow];
+        uint32_t inLast = vertical.first[lastRow - 1] + vertical.count[lastRow - 1];
+        std::vector<float> rows(static_cast<size_t>(inLast - inFirst) * width * 4);
+        for (uint32_t y = inFirst; y < inLast; y++) {
+            const uint8_t *in = source + static_cast<size_t>(y) * sourceRowBytes;
+            float *out = rows.data() + static_cast<size_t>(y - inFirst) * width * 4;
+            for (uint32_t x = 0; x < width; x++) {
+                const float *weights = horizontal.weights.data() + static_cast<size_t>(x) * horizontal.stride;
+                const uint8_t *tap = in + static_cast<size_t>(horizontal.first[x]) * 4;
+                Pixel sum = ZeroPixel();
+                for (uint32_t k = 0; k < horizontal.count[x]; k++) {
+                    sum = MultiplyAdd(sum, LoadPixel(tap + 4 * k), weights[k]);
+                }
+                StorePixel(out + 4 * x, sum);
+            }
+        }
+
+        // Vertical pass, accumulating whole rows to stay sequential in memory.
+        std::vector<float> sums(static_cast<size_t>(width) * 4);
+        for (uint32_t y = firstRow; y < lastRow; y++) {
+            std::fill(sums.begin(), sums.end(), 0.0f);
+            const float *weights = vertical.weights.data() + static_cast<size_t>(y) * vertical.stride;
+            for (uint32_t k = 0; k < vertical.count[y]; k++) {
+                const float *in = rows.data() + static_cast<size_t>(vertical.first[y] + k - inFirst) * width * 4;
+                for (uint32_t x = 0; x < width; x++) {
+                    StorePixel(sums.data() + 4 * x, MultiplyAdd(LoadPixel(sums.data() + 4 * x), LoadPixel(in + 4 * x), weights[k]));
+                }
+            }
+
+            uint8_t *out = destination + static_cast<size_t>(y) * destinationRowBytes;
+            for (uint32_t x = 0; x < width; x++) {
+                StorePixel(out + 4 * x, LoadPixel(sums.data() + 4 * x));
+            }
+        }
+    });
+}
+
+namespace {
+    struct Level {
+        const uint8_t *pixels;
+        size_t rowBytes;
+        uint32_t width;
+        uint32_t height;
+        std::unique_ptr<HeapBlob> storage;
+    };
+}
+
+std::vector<std::unique_ptr<HeapBlob>> Downscaler::generate(const uint8_t *source, size_t rowBytes, uint32_t width, uint32_t height,
+                                                            const std::vector<ScaleSize> &sizes, ScaleFilter filter) {
+    std::vector<Level> levels;
+    levels.push_back(Level{source, rowBytes, width, height, nullptr});
+
+    // Lanczos resamples from a level at least twice the target, Box from any level at least as large.
+    uint32_t reserve = filter == ScaleFilter::Lanczos ? 2 : 1;
+
+    std::vector<std::unique_ptr<HeapBlob>> results;
+    for (const ScaleSize &size : sizes) {
+        size_t level = 0;
+        for (;;) {
+            const Level &current = levels[level];
+            uint32_t nextWidth = std::max(current.width / 2, 1u);
+            uint32_t nextHeight = std::max(current.height / 2, 1u);
+            bool exact = nextWidth == size.width && nextHeight == size.height && filter == ScaleFilter::Box;
+            bool fits = static_cast<uint64_t>(nextWidth) >= static_cast<uint64_t>(size.width) * reserve
+                && static_cast<uint64_t>(nextHeight) >= static_cast<uint64_t>(size.height) * reserve;
+            if ((!fits && !exact) || (nextWidth == current.width && nextHeight == current.height)) {
+                break;
+            }
+
+            if (level + 1 == levels.size()) {
+                auto storage = std::make_unique<HeapBlob>(static_cast<size_t>(nextWidth) * nextHeight * 4);
+                if (!storage->size) {
+                    return {};
+                }
+                halve(current.pixels, current.rowBytes, current.width, current.height,
+                      static_cast<uint8_t *>(storage->data), static_cast<size_t>(nextWidth) * 4);
+                auto pixels = static_cast<const uint8_t *>(storage->data);
+                levels.push_back(Level{pixels, static_cast<size_t>(nextWidth) * 4, nextWidth, nextHeight, std::move(storage)});
+            }
+            level++;
+        }
+
+        const Level &from = levels[level];
+        auto result = std::make_unique<HeapBlob>(static_cast<size_t>(size.width) * size.height * 4);
+        if (!result->size) {
+            return {};
+        }
+        auto pixels = static_cast<uint8_t *>(result->data);
+        if (from.width == size.width && from.height == size.height) {
+            for (uint32_t y = 0; y < size.height; y++) {
+                memcpy(pixels + static_cast<size_t>(y) * size.width * 4, from.pixels + y * from.rowBytes, static_cast<size_t>(size.width) * 4);
+            }
+        } else {
+            resample(from.pixels, from.rowBytes, from.width, from.height, pixels, static_cast<size_t>(size.width) * 4,
+                     size.width, size.height, filter);
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+jlongArray Java_net_rk4z_juef_UefDownscaler_downscaleImage(JNIEnv *env, jclass obj, jobject pixels, jint rowBytes, jint width, jint height, jintArray sizes, jobject filter) {
+    auto source = pixels ? static_cast<const uint8_t *>(env->GetDirectBufferAddress(pixels)) : nullptr;
+    int64_t needed = height > 0 ? static_cast<int64_t>(height - 1) * rowBytes + static_cast<int64_t>(width) * 4 : 0;
+    if (!source || width <= 0 || height <= 0 || static_cast<int64_t>(width) * 4 > rowBytes
+        || needed > env->GetDirectBufferCapacity(pixels)) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Pixels must be a direct ByteBuffer holding width x height BGRA pixels");
+        return nullptr;
+    }
+
+    if (!sizes) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Sizes must not be null");
+        return nullptr;
+    }
+
+    jsize count = env->GetArrayLength(sizes);
+    std::vector<jint> values(static_cast<size_t>(count));
+    env->GetIntArrayRegion(sizes, 0, count, values.data());
+
+    if (count % 2) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Sizes must be width, height pairs");
+        return nullptr;
+    }
+
+    std::vector<ScaleSize> targets;
+    for (jsize i = 0; i + 1 < count; i += 2) {
+        if (values[i] <= 0 || values[i + 1] <= 0 || values[i] > width || values[i + 1] > height) {
+            env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Sizes must be positive and no larger than the source");
+            return nullptr;
+        }
+        targets.push_back(ScaleSize{static_cast<uint32_t>(values[i]), static_cast<uint32_t>(values[i + 1])});
+    }
+
+    std::vector<std::unique_ptr<HeapBlob>> images = Downscaler::generate(
+        source, static_cast<size_t>(rowBytes), static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+        targets, ConvertJavaEnumToCpp<ScaleFilter>(env, filter));
+    if (images.size() != targets.size()) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "Out of memory while downscaling");
+        return nullptr;
+    }
+
+    auto length = static_cast<jsize>(images.size());
+    jlongArray handles = env->NewLongArray(length);
+    if (!handles) {
+        return nullptr;
+    }
+    std::vector<jlong> blobs;
+    for (std::unique_ptr<HeapBlob> &image : images) {
+        blobs.push_back(image.release()->toJava());
+    }
+    env->SetLongArrayRegion(handles, 0, length, blobs.data());
+    return handles;
+}
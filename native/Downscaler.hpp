@@ -0,0 +1,59 @@
+#ifndef DOWNSCALER_HPP
+#define DOWNSCALER_HPP
+
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "EnumMapping.hpp"
+#include "NativeMemory.hpp"
+
+enum class ScaleFilter : uint8_t {
+    Box,
+    Lanczos,
+};
+
+#define UEF_SCALE_FILTER_ENTRIES(X) \
+    X(ScaleFilter::Box, Box) \
+    X(ScaleFilter::Lanczos, Lanczos)
+
+UEF_DEFINE_ENUM_MAPPING(ScaleFilter, "ScaleFilter", UEF_SCALE_FILTER_ENTRIES, ScaleFilter::Lanczos);
+UEF_ASSERT_ENUM_MAPPING(ScaleFilter, ScaleFilter::Lanczos);
+
+struct ScaleSize {
+    uint32_t width;
+    uint32_t height;
+};
+
+/**
+ * Produces several downscaled copies of one premultiplied BGRA image in a single call.
+ *
+ * The source is reduced through a mip chain of exact 2x2 box halvings, each level built from the
+ * previous one, and every requested size is resampled from the nearest level: the smallest one still
+ * at least as large with Box, at least twice as large with Lanczos (so the 3-lobe kernel always sees
+ * the detail it filters). Sizes that are exact halvings of the source come straight out of the chain
+ * with Box. Both passes run in row bands on the shared WorkerPool; the calling thread takes part.
+ *
+ * Resampling is separable and done in single precision, one pixel (4 channels) per vector, and the
+ * result is clamped so no color channel exceeds its alpha, which Lanczos ringing would otherwise cause.
+ */
+class Downscaler {
+public:
+    // One tightly packed image per size, in the same order, or none if memory ran out. Every size must
+    // fit within the source.
+    static std::vector<std::unique_ptr<HeapBlob>> generate(const uint8_t *source, size_t rowBytes, uint32_t width, uint32_t height,
+                                                           const std::vector<ScaleSize> &sizes, ScaleFilter filter);
+
+    static void halve(const uint8_t *source, size_t sourceRowBytes, uint32_t width, uint32_t height,
+                      uint8_t *destination, size_t destinationRowBytes);
+
+    static void resample(const uint8_t *source, size_t sourceRowBytes, uint32_t sourceWidth, uint32_t sourceHeight,
+                         uint8_t *destination, size_t destinationRowBytes, uint32_t width, uint32_t height, ScaleFilter filter);
+};
+
+extern "C" {
+    JNIEXPORT jlongArray JNICALL Java_net_rk4z_juef_UefDownscaler_downscaleImage(JNIEnv *env, jclass obj, jobject pixels, jint rowBytes, jint width, jint height, jintArray sizes, jobject filter);
+}
+
+#endif //DOWNSCALER_HPP
@@ -0,0 +1,596 @@
+#include "EngineAllocator.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+AllocatorMode EngineAllocator::mode_ = AllocatorMode::System;
+ULAllocator EngineAllocator::system_ = {};
+bool EngineAllocator::saved_ = false;
+std::mutex EngineAllocator::installMutex_;
+
+static constexpr size_t kClasses = EngineAllocator::kClasses;
+static constexpr uint32_t kLargeClass = static_cast<uint32_t>(kClasses);
+static constexpr size_t kSpanShift = 16;
+static constexpr size_t kSpanSize = size_t(1) << kSpanShift;
+static constexpr size_t kArenaSize = 4u << 20;
+
+struct SizeClassTable {
+    uint32_t sizes[kClasses];
+    // Indexed by (size + 15) / 16.
+    uint8_t classOf[EngineAllocator::kMaxSmall / 16 + 1];
+
+    constexpr SizeClassTable() : sizes(), classOf() {
+        for (size_t i = 0; i < kClasses; i++) {
+            if (i < 8) {
+                sizes[i] = static_cast<uint32_t>(16 * (i + 1));
+            } else {
+                size_t power = size_t(128) << ((i - 8) / 4);
+                sizes[i] = static_cast<uint32_t>(power + ((i - 8) % 4 + 1) * (power / 4));
+            }
+        }
+        size_t sizeClass = 0;
+        for (size_t step = 1; step < sizeof(classOf); step++) {
+            while (sizes[sizeClass] < step * 16) {
+                sizeClass++;
+            }
+            classOf[step] = static_cast<uint8_t>(sizeClass);
+        }
+    }
+};
+
+static constexpr SizeClassTable kSizeClasses;
+
+static_assert(kSizeClasses.sizes[kClasses - 1] == EngineAllocator::kMaxSmall,
+              "The last size class must end at kMaxSmall");
+
+static uint32_t ClassOf(size_t bytes) {
+    return kSizeClasses.classOf[(std::max<size_t>(bytes, 1) + 15) / 16];
+}
+
+// Blocks moved between a thread and the depot at once: enough to amortize the lock, small enough
+// that idle threads do not sit on much.
+static uint32_t BatchSize(uint32_t sizeClass) {
+    return std::min<uint32_t>(64, std::max<uint32_t>(4, 32768 / kSizeClasses.sizes[sizeClass]));
+}
+
+/**
+ * The size class owning each 64 KiB span, stored as class + 1 so that zero means "not ours". Covers
+ * 48-bit addresses with a root of 65536 pointers to leaves of 65536 entries, allocated as spans
+ * appear; leaves are never freed, so a reader only needs the root entry to be published.
+ */
+static constexpr size_t kLeafBits = 16;
+static std::atomic<uint8_t *> pageMap[size_t(1) << kLeafBits];
+
+static uint32_t SpanClass(const void *address) {
+    uint64_t page = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(address)) >> kSpanShift;
+    if (page >> (2 * kLeafBits)) {
+        return 0;
+    }
+    uint8_t *leaf = pageMap[page >> kLeafBits].load(std::memory_order_acquire);
+    return leaf ? leaf[page & ((size_t(1) << kLeafBits) - 1)] : 0;
+}
+
+struct FreeList {
+    void *head;
+    uint32_t count;
+};
+
+static void *&Next(void *block) {
+    return *static_cast<void **>(block);
+}
+
+struct Depot {
+    std::mutex mutex;
+    FreeList blocks{};
+};
+
+struct Pool {
+    Depot depots[kClasses];
+
+    std::mutex arenaMutex;
+    char *arenaNext = nullptr;
+    char *arenaEnd = nullptr;
+};
+
+// Created by the first install of the pool and never destroyed: engine threads may still free
+// while the process exits.
+static Pool *pool = nullptr;
+
+struct ThreadStats {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t allocatedBytes;
+    uint64_t freedBytes;
+    uint64_t classAllocations[UEF_ALLOCATOR_CLASSES];
+    uint64_t classFrees[UEF_ALLOCATOR_CLASSES];
+};
+
+struct GlobalStats {
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> frees;
+    std::atomic<uint64_t> allocatedBytes;
+    std::atomic<int64_t> liveBytes;
+    std::atomic<uint64_t> peakBytes;
+    std::atomic<uint64_t> reservedBytes;
+    std::atomic<uint64_t> classAllocations[UEF_ALLOCATOR_CLASSES];
+    std::atomic<uint64_t> classFrees[UEF_ALLOCATOR_CLASSES];
+};
+
+static GlobalStats globalStats;
+
+static void Publish(ThreadStats &stats) {
+    globalStats.allocations.fetch_add(stats.allocations, std::memory_order_relaxed);
+    globalStats.frees.fetch_add(stats.frees, std::memory_order_relaxed);
+    globalStats.allocatedBytes.fetch_add(stats.allocatedBytes, std::memory_order_relaxed);
+
+    auto delta = static_cast<int64_t>(stats.allocatedBytes - stats.freedBytes);
+    int64_t live = globalStats.liveBytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    uint64_t peak = globalStats.peakBytes.load(std::memory_order_relaxed);
+    while (live > 0 && static_cast<uint64_t>(live) > peak
+           && !globalStats.peakBytes.compare_exchange_weak(peak, static_cast<uint64_t>(live), std::memory_order_relaxed)) {
+    }
+
+    for (size_t i = 0; i < UEF_ALLOCATOR_CLASSES; i++) {
+        if (stats.classAllocations[i]) {
+            globalStats.classAllocations[i].fetch_add(stats.classAllocations[i], std::memory_order_relaxed);
+        }
+        if (stats.classFrees[i]) {
+            globalStats.classFrees[i].fetch_add(stats.classFrees[i], std::memory_order_relaxed);
+        }
+    }
+    stats = ThreadStats();
+}
+
+struct ThreadCache {
+    FreeList lists[kClasses] = {};
+    ThreadStats stats = {};
+
+    ~ThreadCache();
+};
+
+static void Release(FreeList &list, uint32_t sizeClass, uint32_t count);
+
+static thread_local ThreadCache threadCache;
+// Set once the thread's cache is gone; allocations made by later destructors go to the depot.
+static thread_local bool threadCacheGone = false;
+
+ThreadCache::~ThreadCache() {
+    for (uint32_t sizeClass = 0; sizeClass < kClasses; sizeClass++) {
+        if (lists[sizeClass].count) {
+            Release(lists[sizeClass], sizeClass, lists[sizeClass].count);
+        }
+    }
+    Publish(stats);
+    threadCacheGone = true;
+}
+
+static ThreadCache *CurrentCache() {
+    return threadCacheGone ? nullptr : &threadCache;
+}
+
+static void Record(ThreadStats &stats, uint32_t sizeClass, size_t bytes, bool allocation) {
+    if (allocation) {
+        stats.allocations++;
+        stats.allocatedBytes += bytes;
+        stats.classAllocations[sizeClass]++;
+    } else {
+        stats.frees++;
+        stats.freedBytes += bytes;
+        stats.classFrees[sizeClass]++;
+    }
+}
+
+static void Count(ThreadCache *cache, uint32_t sizeClass, size_t bytes, bool allocation) {
+    if (!cache) {
+        ThreadStats single{};
+        Record(single, sizeClass, bytes, allocation);
+        Publish(single);
+        return;
+    }
+    ThreadStats &stats = cache->stats;
+    Record(stats, sizeClass, bytes, allocation);
+    if (stats.allocatedBytes + stats.freedBytes >= EngineAllocator::kPublishBytes) {
+        Publish(stats);
+    }
+}
+
+static void Count(uint32_t sizeClass, size_t bytes, bool allocation) {
+    Count(CurrentCache(), sizeClass, bytes, allocation);
+}
+
+// A fresh span, already entered in the page map. Called with the class's depot locked.
+static char *TakeSpan(uint32_t sizeClass) {
+    std::lock_guard<std::mutex> lock(pool->arenaMutex);
+    if (pool->arenaNext == pool->arenaEnd) {
+        auto arena = static_cast<char *>(AllocateAligned(kArenaSize, kSpanSize));
+        if (!arena) {
+            return nullptr;
+        }
+        if ((static_cast<uint64_t>(reinterpret_cast<uintptr_t>(arena + kArenaSize - 1)) >> kSpanShift) >> (2 * kLeafBits)) {
+            FreeAligned(arena);
+            return nullptr;
+        }
+        pool->arenaNext = arena;
+        pool->arenaEnd = arena + kArenaSize;
+        globalStats.reservedBytes.fetch_add(kArenaSize, std::memory_order_relaxed);
+    }
+
+    char *span = pool->arenaNext;
+    uint64_t page = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(span)) >> kSpanShift;
+    std::atomic<uint8_t *> &root = pageMap[page >> kLeafBits];
+    uint8_t *leaf = root.load(std::memory_order_relaxed);
+    if (!leaf) {
+        leaf = static_cast<uint8_t *>(calloc(size_t(1) << kLeafBits, 1));
+        if (!leaf) {
+            return nullptr;
+        }
+        root.store(leaf, std::memory_order_release);
+    }
+    leaf[page & ((size_t(1) << kLeafBits) - 1)] = static_cast<uint8_t>(sizeClass + 1);
+    pool->arenaNext += kSpanSize;
+    return span;
+}
+
+// Moves up to count blocks from the depot to an empty list, carving a new span when it runs dry.
+static bool Refill(FreeList &list, uint32_t sizeClass, uint32_t count) {
+    Depot &depot = pool->depots[sizeClass];
+    std::lock_guard<std::mutex> lock(depot.mutex);
+    if (depot.blocks.count < count) {
+        char *span = TakeSpan(sizeClass);
+        if (span) {
+            uint32_t size = kSizeClasses.sizes[sizeClass];
+            auto blocks = static_cast<uint32_t>(kSpanSize / size);
+            for (uint32_t i = 0; i < blocks; i++) {
+                Next(span + i * size) = i + 1 < blocks ? span + (i + 1) * size : depot.blocks.head;
+            }
+            depot.blocks.head = span;
+            depot.blocks.count += blocks;
+        }
+    }
+    if (!depot.blocks.count) {
+        return false;
+    }
+
+    count = std::min(count, depot.blocks.count);
+    void *tail = depot.blocks.head;
+    for (uint32_t i = 1; i < count; i++) {
+        tail = Next(tail);
+    }
+    list.head = depot.blocks.head;
+    list.count = count;
+    depot.blocks.head = Next(tail);
+    depot.blocks.count -= count;
+    Next(tail) = nullptr;
+    return true;
+}
+
+// Moves the first count blocks of a list back to the depot.
+static void Release(FreeList &list, uint32_t sizeClass, uint32_t count) {
+    void *head = list.head;
+    void *tail = head;
+    for (uint32_t i = 1; i < count; i++) {
+        tail = Next(tail);
+    }
+    list.head = Next(tail);
+    list.count -= count;
+
+    Depot &depot = pool->depots[sizeClass];
+    std::lock_guard<std::mutex> lock(depot.mutex);
+    Next(tail) = depot.blocks.head;
+    depot.blocks.head = head;
+    depot.blocks.count += count;
+}
+
+static void *AllocateSmall(uint32_t sizeClass) {
+    ThreadCache *cache = CurrentCache();
+    FreeList single{};
+    FreeList &list = cache ? cache->lists[sizeClass] : single;
+    if (!list.head && !Refill(list, sizeClass, cache ? BatchSize(sizeClass) : 1)) {
+        return nullptr;
+    }
+
+    void *block = list.head;
+    list.head = Next(block);
+    list.count--;
+    Count(cache, sizeClass, kSizeClasses.sizes[sizeClass], true);
+    return block;
+}
+
+static void FreeSmall(void *block, uint32_t sizeClass) {
+    ThreadCache *cache = CurrentCache();
+    Count(cache, sizeClass, kSizeClasses.sizes[sizeClass], false);
+    if (!cache) {
+        FreeList single{block, 1};
+        Next(block) = nullptr;
+        Release(single, sizeClass, 1);
+        return;
+    }
+
+    FreeList &list = cache->lists[sizeClass];
+    Next(block) = list.head;
+    list.head = block;
+    list.count++;
+    uint32_t batch = BatchSize(sizeClass);
+    if (list.count > 2 * batch) {
+        Release(list, sizeClass, batch);
+    }
+}
+
+// Size class of the first class at least bytes large whose blocks are all aligned, kLargeClass if none is.
+static uint32_t AlignedClassOf(size_t bytes, size_t alignment) {
+    if (bytes > EngineAllocator::kMaxSmall || (alignment & (alignment - 1))) {
+        return kLargeClass;
+    }
+    uint32_t sizeClass = ClassOf(bytes);
+    while (sizeClass < kClasses && kSizeClasses.sizes[sizeClass] % alignment) {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+static size_t Estimate(size_t (*estimate)(void *), void *address) {
+    return estimate && address ? estimate(address) : 0;
+}
+
+// How a block handed out or taken back by the library's defaults is counted.
+static uint32_t EstimateClass(size_t bytes) {
+    return bytes <= EngineAllocator::kMaxSmall ? ClassOf(bytes) : kLargeClass;
+}
+
+void *EngineAllocator::poolMalloc(size_t bytes) {
+    if (bytes <= kMaxSmall) {
+        void *block = AllocateSmall(ClassOf(bytes));
+        if (block) {
+            return block;
+        }
+    }
+    void *address = system_.malloc(bytes);
+    if (address) {
+        Count(kLargeClass, Estimate(system_.get_size_estimate, address), true);
+    }
+    return address;
+}
+
+void *EngineAllocator::poolRealloc(void *address, size_t bytes) {
+    if (!address) {
+        return poolMalloc(bytes);
+    }
+
+    uint32_t span = SpanClass(address);
+    if (!span) {
+        // Never zero bytes: some C libraries then free the block and return null, which could not be
+        // told from running out of memory.
+        size_t old = Estimate(system_.get_size_estimate, address);
+        void *resized = system_.realloc(address, std::max<size_t>(bytes, 1));
+        if (resized) {
+            Count(kLargeClass, old, false);
+            Count(kLargeClass, Estimate(system_.get_size_estimate, resized), true);
+        }
+        return resized;
+    }
+
+    uint32_t size = kSizeClasses.sizes[span - 1];
+    if (bytes <= size) {
+        return address;
+    }
+    void *resized = poolMalloc(bytes);
+    if (resized) {
+        memcpy(resized, address, size);
+        FreeSmall(address, span - 1);
+    }
+    return resized;
+}
+
+void EngineAllocator::poolFree(void *address) {
+    if (!address) {
+        return;
+    }
+    uint32_t span = SpanClass(address);
+    if (span) {
+        FreeSmall(address, span - 1);
+        return;
+    }
+    Count(kLargeClass, Estimate(system_.get_size_estimate, address), false);
+    system_.free(address);
+}
+
+void *EngineAllocator::poolAlignedMalloc(size_t bytes, size_t alignment) {
+    uint32_t sizeClass = AlignedClassOf(bytes, std::max<size_t>(alignment, 16));
+    if (sizeClass < kClasses) {
+        void *block = AllocateSmall(sizeClass);
+        if (block) {
+            return block;
+        }
+    }
+    void *address = system_.aligned_malloc(bytes, alignment);
+    if (address) {
+        Count(kLargeClass, Estimate(system_.get_size_estimate, address), true);
+    }
+    return address;
+}
+
+void *EngineAllocator::poolAlignedRealloc(void *address, size_t bytes, size_t alignment) {
+    if (!address) {
+        return poolAlignedMalloc(bytes, alignment);
+    }
+
+    uint32_t span = SpanClass(address);
+    if (!span) {
+        size_t old = Estimate(system_.get_size_estimate, address);
+        void *resized = system_.aligned_realloc(address, std::max<size_t>(bytes, 1), alignment);
+        if (resized) {
+            Count(kLargeClass, old, false);
+            Count(kLargeClass, Estimate(system_.get_size_estimate, resized), true);
+        }
+        return resized;
+    }
+
+    uint32_t size = kSizeClasses.sizes[span - 1];
+    if (bytes <= size && alignment && reinterpret_cast<uintptr_t>(address) % alignment == 0) {
+        return address;
+    }
+    void *resized = poolAlignedMalloc(bytes, alignment);
+    if (resized) {
+        memcpy(resized, address, std::min<size_t>(size, bytes));
+        FreeSmall(address, span - 1);
+    }
+    return resized;
+}
+
+void EngineAllocator::poolAlignedFree(void *address) {
+    if (!address) {
+        return;
+    }
+    uint32_t span = SpanClass(address);
+    if (span) {
+        FreeSmall(address, span - 1);
+        return;
+    }
+    Count(kLargeClass, Estimate(system_.get_size_estimate, address), false);
+    system_.aligned_free(address);
+}
+
+size_t EngineAllocator::poolSizeEstimate(void *address) {
+    uint32_t span = SpanClass(address);
+    return span ? kSizeClasses.sizes[span - 1] : Estimate(system_.get_size_estimate, address);
+}
+
+void *EngineAllocator::countedMalloc(size_t bytes) {
+    void *address = system_.malloc(bytes);
+    if (address) {
+        size_t size = Estimate(system_.get_size_estimate, address);
+        Count(EstimateClass(size), size, true);
+    }
+    return address;
+}
+
+void *EngineAllocator::countedRealloc(void *address, size_t bytes) {
+    size_t old = Estimate(system_.get_size_estimate, address);
+    void *resized = system_.realloc(address, std::max<size_t>(bytes, 1));
+    if (resized) {
+        if (address) {
+            Count(EstimateClass(old), old, false);
+        }
+        size_t size = Estimate(system_.get_size_estimate, resized);
+        Count(EstimateClass(size), size, true);
+    }
+    return resized;
+}
+
+void EngineAllocator::countedFree(void *address) {
+    if (address) {
+        size_t size = Estimate(system_.get_size_estimate, address);
+        Count(EstimateClass(size), size, false);
+    }
+    system_.free(address);
+}
+
+void *EngineAllocator::countedAlignedMalloc(size_t bytes, size_t alignment) {
+    void *address = system_.aligned_malloc(bytes, alignment);
+    if (address) {
+        size_t size = Estimate(system_.get_size_estimate, address);
+        Count(EstimateClass(size), size, true);
+    }
+    return address;
+}
+
+void *EngineAllocator::countedAlignedRealloc(void *address, size_t bytes, size_t alignment) {
+    size_t old = Estimate(system_.get_size_estimate, address);
+    void *resized = system_.aligned_realloc(address, std::max<size_t>(bytes, 1), alignment);
+    if (resized) {
+        if (address) {
+            Count(EstimateClass(old), old, false);
+        }
+        size_t size = Estimate(system_.get_size_estimate, resized);
+        Count(EstimateClass(size), size, true);
+    }
+    return resized;
+}
+
+void EngineAllocator::countedAlignedFree(void *address) {
+    if (address) {
+        size_t size = Estimate(system_.get_size_estimate, address);
+        Count(EstimateClass(size), size, false);
+    }
+    system_.aligned_free(address);
+}
+
+bool EngineAllocator::install(AllocatorMode mode) {
+    std::lock_guard<std::mutex> lock(installMutex_);
+    if (mode == mode_) {
+        return true;
+    }
+    if (mode_ == AllocatorMode::Pool) {
+        return false;
+    }
+
+    if (!saved_) {
+        system_ = ulAllocator;
+        saved_ = true;
+    }
+
+    switch (mode) {
+        case AllocatorMode::System:
+            ulAllocator = system_;
+            break;
+        case AllocatorMode::Pool:
+            if (!pool) {
+                pool = new Pool();
+            }
+            ulAllocator = ULAllocator{poolMalloc, poolRealloc, poolFree, poolAlignedMalloc, poolAlignedRealloc,
+                                      poolAlignedFree, poolSizeEstimate};
+            break;
+        case AllocatorMode::Instrumented:
+            ulAllocator = ULAllocator{countedMalloc, countedRealloc, countedFree, countedAlignedMalloc,
+                                      countedAlignedRealloc, countedAlignedFree, system_.get_size_estimate};
+            break;
+    }
+    mode_ = mode;
+    return true;
+}
+
+size_t EngineAllocator::classSize(size_t sizeClass) {
+    return sizeClass < kClasses ? kSizeClasses.sizes[sizeClass] : 0;
+}
+
+AllocatorStats EngineAllocator::stats() {
+    AllocatorStats stats{};
+    int64_t live = globalStats.liveBytes.load(std::memory_order_relaxed);
+    // Blocks allocated before the switch are only seen being freed.
+    stats.liveBytes = live > 0 ? static_cast<uint64_t>(live) : 0;
+    stats.peakBytes = globalStats.peakBytes.load(std::memory_order_relaxed);
+    stats.allocations = globalStats.allocations.load(std::memory_order_relaxed);
+    stats.frees = globalStats.frees.load(std::memory_order_relaxed);
+    stats.allocatedBytes = globalStats.allocatedBytes.load(std::memory_order_relaxed);
+    stats.reservedBytes = globalStats.reservedBytes.load(std::memory_order_relaxed);
+    stats.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    for (size_t i = 0; i < UEF_ALLOCATOR_CLASSES; i++) {
+        uint64_t allocations = globalStats.classAllocations[i].load(std::memory_order_relaxed);
+        uint64_t frees = globalStats.classFrees[i].load(std::memory_order_relaxed);
+        stats.classAllocations[i] = allocations;
+        stats.classLive[i] = allocations > frees ? allocations - frees : 0;
+    }
+    return stats;
+}
+
+void Java_net_rk4z_juef_UefPlatform_getAllocatorStats(JNIEnv *env, jclass obj, jlongArray stats) {
+    AllocatorStats current = EngineAllocator::stats();
+    jlong values[UEF_ALLOCATOR_STATS_LENGTH] = {
+        static_cast<jlong>(current.liveBytes), static_cast<jlong>(current.peakBytes),
+        static_cast<jlong>(current.allocations), static_cast<jlong>(current.frees),
+        static_cast<jlong>(current.allocatedBytes), static_cast<jlong>(current.reservedBytes),
+        static_cast<jlong>(current.timestamp),
+    };
+    for (size_t i = 0; i < UEF_ALLOCATOR_CLASSES; i++) {
+        size_t size = EngineAllocator::classSize(i);
+        values[7 + 3 * i] = size ? static_cast<jlong>(size) : std::numeric_limits<jlong>::max();
+        values[8 + 3 * i] = static_cast<jlong>(current.classAllocations[i]);
+        values[9 + 3 * i] = static_cast<jlong>(current.classLive[i]);
+    }
+    env->SetLongArrayRegion(stats, 0, UEF_ALLOCATOR_STATS_LENGTH, values);
+}
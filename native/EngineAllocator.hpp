@@ -0,0 +1,101 @@
+#ifndef ENGINEALLOCATOR_HPP
+#define ENGINEALLOCATOR_HPP
+
+#include <jni.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <Ultralight/platform/Allocator.h>
+#include "EnumMapping.hpp"
+
+// Size classes of the pool, plus one bucket for everything above kMaxSmall.
+#define UEF_ALLOCATOR_CLASSES 37
+#define UEF_ALLOCATOR_STATS_LENGTH (7 + 3 * UEF_ALLOCATOR_CLASSES)
+
+enum class AllocatorMode : uint8_t {
+    System,
+    Pool,
+    Instrumented,
+};
+
+#define UEF_ALLOCATOR_MODE_ENTRIES(X) \
+    X(AllocatorMode::System, System) \
+    X(AllocatorMode::Pool, Pool) \
+    X(AllocatorMode::Instrumented, Instrumented)
+
+UEF_DEFINE_ENUM_MAPPING(AllocatorMode, "AllocatorMode", UEF_ALLOCATOR_MODE_ENTRIES, AllocatorMode::System);
+UEF_ASSERT_ENUM_MAPPING(AllocatorMode, AllocatorMode::Instrumented);
+
+struct AllocatorStats {
+    uint64_t liveBytes;
+    uint64_t peakBytes;
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t allocatedBytes;
+    uint64_t reservedBytes;
+    uint64_t timestamp;
+    uint64_t classAllocations[UEF_ALLOCATOR_CLASSES];
+    uint64_t classLive[UEF_ALLOCATOR_CLASSES];
+};
+
+/**
+ * The functions behind ulAllocator, i.e. the engine's own heap. With AllocatorMode::System the
+ * library's defaults stay in place and nothing is counted.
+ *
+ * AllocatorMode::Pool serves requests up to kMaxSmall from 36 size classes (16-byte steps up to 128,
+ * then four per power of two). Each class is carved out of 64 KiB spans taken from 4 MiB arenas
+ * that are never returned. Every thread keeps a free list per class;
+ * refills and overflow move whole batches to and from a central depot per class, so the common path
+ * takes no lock. Blocks of a class whose size is a multiple of the requested alignment are aligned
+ * to it, which covers bitmap_alignment up to 16 KiB. Larger or more strictly aligned requests, and
+ * every pointer the page map does not know (anything allocated before the switch), go to the
+ * library's defaults.
+ *
+ * AllocatorMode::Instrumented passes everything to the library's defaults and only counts.
+ *
+ * Counters are kept per thread and published every kPublishBytes of traffic, so a snapshot may lag
+ * that much per thread. The hooks only take effect in library builds with UL_ENABLE_ALLOCATOR_OVERRIDE.
+ */
+class EngineAllocator {
+public:
+    static constexpr size_t kMaxSmall = 16u << 10;
+    static constexpr size_t kClasses = UEF_ALLOCATOR_CLASSES - 1;
+    static constexpr size_t kPublishBytes = 256u << 10;
+
+    // False once the pool is installed and mode is something else: its blocks cannot be handed back.
+    static bool install(AllocatorMode mode);
+    static AllocatorMode mode() { return mode_; }
+
+    static AllocatorStats stats();
+    // The largest request a class takes, 0 for the last bucket.
+    static size_t classSize(size_t sizeClass);
+
+private:
+    static void *poolMalloc(size_t bytes);
+    static void *poolRealloc(void *address, size_t bytes);
+    static void poolFree(void *address);
+    static void *poolAlignedMalloc(size_t bytes, size_t alignment);
+    static void *poolAlignedRealloc(void *address, size_t bytes, size_t alignment);
+    static void poolAlignedFree(void *address);
+    static size_t poolSizeEstimate(void *address);
+
+    static void *countedMalloc(size_t bytes);
+    static void *countedRealloc(void *address, size_t bytes);
+    static void countedFree(void *address);
+    static void *countedAlignedMalloc(size_t bytes, size_t alignment);
+    static void *countedAlignedRealloc(void *address, size_t bytes, size_t alignment);
+    static void countedAlignedFree(void *address);
+
+    static AllocatorMode mode_;
+    // The library's defaults, saved by the first install.
+    static ULAllocator system_;
+    static bool saved_;
+    static std::mutex installMutex_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_getAllocatorStats(JNIEnv *env, jclass obj, jlongArray stats);
+}
+
+#endif //ENGINEALLOCATOR_HPP
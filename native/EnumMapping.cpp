@@ -0,0 +1,148 @@
+#include "EnumMapping.hpp"
+
+#include <cstring>
+#include <string>
+#include <Ultralight/KeyCodes.h>
+#include "Downscaler.hpp"
+#include "EngineAllocator.hpp"
+#include "FrameScheduler.hpp"
+#include "ImageEncoder.hpp"
+#include "PixelConvert.hpp"
+#include "SurfaceFactory.hpp"
+#include "TiledSurface.hpp"
+
+// Every constant in Ultralight/KeyCodes.h, mirrored one-to-one by net.rk4z.juef.util.KeyCodes. Java
+// hands key codes through as plain ints, so the Java values are compared with these on load.
+#define UEF_KEY_CODE_ENTRIES(X) \
+    X(GK_BACK) X(GK_TAB) X(GK_CLEAR) X(GK_RETURN) X(GK_SHIFT) X(GK_CONTROL) X(GK_MENU) X(GK_PAUSE) \
+    X(GK_CAPITAL) X(GK_KANA) X(GK_HANGUL) X(GK_IME_ON) X(GK_JUNJA) X(GK_FINAL) X(GK_HANJA) X(GK_KANJI) \
+    X(GK_IME_OFF) X(GK_ESCAPE) X(GK_CONVERT) X(GK_NONCONVERT) X(GK_ACCEPT) X(GK_MODECHANGE) X(GK_SPACE) \
+    X(GK_PRIOR) X(GK_NEXT) X(GK_END) X(GK_HOME) X(GK_LEFT) X(GK_UP) X(GK_RIGHT) X(GK_DOWN) X(GK_SELECT) \
+    X(GK_PRINT) X(GK_EXECUTE) X(GK_SNAPSHOT) X(GK_INSERT) X(GK_DELETE) X(GK_HELP) X(GK_0) X(GK_1) X(GK_2) \
+    X(GK_3) X(GK_4) X(GK_5) X(GK_6) X(GK_7) X(GK_8) X(GK_9) X(GK_A) X(GK_B) X(GK_C) X(GK_D) X(GK_E) \
+    X(GK_F) X(GK_G) X(GK_H) X(GK_I) X(GK_J) X(GK_K) X(GK_L) X(GK_M) X(GK_N) X(GK_O) X(GK_P) X(GK_Q) \
+    X(GK_R) X(GK_S) X(GK_T) X(GK_U) X(GK_V) X(GK_W) X(GK_X) X(GK_Y) X(GK_Z) X(GK_LWIN) X(GK_RWIN) \
+    X(GK_APPS) X(GK_SLEEP) X(GK_NUMPAD0) X(GK_NUMPAD1) X(GK_NUMPAD2) X(GK_NUMPAD3) X(GK_NUMPAD4) \
+    X(GK_NUMPAD5) X(GK_NUMPAD6) X(GK_NUMPAD7) X(GK_NUMPAD8) X(GK_NUMPAD9) X(GK_MULTIPLY) X(GK_ADD) \
+    X(GK_SEPARATOR) X(GK_SUBTRACT) X(GK_DECIMAL) X(GK_DIVIDE) X(GK_F1) X(GK_F2) X(GK_F3) X(GK_F4) \
+    X(GK_F5) X(GK_F6) X(GK_F7) X(GK_F8) X(GK_F9) X(GK_F10) X(GK_F11) X(GK_F12) X(GK_F13) X(GK_F14) \
+    X(GK_F15) X(GK_F16) X(GK_F17) X(GK_F18) X(GK_F19) X(GK_F20) X(GK_F21) X(GK_F22) X(GK_F23) X(GK_F24) \
+    X(GK_NUMLOCK) X(GK_SCROLL) X(GK_LSHIFT) X(GK_RSHIFT) X(GK_LCONTROL) X(GK_RCONTROL) X(GK_LMENU) \
+    X(GK_RMENU) X(GK_BROWSER_BACK) X(GK_BROWSER_FORWARD) X(GK_BROWSER_REFRESH) X(GK_BROWSER_STOP) \
+    X(GK_BROWSER_SEARCH) X(GK_BROWSER_FAVORITES) X(GK_BROWSER_HOME) X(GK_VOLUME_MUTE) X(GK_VOLUME_DOWN) \
+    X(GK_VOLUME_UP) X(GK_MEDIA_NEXT_TRACK) X(GK_MEDIA_PREV_TRACK) X(GK_MEDIA_STOP) X(GK_MEDIA_PLAY_PAUSE) \
+    X(GK_MEDIA_LAUNCH_MAIL) X(GK_MEDIA_LAUNCH_MEDIA_SELECT) X(GK_MEDIA_LAUNCH_APP1) \
+    X(GK_MEDIA_LAUNCH_APP2) X(GK_OEM_1) X(GK_OEM_PLUS) X(GK_OEM_COMMA) X(GK_OEM_MINUS) X(GK_OEM_PERIOD) \
+    X(GK_OEM_2) X(GK_OEM_3) X(GK_OEM_4) X(GK_OEM_5) X(GK_OEM_6) X(GK_OEM_7) X(GK_OEM_8) X(GK_OEM_102) \
+    X(GK_PROCESSKEY) X(GK_PACKET) X(GK_OEM_ATTN) X(GK_ATTN) X(GK_CRSEL) X(GK_EXSEL) X(GK_EREOF) \
+    X(GK_PLAY) X(GK_ZOOM) X(GK_NONAME) X(GK_PA1) X(GK_OEM_CLEAR) X(GK_UNKNOWN)
+
+struct KeyCodeEntry {
+    const char *name;
+    int value;
+};
+
+#define UEF_KEY_CODE(name) {#name, KeyCodes::name},
+
+static constexpr KeyCodeEntry kKeyCodes[] = { UEF_KEY_CODE_ENTRIES(UEF_KEY_CODE) };
+
+// The number of constants Ultralight/KeyCodes.h declares; an SDK update that adds one fails here
+// until the table and KeyCodes.java both list it.
+static_assert(sizeof(kKeyCodes) / sizeof(kKeyCodes[0]) == 170,
+              "kKeyCodes must list every constant declared in Ultralight/KeyCodes.h");
+
+static void ThrowOutOfSync(JNIEnv *env, const std::string &message) {
+    jclass exceptionClass = env->FindClass("java/lang/IllegalStateException");
+    env->ThrowNew(exceptionClass, message.c_str());
+    env->DeleteLocalRef(exceptionClass);
+}
+
+template <typename T>
+static bool LoadEnumMapping(JNIEnv *env, jmethodID nameMethod) {
+    using Mapping = EnumMapping<T>;
+
+    jclass enumClass = env->FindClass(Mapping::javaClass);
+    if (!enumClass) {
+        return false;
+    }
+
+    std::string valuesSignature = std::string("()[L") + Mapping::javaClass + ";";
+    jmethodID valuesMethod = env->GetStaticMethodID(enumClass, "values", valuesSignature.c_str());
+    if (!valuesMethod) {
+        env->DeleteLocalRef(enumClass);
+        return false;
+    }
+
+    auto javaValues = (jobjectArray) env->CallStaticObjectMethod(enumClass, valuesMethod);
+    env->DeleteLocalRef(enumClass);
+
+    bool inSync = env->GetArrayLength(javaValues) == static_cast<jsize>(Mapping::count);
+    for (size_t i = 0; inSync && i < Mapping::count; i++) {
+        jobject constant = env->GetObjectArrayElement(javaValues, static_cast<jsize>(i));
+        auto nameJava = (jstring) env->CallObjectMethod(constant, nameMethod);
+        const char *nameCStr = env->GetStringUTFChars(nameJava, nullptr);
+
+        inSync = strcmp(nameCStr, Mapping::names[i]) == 0;
+
+        env->ReleaseStringUTFChars(nameJava, nameCStr);
+        env->DeleteLocalRef(nameJava);
+        env->DeleteLocalRef(constant);
+    }
+    env->DeleteLocalRef(javaValues);
+
+    if (!inSync) {
+        ThrowOutOfSync(env, std::string(Mapping::javaClass) + " is out of sync with the native enum table");
+    }
+    return inSync;
+}
+
+static bool LoadKeyCodes(JNIEnv *env) {
+    jclass keyCodesClass = env->FindClass(UEF_PACKAGE "util/KeyCodes");
+    if (!keyCodesClass) {
+        return false;
+    }
+
+    const char *mismatch = nullptr;
+    for (const KeyCodeEntry &entry : kKeyCodes) {
+        jfieldID field = env->GetStaticFieldID(keyCodesClass, entry.name, "I");
+        if (!field) {
+            env->ExceptionClear();
+            mismatch = entry.name;
+            break;
+        }
+        if (env->GetStaticIntField(keyCodesClass, field) != entry.value) {
+            mismatch = entry.name;
+            break;
+        }
+    }
+    env->DeleteLocalRef(keyCodesClass);
+
+    if (mismatch) {
+        ThrowOutOfSync(env, std::string(UEF_PACKAGE "util/KeyCodes.") + mismatch + " is out of sync with Ultralight/KeyCodes.h");
+    }
+    return !mismatch;
+}
+
+bool LoadEnumMappings(JNIEnv *env) {
+    jmethodID nameMethod = env->GetMethodID(JniRegistry::enumClass_, "name", "()Ljava/lang/String;");
+    if (!nameMethod) {
+        return false;
+    }
+
+    return LoadEnumMapping<FaceWinding>(env, nameMethod)
+        && LoadEnumMapping<FontHinting>(env, nameMethod)
+        && LoadEnumMapping<EffectQuality>(env, nameMethod)
+        && LoadEnumMapping<BitmapFormat>(env, nameMethod)
+        && LoadEnumMapping<LogLevel>(env, nameMethod)
+        && LoadEnumMapping<SurfaceType>(env, nameMethod)
+        && LoadEnumMapping<Cursor>(env, nameMethod)
+        && LoadEnumMapping<MessageSource>(env, nameMethod)
+        && LoadEnumMapping<MessageLevel>(env, nameMethod)
+        && LoadEnumMapping<ViewPriority>(env, nameMethod)
+        && LoadEnumMapping<ImageFormat>(env, nameMethod)
+        && LoadEnumMapping<PixelFormat>(env, nameMethod)
+        && LoadEnumMapping<ScaleFilter>(env, nameMethod)
+        && LoadEnumMapping<HibernateMode>(env, nameMethod)
+        && LoadEnumMapping<AllocatorMode>(env, nameMethod)
+        && LoadKeyCodes(env);
+}
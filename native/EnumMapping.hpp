@@ -0,0 +1,183 @@
+#ifndef ENUMMAPPING_HPP
+#define ENUMMAPPING_HPP
+
+#include <jni.h>
+#include <cstddef>
+#include <Ultralight/Bitmap.h>
+#include <Ultralight/ConsoleMessage.h>
+#include <Ultralight/Listener.h>
+#include <Ultralight/platform/Config.h>
+#include <Ultralight/platform/Logger.h>
+#include "JniRegistry.hpp"
+
+using namespace ultralight;
+
+/**
+ * Compile-time translation tables between the Java enums in net.rk4z.juef.util and their native
+ * counterparts. Each table lists the C++ values in Java ordinal order, so converting an ordinal is a
+ * single array index, and a static_assert pins it to the C++ enum's declaration order. Ultralight's
+ * own enums are mapped below; the library's enums are mapped next to their declarations. The Java
+ * constant names are checked against the same tables once in JNI_OnLoad.
+ */
+template <typename T>
+struct EnumMapping;
+
+#define UEF_ENUM_VALUE(cpp, java) cpp,
+#define UEF_ENUM_NAME(cpp, java) #java,
+
+#define UEF_DEFINE_ENUM_MAPPING(Type, javaName, entries, fallbackValue) \
+    template <> \
+    struct EnumMapping<Type> { \
+        static constexpr const char *javaClass = UEF_PACKAGE "util/" javaName; \
+        static constexpr Type values[] = { entries(UEF_ENUM_VALUE) }; \
+        static constexpr const char *names[] = { entries(UEF_ENUM_NAME) }; \
+        static constexpr size_t count = sizeof(values) / sizeof(values[0]); \
+        static constexpr Type fallback = fallbackValue; \
+    }
+
+template <typename T, size_t N>
+constexpr bool IsInOrdinalOrder(const T (&values)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (static_cast<size_t>(values[i]) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#define UEF_ASSERT_ENUM_MAPPING(Type, lastValue) \
+    static_assert(IsInOrdinalOrder(EnumMapping<Type>::values) \
+                  && EnumMapping<Type>::count == static_cast<size_t>(lastValue) + 1, \
+                  "EnumMapping<" #Type "> is out of sync with the Ultralight declaration")
+
+#define UEF_FACE_WINDING_ENTRIES(X) \
+    X(FaceWinding::Clockwise, Clockwise) \
+    X(FaceWinding::CounterClockwise, CounterClockwise)
+
+#define UEF_FONT_HINTING_ENTRIES(X) \
+    X(FontHinting::Smooth, Smooth) \
+    X(FontHinting::Normal, Normal) \
+    X(FontHinting::Monochrome, Monochrome) \
+    X(FontHinting::None, None)
+
+#define UEF_EFFECT_QUALITY_ENTRIES(X) \
+    X(EffectQuality::Low, Low) \
+    X(EffectQuality::Medium, Medium) \
+    X(EffectQuality::High, High)
+
+#define UEF_BITMAP_FORMAT_ENTRIES(X) \
+    X(BitmapFormat::A8_UNORM, A8_UNORM) \
+    X(BitmapFormat::BGRA8_UNORM_SRGB, BGRA8_UNORM_SRGB)
+
+#define UEF_LOG_LEVEL_ENTRIES(X) \
+    X(LogLevel::Error, Error) \
+    X(LogLevel::Warning, Warning) \
+    X(LogLevel::Info, Info)
+
+#define UEF_CURSOR_ENTRIES(X) \
+    X(kCursor_Pointer, Pointer) \
+    X(kCursor_Cross, Cross) \
+    X(kCursor_Hand, Hand) \
+    X(kCursor_IBeam, IBeam) \
+    X(kCursor_Wait, Wait) \
+    X(kCursor_Help, Help) \
+    X(kCursor_EastResize, EastResize) \
+    X(kCursor_NorthResize, NorthResize) \
+    X(kCursor_NorthEastResize, NorthEastResize) \
+    X(kCursor_NorthWestResize, NorthWestResize) \
+    X(kCursor_SouthResize, SouthResize) \
+    X(kCursor_SouthEastResize, SouthEastResize) \
+    X(kCursor_SouthWestResize, SouthWestResize) \
+    X(kCursor_WestResize, WestResize) \
+    X(kCursor_NorthSouthResize, NorthSouthResize) \
+    X(kCursor_EastWestResize, EastWestResize) \
+    X(kCursor_NorthEastSouthWestResize, NorthEastSouthWestResize) \
+    X(kCursor_NorthWestSouthEastResize, NorthWestSouthEastResize) \
+    X(kCursor_ColumnResize, ColumnResize) \
+    X(kCursor_RowResize, RowResize) \
+    X(kCursor_MiddlePanning, MiddlePanning) \
+    X(kCursor_EastPanning, EastPanning) \
+    X(kCursor_NorthPanning, NorthPanning) \
+    X(kCursor_NorthEastPanning, NorthEastPanning) \
+    X(kCursor_NorthWestPanning, NorthWestPanning) \
+    X(kCursor_SouthPanning, SouthPanning) \
+    X(kCursor_SouthEastPanning, SouthEastPanning) \
+    X(kCursor_SouthWestPanning, SouthWestPanning) \
+    X(kCursor_WestPanning, WestPanning) \
+    X(kCursor_Move, Move) \
+    X(kCursor_VerticalText, VerticalText) \
+    X(kCursor_Cell, Cell) \
+    X(kCursor_ContextMenu, ContextMenu) \
+    X(kCursor_Alias, Alias) \
+    X(kCursor_Progress, Progress) \
+    X(kCursor_NoDrop, NoDrop) \
+    X(kCursor_Copy, Copy) \
+    X(kCursor_None, None) \
+    X(kCursor_NotAllowed, NotAllowed) \
+    X(kCursor_ZoomIn, ZoomIn) \
+    X(kCursor_ZoomOut, ZoomOut) \
+    X(kCursor_Grab, Grab) \
+    X(kCursor_Grabbing, Grabbing) \
+    X(kCursor_Custom, Custom)
+
+#define UEF_MESSAGE_SOURCE_ENTRIES(X) \
+    X(kMessageSource_XML, XML) \
+    X(kMessageSource_JS, JS) \
+    X(kMessageSource_Network, Network) \
+    X(kMessageSource_ConsoleAPI, ConsoleAPI) \
+    X(kMessageSource_Storage, Storage) \
+    X(kMessageSource_AppCache, AppCache) \
+    X(kMessageSource_Rendering, Rendering) \
+    X(kMessageSource_CSS, CSS) \
+    X(kMessageSource_Security, Security) \
+    X(kMessageSource_ContentBlocker, ContentBlocker) \
+    X(kMessageSource_Media, Media) \
+    X(kMessageSource_MediaSource, MediaSource) \
+    X(kMessageSource_WebRTC, WebRTC) \
+    X(kMessageSource_ITPDebug, ITPDebug) \
+    X(kMessageSource_PrivateClickMeasurement, PrivateClickMeasurement) \
+    X(kMessageSource_PaymentRequest, PaymentRequest) \
+    X(kMessageSource_Other, Other)
+
+#define UEF_MESSAGE_LEVEL_ENTRIES(X) \
+    X(kMessageLevel_Log, Log) \
+    X(kMessageLevel_Warning, Warning) \
+    X(kMessageLevel_Error, Error) \
+    X(kMessageLevel_Debug, Debug) \
+    X(kMessageLevel_Info, Info)
+
+UEF_DEFINE_ENUM_MAPPING(FaceWinding, "FaceWinding", UEF_FACE_WINDING_ENTRIES, FaceWinding::CounterClockwise);
+UEF_DEFINE_ENUM_MAPPING(FontHinting, "FontHinting", UEF_FONT_HINTING_ENTRIES, FontHinting::Normal);
+UEF_DEFINE_ENUM_MAPPING(EffectQuality, "EffectQuality", UEF_EFFECT_QUALITY_ENTRIES, EffectQuality::Medium);
+UEF_DEFINE_ENUM_MAPPING(BitmapFormat, "BitmapFormat", UEF_BITMAP_FORMAT_ENTRIES, BitmapFormat::BGRA8_UNORM_SRGB);
+UEF_DEFINE_ENUM_MAPPING(LogLevel, "LogLevel", UEF_LOG_LEVEL_ENTRIES, LogLevel::Info);
+UEF_DEFINE_ENUM_MAPPING(Cursor, "Cursor", UEF_CURSOR_ENTRIES, kCursor_Pointer);
+UEF_DEFINE_ENUM_MAPPING(MessageSource, "MessageSource", UEF_MESSAGE_SOURCE_ENTRIES, kMessageSource_Other);
+UEF_DEFINE_ENUM_MAPPING(MessageLevel, "MessageLevel", UEF_MESSAGE_LEVEL_ENTRIES, kMessageLevel_Log);
+
+UEF_ASSERT_ENUM_MAPPING(FaceWinding, FaceWinding::CounterClockwise);
+UEF_ASSERT_ENUM_MAPPING(FontHinting, FontHinting::None);
+UEF_ASSERT_ENUM_MAPPING(EffectQuality, EffectQuality::High);
+UEF_ASSERT_ENUM_MAPPING(BitmapFormat, BitmapFormat::BGRA8_UNORM_SRGB);
+UEF_ASSERT_ENUM_MAPPING(LogLevel, LogLevel::Info);
+UEF_ASSERT_ENUM_MAPPING(Cursor, kCursor_Custom);
+UEF_ASSERT_ENUM_MAPPING(MessageSource, kMessageSource_Other);
+UEF_ASSERT_ENUM_MAPPING(MessageLevel, kMessageLevel_Info);
+
+template <typename T>
+constexpr T ConvertOrdinalToCpp(jint ordinal) {
+    using Mapping = EnumMapping<T>;
+    return ordinal >= 0 && static_cast<size_t>(ordinal) < Mapping::count ? Mapping::values[ordinal] : Mapping::fallback;
+}
+
+template <typename T>
+T ConvertJavaEnumToCpp(JNIEnv *env, jobject javaEnum) {
+    if (!javaEnum) {
+        return EnumMapping<T>::fallback;
+    }
+    return ConvertOrdinalToCpp<T>(env->GetIntField(javaEnum, JniRegistry::enumOrdinal_));
+}
+
+bool LoadEnumMappings(JNIEnv *env);
+
+#endif //ENUMMAPPING_HPP
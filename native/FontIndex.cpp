@@ -0,0 +1,512 @@
+#include "FontIndex.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+static constexpr char kIndexMagic[8] = {'U', 'E', 'F', 'F', 'O', 'N', 'T', 'S'};
+// Bump whenever parsing changes what a face records, so older indexes are rebuilt.
+static constexpr uint32_t kIndexVersion = 1;
+// A face with empty strings and no coverage pages still takes this much.
+static constexpr size_t kMinFaceBytes = 35;
+
+static constexpr uint32_t Tag(const char (&tag)[5]) {
+    return static_cast<uint32_t>(tag[0]) << 24 | static_cast<uint32_t>(tag[1]) << 16
+        | static_cast<uint32_t>(tag[2]) << 8 | static_cast<uint32_t>(tag[3]);
+}
+
+static uint16_t ReadU16(const uint8_t *data) {
+    return static_cast<uint16_t>(data[0] << 8 | data[1]);
+}
+
+static uint32_t ReadU32(const uint8_t *data) {
+    return static_cast<uint32_t>(data[0]) << 24 | static_cast<uint32_t>(data[1]) << 16
+        | static_cast<uint32_t>(data[2]) << 8 | static_cast<uint32_t>(data[3]);
+}
+
+static int CountBits(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#else
+    int count = 0;
+    for (; value; value &= value - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+bool FontCoverage::contains(uint32_t codepoint) const {
+    auto page = std::lower_bound(pages_.begin(), pages_.end(), static_cast<uint16_t>(codepoint >> 8));
+    if (codepoint >= kBits || page == pages_.end() || *page != codepoint >> 8) {
+        return false;
+    }
+    const Mask &mask = masks_[page - pages_.begin()];
+    return (mask[(codepoint >> 6) & 3] >> (codepoint & 63)) & 1;
+}
+
+FontCoverage FontCoverage::fromBits(const std::vector<uint64_t> &bits) {
+    FontCoverage coverage;
+    for (uint32_t page = 0; page < kBits / 256; page++) {
+        Mask mask = {bits[page * 4], bits[page * 4 + 1], bits[page * 4 + 2], bits[page * 4 + 3]};
+        if (mask[0] | mask[1] | mask[2] | mask[3]) {
+            coverage.pages_.push_back(static_cast<uint16_t>(page));
+            coverage.masks_.push_back(mask);
+            for (uint64_t word : mask) {
+                coverage.count_ += CountBits(word);
+            }
+        }
+    }
+    return coverage;
+}
+
+FontCoverage FontCoverage::fromPages(std::vector<uint16_t> pages, std::vector<Mask> masks) {
+    FontCoverage coverage;
+    coverage.pages_ = std::move(pages);
+    coverage.masks_ = std::move(masks);
+    for (const Mask &mask : coverage.masks_) {
+        for (uint64_t word : mask) {
+            coverage.count_ += CountBits(word);
+        }
+    }
+    return coverage;
+}
+
+static void SetBit(std::vector<uint64_t> &bits, uint32_t codepoint) {
+    bits[codepoint >> 6] |= 1ull << (codepoint & 63);
+}
+
+static void SetRange(std::vector<uint64_t> &bits, uint32_t first, uint32_t last) {
+    for (uint32_t codepoint = first; codepoint <= last;) {
+        if ((codepoint & 63) == 0 && last - codepoint >= 63) {
+            bits[codepoint >> 6] = ~0ull;
+            codepoint += 64;
+        } else {
+            SetBit(bits, codepoint++);
+        }
+    }
+}
+
+static void AppendUtf8(std::string &out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | codepoint >> 6);
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | codepoint >> 12);
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | codepoint >> 18);
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+// Name strings are UTF-16BE on the Unicode and Windows platforms, single bytes (Mac Roman, close
+// enough to Latin-1 for family names) on the Macintosh one.
+static std::string DecodeName(const uint8_t *data, size_t length, bool wide) {
+    std::string out;
+    if (!wide) {
+        for (size_t i = 0; i < length; i++) {
+            AppendUtf8(out, data[i]);
+        }
+        return out;
+    }
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        uint32_t unit = ReadU16(data + i);
+        if (unit >= 0xD800 && unit < 0xDC00 && i + 3 < length) {
+            uint32_t low = ReadU16(data + i + 2);
+            if (low >= 0xDC00 && low < 0xE000) {
+                AppendUtf8(out, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+                i += 2;
+                continue;
+            }
+        }
+        AppendUtf8(out, unit);
+    }
+    return out;
+}
+
+// Higher is better; English Windows names first, as that is what CSS font-family lists use.
+static int NameRank(uint16_t platform, uint16_t encoding, uint16_t language) {
+    if (platform == 3 && (encoding == 1 || encoding == 10)) {
+        return language == 0x0409 ? 3 : 1;
+    }
+    if (platform == 0 || (platform == 1 && encoding == 0 && language == 0)) {
+        return 2;
+    }
+    return -1;
+}
+
+void FontIndex::parseNames(const uint8_t *table, size_t size, FontFace &face) {
+    if (size < 6) {
+        return;
+    }
+    size_t count = std::min<size_t>(ReadU16(table + 2), (size - 6) / 12);
+    size_t strings = ReadU16(table + 4);
+
+    std::string typographic;
+    std::string legacy;
+    int typographicRank = -1;
+    int legacyRank = -1;
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *record = table + 6 + i * 12;
+        uint16_t platform = ReadU16(record);
+        uint16_t nameId = ReadU16(record + 6);
+        int rank = NameRank(platform, ReadU16(record + 2), ReadU16(record + 4));
+        int &best = nameId == 16 ? typographicRank : legacyRank;
+        if ((nameId != 1 && nameId != 16) || rank <= best) {
+            continue;
+        }
+
+        size_t length = ReadU16(record + 8);
+        size_t offset = strings + ReadU16(record + 10);
+        if (offset > size || length > size - offset) {
+            continue;
+        }
+        std::string name = DecodeName(table + offset, length, platform != 1);
+        if (!name.empty()) {
+            (nameId == 16 ? typographic : legacy) = std::move(name);
+            best = rank;
+        }
+    }
+
+    face.family = typographic.empty() ? legacy : typographic;
+    face.legacyFamily = legacy != face.family ? legacy : std::string();
+}
+
+static void ParseFormat4(const uint8_t *table, size_t size, std::vector<uint64_t> &bits) {
+    if (size < 14) {
+        return;
+    }
+    size_t segments = ReadU16(table + 6) / 2;
+    if (16 + segments * 8 > size) {
+        return;
+    }
+
+    const uint8_t *ends = table + 14;
+    const uint8_t *starts = ends + segments * 2 + 2;
+    const uint8_t *deltas = starts + segments * 2;
+    const uint8_t *rangeOffsets = deltas + segments * 2;
+    for (size_t segment = 0; segment < segments; segment++) {
+        uint32_t end = ReadU16(ends + segment * 2);
+        uint32_t start = ReadU16(starts + segment * 2);
+        uint16_t delta = ReadU16(deltas + segment * 2);
+        uint16_t rangeOffset = ReadU16(rangeOffsets + segment * 2);
+        if (start > end || start == 0xFFFF) {
+            continue;
+        }
+
+        for (uint32_t codepoint = start; codepoint <= end; codepoint++) {
+            uint16_t glyph;
+            if (rangeOffset == 0) {
+                glyph = static_cast<uint16_t>(codepoint + delta);
+            } else {
+                // Offsets are relative to the idRangeOffset entry itself, per the spec.
+                size_t at = static_cast<size_t>(rangeOffsets - table) + segment * 2 + rangeOffset + (codepoint - start) * 2;
+                if (at + 2 > size) {
+                    break;
+                }
+                glyph = ReadU16(table + at);
+                glyph = glyph ? static_cast<uint16_t>(glyph + delta) : 0;
+            }
+            if (glyph) {
+                SetBit(bits, codepoint);
+            }
+        }
+    }
+}
+
+static void ParseFormat12(const uint8_t *table, size_t size, std::vector<uint64_t> &bits) {
+    if (size < 16) {
+        return;
+    }
+    size_t groups = std::min<size_t>(ReadU32(table + 12), (size - 16) / 12);
+    for (size_t i = 0; i < groups; i++) {
+        const uint8_t *group = table + 16 + i * 12;
+        uint32_t start = ReadU32(group);
+        uint32_t end = std::min(ReadU32(group + 4), FontCoverage::kBits - 1);
+        // Only the group's first codepoint can land on .notdef.
+        if (ReadU32(group + 8) == 0) {
+            start++;
+        }
+        if (start <= end) {
+            SetRange(bits, start, end);
+        }
+    }
+}
+
+void FontIndex::parseCoverage(const uint8_t *table, size_t size, std::vector<uint64_t> &bits) {
+    if (size < 4) {
+        return;
+    }
+    size_t count = std::min<size_t>(ReadU16(table + 2), (size - 4) / 8);
+
+    // Prefer a full-Unicode format 12 subtable, then a BMP format 4 one; anything else is ignored.
+    size_t best = 0;
+    int bestRank = 0;
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *record = table + 4 + i * 8;
+        uint16_t platform = ReadU16(record);
+        uint16_t encoding = ReadU16(record + 2);
+        size_t offset = ReadU32(record + 4);
+        if (offset + 2 > size) {
+            continue;
+        }
+        uint16_t format = ReadU16(table + offset);
+        bool unicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+        int rank = format == 12 ? (unicode ? 4 : 2) : format == 4 ? (unicode ? 3 : 1) : 0;
+        if (rank > bestRank) {
+            best = offset;
+            bestRank = rank;
+        }
+    }
+
+    if (bestRank == 0) {
+        return;
+    }
+    if (ReadU16(table + best) == 12) {
+        ParseFormat12(table + best, size - best, bits);
+    } else {
+        ParseFormat4(table + best, size - best, bits);
+    }
+}
+
+bool FontIndex::parse(const uint8_t *data, size_t size, FontFace &face) {
+    if (size < 12) {
+        return false;
+    }
+
+    size_t directory = 0;
+    uint32_t version = ReadU32(data);
+    if (version == Tag("ttcf")) {
+        if (size < 16 || ReadU32(data + 8) == 0) {
+            return false;
+        }
+        directory = ReadU32(data + 12);
+        if (directory > size - 12) {
+            return false;
+        }
+        version = ReadU32(data + directory);
+    }
+    if (version != 0x00010000 && version != Tag("OTTO") && version != Tag("true")) {
+        return false;
+    }
+
+    size_t tables = ReadU16(data + directory + 4);
+    if (tables > (size - directory - 12) / 16) {
+        return false;
+    }
+
+    const uint8_t *cmap = nullptr, *name = nullptr, *os2 = nullptr, *head = nullptr;
+    size_t cmapSize = 0, nameSize = 0, os2Size = 0, headSize = 0;
+    for (size_t i = 0; i < tables; i++) {
+        const uint8_t *record = data + directory + 12 + i * 16;
+        uint32_t tag = ReadU32(record);
+        size_t offset = ReadU32(record + 8);
+        size_t length = ReadU32(record + 12);
+        if (offset > size || length > size - offset) {
+            continue;
+        }
+        if (tag == Tag("cmap")) {
+            cmap = data + offset, cmapSize = length;
+        } else if (tag == Tag("name")) {
+            name = data + offset, nameSize = length;
+        } else if (tag == Tag("OS/2")) {
+            os2 = data + offset, os2Size = length;
+        } else if (tag == Tag("head")) {
+            head = data + offset, headSize = length;
+        }
+    }
+    if (!cmap || !name) {
+        return false;
+    }
+
+    face.weight = 400;
+    face.italic = false;
+    if (head && headSize >= 54) {
+        uint16_t macStyle = ReadU16(head + 44);
+        face.weight = macStyle & 1 ? 700 : 400;
+        face.italic = macStyle & 2;
+    }
+    if (os2 && os2Size >= 64) {
+        uint16_t weight = ReadU16(os2 + 4);
+        // A few old fonts use the 1-9 scale.
+        weight = weight > 0 && weight < 10 ? static_cast<uint16_t>(weight * 100) : weight;
+        if (weight >= 1 && weight <= 1000) {
+            face.weight = weight;
+        }
+        uint16_t selection = ReadU16(os2 + 62);
+        face.italic = selection & (1 | 1 << 9);
+    }
+
+    parseNames(name, nameSize, face);
+    if (face.family.empty()) {
+        return false;
+    }
+
+    std::vector<uint64_t> bits(FontCoverage::kBits / 64);
+    parseCoverage(cmap, cmapSize, bits);
+    face.coverage = FontCoverage::fromBits(bits);
+    return face.coverage.count() > 0;
+}
+
+/**
+ * The persisted index: the magic, version and face count, then per face its path, modification time,
+ * size, names, style and coverage pages, all in native byte order since it never leaves the machine.
+ */
+class IndexWriter {
+public:
+    template <typename T>
+    void value(T value) { bytes(&value, sizeof(value)); }
+
+    void bytes(const void *data, size_t size) {
+        if (size) {
+            out_.append(static_cast<const char *>(data), size);
+        }
+    }
+
+    void string(const std::string &value) {
+        this->value<uint32_t>(static_cast<uint32_t>(value.size()));
+        bytes(value.data(), value.size());
+    }
+
+    const std::string &data() const { return out_; }
+
+private:
+    std::string out_;
+};
+
+class IndexReader {
+public:
+    IndexReader(const char *data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    T value() {
+        T value{};
+        bytes(&value, sizeof(value));
+        return value;
+    }
+
+    void bytes(void *out, size_t size) {
+        if (!size) {
+            return;
+        }
+        if (size > size_ - offset_) {
+            ok_ = false;
+            offset_ = size_;
+            return;
+        }
+        memcpy(out, data_ + offset_, size);
+        offset_ += size;
+    }
+
+    std::string string() {
+        auto length = value<uint32_t>();
+        if (length > size_ - offset_) {
+            ok_ = false;
+            return std::string();
+        }
+        std::string value(data_ + offset_, length);
+        offset_ += length;
+        return value;
+    }
+
+    // Guards counts read from the file before anything is allocated for them.
+    bool fits(size_t count, size_t each) const { return ok_ && count <= (size_ - offset_) / each; }
+    bool ok() const { return ok_; }
+
+private:
+    const char *data_;
+    size_t size_;
+    size_t offset_ = 0;
+    bool ok_ = true;
+};
+
+bool FontIndex::read(const fs::path &file, std::vector<FontFace> &faces) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    IndexReader reader(data.data(), data.size());
+
+    char magic[sizeof(kIndexMagic)];
+    reader.bytes(magic, sizeof(magic));
+    if (!reader.ok() || memcmp(magic, kIndexMagic, sizeof(magic)) != 0 || reader.value<uint32_t>() != kIndexVersion) {
+        return false;
+    }
+
+    auto count = reader.value<uint32_t>();
+    if (!reader.fits(count, kMinFaceBytes)) {
+        return false;
+    }
+    std::vector<FontFace> result(count);
+    for (FontFace &face : result) {
+        face.path = reader.string();
+        face.modified = reader.value<int64_t>();
+        face.size = reader.value<uint64_t>();
+        face.family = reader.string();
+        face.legacyFamily = reader.string();
+        face.weight = reader.value<uint16_t>();
+        face.italic = reader.value<uint8_t>() != 0;
+
+        auto pages = reader.value<uint32_t>();
+        if (!reader.fits(pages, sizeof(uint16_t) + sizeof(FontCoverage::Mask))) {
+            return false;
+        }
+        std::vector<uint16_t> pageList(pages);
+        std::vector<FontCoverage::Mask> masks(pages);
+        reader.bytes(pageList.data(), pages * sizeof(uint16_t));
+        reader.bytes(masks.data(), pages * sizeof(FontCoverage::Mask));
+        if (!reader.ok() || !std::is_sorted(pageList.begin(), pageList.end())
+            || (pages && pageList.back() >= FontCoverage::kBits / 256)) {
+            return false;
+        }
+        face.coverage = FontCoverage::fromPages(std::move(pageList), std::move(masks));
+    }
+
+    faces = std::move(result);
+    return true;
+}
+
+bool FontIndex::write(const fs::path &file, const std::vector<FontFace> &faces) {
+    IndexWriter writer;
+    writer.bytes(kIndexMagic, sizeof(kIndexMagic));
+    writer.value<uint32_t>(kIndexVersion);
+    writer.value<uint32_t>(static_cast<uint32_t>(faces.size()));
+    for (const FontFace &face : faces) {
+        writer.string(face.path);
+        writer.value<int64_t>(face.modified);
+        writer.value<uint64_t>(face.size);
+        writer.string(face.family);
+        writer.string(face.legacyFamily);
+        writer.value<uint16_t>(face.weight);
+        writer.value<uint8_t>(face.italic ? 1 : 0);
+        const auto &pages = face.coverage.pages();
+        writer.value<uint32_t>(static_cast<uint32_t>(pages.size()));
+        writer.bytes(pages.data(), pages.size() * sizeof(uint16_t));
+        writer.bytes(face.coverage.masks().data(), pages.size() * sizeof(FontCoverage::Mask));
+    }
+
+    // Written aside and renamed over the old index, so a crash never leaves half an index behind.
+    fs::path temporary = file;
+    temporary += ".tmp";
+    std::error_code error;
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.write(writer.data().data(), static_cast<std::streamsize>(writer.data().size()))) {
+            out.close();
+            fs::remove(temporary, error);
+            return false;
+        }
+    }
+    fs::rename(temporary, file, error);
+    return !error;
+}
@@ -0,0 +1,67 @@
+#ifndef FONTINDEX_HPP
+#define FONTINDEX_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * The codepoints a face maps to glyphs, kept as the 256-codepoint pages it touches (sorted) and one
+ * 256-bit mask per page. A Latin font is a handful of pages, a CJK one a few hundred; a lookup is a
+ * binary search over the pages and one bit test.
+ */
+class FontCoverage {
+public:
+    using Mask = std::array<uint64_t, 4>;
+
+    bool contains(uint32_t codepoint) const;
+    // Codepoints covered in total.
+    uint32_t count() const { return count_; }
+
+    const std::vector<uint16_t> &pages() const { return pages_; }
+    const std::vector<Mask> &masks() const { return masks_; }
+
+    // Compresses a dense bitset of all of Unicode, kBits bits.
+    static constexpr uint32_t kBits = 0x110000;
+    static FontCoverage fromBits(const std::vector<uint64_t> &bits);
+    static FontCoverage fromPages(std::vector<uint16_t> pages, std::vector<Mask> masks);
+
+private:
+    std::vector<uint16_t> pages_;
+    std::vector<Mask> masks_;
+    uint32_t count_ = 0;
+};
+
+// One indexed font file. Only the first face of a collection is indexed, as FontFile has no way to
+// pick another.
+struct FontFace {
+    std::string path;
+    int64_t modified = 0;
+    uint64_t size = 0;
+
+    // The typographic family (name ID 16) when the font has one, and the legacy family (ID 1) if it differs.
+    std::string family;
+    std::string legacyFamily;
+    uint16_t weight = 400;
+    bool italic = false;
+    FontCoverage coverage;
+};
+
+class FontIndex {
+public:
+    // Reads the names, style and cmap of an OpenType/TrueType file or collection; false if it is not one.
+    static bool parse(const uint8_t *data, size_t size, FontFace &face);
+
+    // The index persisted between runs, see UefFontLoader. Both return false rather than throwing.
+    static bool read(const std::filesystem::path &file, std::vector<FontFace> &faces);
+    static bool write(const std::filesystem::path &file, const std::vector<FontFace> &faces);
+
+private:
+    static void parseNames(const uint8_t *table, size_t size, FontFace &face);
+    static void parseCoverage(const uint8_t *table, size_t size, std::vector<uint64_t> &bits);
+};
+
+#endif //FONTINDEX_HPP
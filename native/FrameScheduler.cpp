@@ -0,0 +1,101 @@
+#include "FrameScheduler.hpp"
+#include "DisplayClock.hpp"
+#include "EnumMapping.hpp"
+#include "UefRenderer.hpp"
+#include "UefView.hpp"
+#include "ViewHibernator.hpp"
+#include "ViewRegistry.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+uint64_t FrameScheduler::budgetNanos_ = 8000000;
+uint32_t FrameScheduler::starvationFrames_ = 30;
+double FrameScheduler::nanosPerPixel_ = 0.0;
+std::vector<FrameScheduler::Candidate> FrameScheduler::candidates_;
+std::vector<View *> FrameScheduler::batch_;
+FrameSchedulerStats FrameScheduler::stats_;
+
+void FrameScheduler::configure(double budgetMillis, uint32_t starvationFrames) {
+    budgetNanos_ = budgetMillis > 0 ? static_cast<uint64_t>(budgetMillis * 1000000.0) : 0;
+    starvationFrames_ = starvationFrames;
+}
+
+void FrameScheduler::renderFrame() {
+    ViewRegistry::drainReleases();
+    ViewHibernator::pump();
+
+    candidates_.clear();
+    ViewRegistry::forEach([](jlong handle, ViewSlot &slot) {
+        if (slot.priority == ViewPriority::Hidden || !slot.view->needs_paint()) {
+            return;
+        }
+
+        auto rank = static_cast<uint32_t>(slot.priority);
+        if (slot.priority == ViewPriority::Background && starvationFrames_ && slot.deferredFrames >= starvationFrames_) {
+            rank = static_cast<uint32_t>(ViewPriority::Visible);
+        }
+        double area = static_cast<double>(slot.view->width()) * slot.view->height();
+        candidates_.push_back(Candidate{slot.view.get(), &slot, rank, area * nanosPerPixel_});
+    });
+
+    // Within a rank the View that has waited longest goes first.
+    std::sort(candidates_.begin(), candidates_.end(), [](const Candidate &a, const Candidate &b) {
+        return a.rank != b.rank ? a.rank < b.rank : a.slot->deferredFrames > b.slot->deferredFrames;
+    });
+
+    batch_.clear();
+    double planned = 0;
+    double area = 0;
+    for (Candidate &candidate : candidates_) {
+        // The first View is always taken so an undersized budget still makes progress.
+        bool fits = batch_.empty() || budgetNanos_ == 0 || planned + candidate.cost <= static_cast<double>(budgetNanos_);
+        if (candidate.slot->priority == ViewPriority::Focused || fits) {
+            batch_.push_back(candidate.view);
+            planned += candidate.cost;
+            area += static_cast<double>(candidate.view->width()) * candidate.view->height();
+            candidate.slot->deferredFrames = 0;
+        } else {
+            candidate.slot->deferredFrames++;
+        }
+    }
+
+    stats_.painted = static_cast<uint32_t>(batch_.size());
+    stats_.deferred = static_cast<uint32_t>(candidates_.size() - batch_.size());
+    stats_.elapsedNanos = 0;
+    if (batch_.empty()) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    UefRenderer::renderer_->RenderOnly(batch_.data(), batch_.size());
+    stats_.elapsedNanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    if (area > 0) {
+        double sample = static_cast<double>(stats_.elapsedNanos) / area;
+        nanosPerPixel_ = nanosPerPixel_ == 0.0 ? sample : nanosPerPixel_ * 0.8 + sample * 0.2;
+    }
+}
+
+void Java_net_rk4z_juef_UefRenderer_setFrameBudget(JNIEnv *env, jclass obj, jdouble budgetMillis, jint starvationFrames) {
+    FrameScheduler::configure(budgetMillis, starvationFrames > 0 ? static_cast<uint32_t>(starvationFrames) : 0);
+}
+
+jint Java_net_rk4z_juef_UefRenderer_renderFrame(JNIEnv *env, jclass obj) {
+    FrameScheduler::renderFrame();
+    return static_cast<jint>(FrameScheduler::stats().painted);
+}
+
+void Java_net_rk4z_juef_UefView_setPriority(JNIEnv *env, jclass obj, jlong handle, jobject priority) {
+    View *view = UefView::lookup(env, handle);
+    if (!view) {
+        return;
+    }
+
+    ViewSlot *slot = ViewRegistry::slot(handle);
+    slot->priority = ConvertJavaEnumToCpp<ViewPriority>(env, priority);
+    slot->deferredFrames = 0;
+    ViewHibernator::priorityChanged(*slot);
+    DisplayClock::wake(view->display_id());
+}
@@ -0,0 +1,79 @@
+#ifndef FRAMESCHEDULER_HPP
+#define FRAMESCHEDULER_HPP
+
+#include <jni.h>
+#include <cstdint>
+#include <vector>
+#include <Ultralight/View.h>
+#include "EnumMapping.hpp"
+
+using namespace ultralight;
+
+struct ViewSlot;
+
+enum class ViewPriority : uint8_t {
+    Focused,
+    Visible,
+    Background,
+    Hidden,
+};
+
+#define UEF_VIEW_PRIORITY_ENTRIES(X) \
+    X(ViewPriority::Focused, Focused) \
+    X(ViewPriority::Visible, Visible) \
+    X(ViewPriority::Background, Background) \
+    X(ViewPriority::Hidden, Hidden)
+
+UEF_DEFINE_ENUM_MAPPING(ViewPriority, "ViewPriority", UEF_VIEW_PRIORITY_ENTRIES, ViewPriority::Visible);
+UEF_ASSERT_ENUM_MAPPING(ViewPriority, ViewPriority::Hidden);
+
+struct FrameSchedulerStats {
+    uint32_t painted = 0;
+    uint32_t deferred = 0;
+    uint64_t elapsedNanos = 0;
+};
+
+/**
+ * Decides which Views are painted each frame and paints them with a single Renderer::RenderOnly.
+ *
+ * Only Views that report needs_paint() are considered, so idle Views cost one virtual call. Focused
+ * Views are always painted; the rest are taken in priority order while their estimated cost fits in
+ * the frame budget. A Background View that has been deferred for starvationFrames frames is ranked
+ * like a Visible one until it is painted. Hidden Views are never painted and keep their damage until
+ * their priority changes.
+ *
+ * RenderOnly paints the whole batch in one call, so cost is estimated per pixel: the measured batch
+ * time divided by the batch's total area, smoothed across frames.
+ */
+class FrameScheduler {
+public:
+    static void configure(double budgetMillis, uint32_t starvationFrames);
+    static void renderFrame();
+
+    static const FrameSchedulerStats &stats() { return stats_; }
+
+private:
+    struct Candidate {
+        View *view;
+        ViewSlot *slot;
+        uint32_t rank;
+        double cost;
+    };
+
+    static uint64_t budgetNanos_;
+    static uint32_t starvationFrames_;
+    static double nanosPerPixel_;
+    static std::vector<Candidate> candidates_;
+    static std::vector<View *> batch_;
+    static FrameSchedulerStats stats_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_setFrameBudget(JNIEnv *env, jclass obj, jdouble budgetMillis, jint starvationFrames);
+
+    JNIEXPORT jint JNICALL Java_net_rk4z_juef_UefRenderer_renderFrame(JNIEnv *env, jclass obj);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_setPriority(JNIEnv *env, jclass obj, jlong handle, jobject priority);
+}
+
+#endif //FRAMESCHEDULER_HPP
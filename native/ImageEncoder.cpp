@@ -0,0 +1,354 @@
+#include "ImageEncoder.hpp"
+#include "EnumMapping.hpp"
+#include "JniRegistry.hpp"
+#include "PixelConvert.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <zlib.h>
+
+static constexpr uint32_t kPngStripRows = 64;
+static constexpr uint32_t kQoiHeaderSize = 14;
+static constexpr uint8_t kQoiPadding[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+static void WriteBigEndian(uint8_t *out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+}
+
+static uint32_t ReadBigEndian(const uint8_t *in) {
+    return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16)
+        | (static_cast<uint32_t>(in[2]) << 8) | in[3];
+}
+
+NativeBlob *ImageEncoder::encode(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes, ImageFormat format) {
+    switch (format) {
+        case ImageFormat::Raw:
+            return encodeRaw(pixels, width, height, rowBytes);
+        case ImageFormat::Png:
+            return encodePng(pixels, width, height, rowBytes);
+        case ImageFormat::Qoi:
+            return encodeQoi(pixels, width, height, rowBytes);
+    }
+    return nullptr;
+}
+
+NativeBlob *ImageEncoder::encodeRaw(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes) {
+    auto blob = new HeapBlob(static_cast<size_t>(width) * height * 4);
+    if (!blob->data) {
+        delete blob;
+        return nullptr;
+    }
+    PixelConvert::convert(pixels, rowBytes, static_cast<uint8_t *>(blob->data), static_cast<size_t>(width) * 4,
+                          width, height, PixelFormat::IntArgbPre);
+    return blob;
+}
+
+struct PngStrip {
+    std::vector<uint8_t> data;
+    uLong adler = 1;
+    uLong crc = 0;
+    size_t rawLength = 0;
+    bool ok = false;
+};
+
+static void DeflateStrip(const uint8_t *pixels, uint32_t width, size_t rowBytes, uint32_t first, uint32_t last,
+                         bool finalStrip, int level, PngStrip &strip) {
+    size_t pixelBytes = static_cast<size_t>(width) * 4;
+    std::vector<uint8_t> previous(pixelBytes, 0);
+    std::vector<uint8_t> current(pixelBytes);
+    std::vector<uint8_t> filtered(pixelBytes + 1);
+
+    // The Up filter needs the row above the strip, which another strip owns; convert it again here.
+    if (first > 0) {
+        PixelConvert::convert(pixels + (first - 1) * rowBytes, rowBytes, previous.data(), pixelBytes, width, 1, PixelFormat::Rgba);
+    }
+
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return;
+    }
+
+    strip.rawLength = filtered.size() * (last - first);
+    strip.data.resize(deflateBound(&stream, static_cast<uLong>(strip.rawLength)) + 16);
+    stream.next_out = strip.data.data();
+    stream.avail_out = static_cast<uInt>(strip.data.size());
+
+    int result = Z_OK;
+    for (uint32_t y = first; y < last && result != Z_STREAM_ERROR; y++) {
+        PixelConvert::convert(pixels + y * rowBytes, rowBytes, current.data(), pixelBytes, width, 1, PixelFormat::Rgba);
+        filtered[0] = 2;
+        for (size_t i = 0; i < pixelBytes; i++) {
+            filtered[i + 1] = static_cast<uint8_t>(current[i] - previous[i]);
+        }
+        current.swap(previous);
+        strip.adler = adler32(strip.adler, filtered.data(), static_cast<uInt>(filtered.size()));
+
+        // Non-final strips end with an empty stored block so the next strip starts on a byte boundary.
+        int flush = y + 1 < last ? Z_NO_FLUSH : (finalStrip ? Z_FINISH : Z_SYNC_FLUSH);
+        stream.next_in = filtered.data();
+        stream.avail_in = static_cast<uInt>(filtered.size());
+        do {
+            if (stream.avail_out == 0) {
+                size_t used = strip.data.size();
+                strip.data.resize(used * 2);
+                stream.next_out = strip.data.data() + used;
+                stream.avail_out = static_cast<uInt>(strip.data.size() - used);
+            }
+            result = deflate(&stream, flush);
+        } while (result != Z_STREAM_ERROR && (stream.avail_in > 0 || stream.avail_out == 0) && result != Z_STREAM_END);
+    }
+
+    strip.data.resize(stream.total_out);
+    deflateEnd(&stream);
+    strip.crc = crc32(0, strip.data.data(), static_cast<uInt>(strip.data.size()));
+    strip.ok = result != Z_STREAM_ERROR && (!finalStrip || result == Z_STREAM_END);
+}
+
+NativeBlob *ImageEncoder::encodePng(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes, int level) {
+    if (width == 0 || height == 0) {
+        return nullptr;
+    }
+
+    WorkerPool &pool = WorkerPool::shared();
+    uint32_t stripRows = std::max(kPngStripRows, (height + pool.size()) / (pool.size() + 1));
+    size_t stripCount = (height + stripRows - 1) / stripRows;
+    std::vector<PngStrip> strips(stripCount);
+
+    pool.parallelFor(stripCount, [&](size_t index) {
+        auto first = static_cast<uint32_t>(index * stripRows);
+        uint32_t last = std::min(height, first + stripRows);
+        DeflateStrip(pixels, width, rowBytes, first, last, index + 1 == stripCount, level, strips[index]);
+    });
+
+    size_t compressed = 0;
+    uLong adler = 1;
+    for (const PngStrip &strip : strips) {
+        if (!strip.ok) {
+            return nullptr;
+        }
+        compressed += strip.data.size();
+        adler = adler32_combine(adler, strip.adler, static_cast<z_off_t>(strip.rawLength));
+    }
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    static const uint8_t zlibHeader[2] = {0x78, 0x9C};
+    size_t idatLength = sizeof(zlibHeader) + compressed + 4;
+    size_t total = sizeof(signature) + (12 + 13) + (12 + idatLength) + 12;
+    if (idatLength > 0x7FFFFFFF) {
+        return nullptr;
+    }
+
+    auto blob = new HeapBlob(total);
+    auto out = static_cast<uint8_t *>(blob->data);
+    if (!out) {
+        delete blob;
+        return nullptr;
+    }
+
+    memcpy(out, signature, sizeof(signature));
+    out += sizeof(signature);
+
+    WriteBigEndian(out, 13);
+    memcpy(out + 4, "IHDR", 4);
+    WriteBigEndian(out + 8, width);
+    WriteBigEndian(out + 12, height);
+    const uint8_t format[5] = {8, 6, 0, 0, 0};
+    memcpy(out + 16, format, sizeof(format));
+    WriteBigEndian(out + 21, static_cast<uint32_t>(crc32(0, out + 4, 17)));
+    out += 25;
+
+    WriteBigEndian(out, static_cast<uint32_t>(idatLength));
+    memcpy(out + 4, "IDAT", 4);
+    uLong crc = crc32(0, out + 4, 4);
+    out += 8;
+    memcpy(out, zlibHeader, sizeof(zlibHeader));
+    crc = crc32(crc, out, sizeof(zlibHeader));
+    out += sizeof(zlibHeader);
+    for (const PngStrip &strip : strips) {
+        memcpy(out, strip.data.data(), strip.data.size());
+        out += strip.data.size();
+        crc = crc32_combine(crc, strip.crc, static_cast<z_off_t>(strip.data.size()));
+    }
+    WriteBigEndian(out, static_cast<uint32_t>(adler));
+    crc = crc32(crc, out, 4);
+    WriteBigEndian(out + 4, static_cast<uint32_t>(crc));
+    out += 8;
+
+    WriteBigEndian(out, 0);
+    memcpy(out + 4, "IEND", 4);
+    WriteBigEndian(out + 8, static_cast<uint32_t>(crc32(0, out + 4, 4)));
+    return blob;
+}
+
+static inline uint32_t QoiHash(const uint8_t *pixel) {
+    return (pixel[0] * 3u + pixel[1] * 5u + pixel[2] * 7u + pixel[3] * 11u) % 64u;
+}
+
+NativeBlob *ImageEncoder::encodeQoi(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes) {
+    size_t maxSize = static_cast<size_t>(width) * height * 5 + kQoiHeaderSize + sizeof(kQoiPadding);
+    std::vector<uint8_t> buffer(maxSize);
+    uint8_t *out = buffer.data();
+
+    memcpy(out, "qoif", 4);
+    WriteBigEndian(out + 4, width);
+    WriteBigEndian(out + 8, height);
+    out[12] = 4;
+    out[13] = 0;
+    out += kQoiHeaderSize;
+
+    uint8_t index[64][4] = {};
+    uint8_t previous[4] = {0, 0, 0, 255};
+    uint32_t run = 0;
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *pixel = pixels + y * rowBytes;
+        for (uint32_t x = 0; x < width; x++, pixel += 4) {
+            if (memcmp(pixel, previous, 4) == 0) {
+                if (++run == 62) {
+                    *out++ = static_cast<uint8_t>(0xC0 | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run) {
+                *out++ = static_cast<uint8_t>(0xC0 | (run - 1));
+                run = 0;
+            }
+
+            uint32_t hash = QoiHash(pixel);
+            if (memcmp(index[hash], pixel, 4) == 0) {
+                *out++ = static_cast<uint8_t>(hash);
+            } else {
+                memcpy(index[hash], pixel, 4);
+                if (pixel[3] == previous[3]) {
+                    auto dr = static_cast<int8_t>(pixel[0] - previous[0]);
+                    auto dg = static_cast<int8_t>(pixel[1] - previous[1]);
+                    auto db = static_cast<int8_t>(pixel[2] - previous[2]);
+                    int drg = dr - dg;
+                    int dbg = db - dg;
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        *out++ = static_cast<uint8_t>(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+                    } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                        *out++ = static_cast<uint8_t>(0x80 | (dg + 32));
+                        *out++ = static_cast<uint8_t>(((drg + 8) << 4) | (dbg + 8));
+                    } else {
+                        *out++ = 0xFE;
+                        memcpy(out, pixel, 3);
+                        out += 3;
+                    }
+                } else {
+                    *out++ = 0xFF;
+                    memcpy(out, pixel, 4);
+                    out += 4;
+                }
+            }
+            memcpy(previous, pixel, 4);
+        }
+    }
+    if (run) {
+        *out++ = static_cast<uint8_t>(0xC0 | (run - 1));
+    }
+    memcpy(out, kQoiPadding, sizeof(kQoiPadding));
+    out += sizeof(kQoiPadding);
+
+    auto size = static_cast<size_t>(out - buffer.data());
+    auto blob = new HeapBlob(size);
+    if (!blob->data) {
+        delete blob;
+        return nullptr;
+    }
+    memcpy(blob->data, buffer.data(), size);
+    return blob;
+}
+
+bool ImageEncoder::readQoiHeader(const uint8_t *data, size_t size, uint32_t &width, uint32_t &height) {
+    if (size < kQoiHeaderSize + sizeof(kQoiPadding) || memcmp(data, "qoif", 4) != 0 || data[12] != 4) {
+        return false;
+    }
+    width = ReadBigEndian(data + 4);
+    height = ReadBigEndian(data + 8);
+    return true;
+}
+
+bool ImageEncoder::decodeQoi(const uint8_t *data, size_t size, uint8_t *pixels, size_t rowBytes) {
+    uint32_t width;
+    uint32_t height;
+    if (!readQoiHeader(data, size, width, height)) {
+        return false;
+    }
+
+    const uint8_t *in = data + kQoiHeaderSize;
+    const uint8_t *end = data + size - sizeof(kQoiPadding);
+    uint8_t index[64][4] = {};
+    uint8_t pixel[4] = {0, 0, 0, 255};
+    uint32_t run = 0;
+
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t *row = pixels + y * rowBytes;
+        for (uint32_t x = 0; x < width; x++, row += 4) {
+            if (run) {
+                run--;
+            } else if (in < end) {
+                uint8_t op = *in++;
+                if (op == 0xFE) {
+                    if (end - in < 3) {
+                        return false;
+                    }
+                    memcpy(pixel, in, 3);
+                    in += 3;
+                } else if (op == 0xFF) {
+                    if (end - in < 4) {
+                        return false;
+                    }
+                    memcpy(pixel, in, 4);
+                    in += 4;
+                } else if ((op & 0xC0) == 0x00) {
+                    memcpy(pixel, index[op], 4);
+                } else if ((op & 0xC0) == 0x40) {
+                    pixel[0] = static_cast<uint8_t>(pixel[0] + ((op >> 4) & 3) - 2);
+                    pixel[1] = static_cast<uint8_t>(pixel[1] + ((op >> 2) & 3) - 2);
+                    pixel[2] = static_cast<uint8_t>(pixel[2] + (op & 3) - 2);
+                } else if ((op & 0xC0) == 0x80) {
+                    if (in >= end) {
+                        return false;
+                    }
+                    uint8_t second = *in++;
+                    int dg = (op & 0x3F) - 32;
+                    pixel[0] = static_cast<uint8_t>(pixel[0] + dg - 8 + ((second >> 4) & 0x0F));
+                    pixel[1] = static_cast<uint8_t>(pixel[1] + dg);
+                    pixel[2] = static_cast<uint8_t>(pixel[2] + dg - 8 + (second & 0x0F));
+                } else {
+                    run = op & 0x3F;
+                }
+                memcpy(index[QoiHash(pixel)], pixel, 4);
+            } else {
+                return false;
+            }
+            memcpy(row, pixel, 4);
+        }
+    }
+    return true;
+}
+
+jlong Java_net_rk4z_juef_UefImageEncoder_encodeImage(JNIEnv *env, jclass obj, jobject pixels, jint rowBytes, jint width, jint height, jobject format) {
+    auto source = static_cast<const uint8_t *>(env->GetDirectBufferAddress(pixels));
+    int64_t needed = height > 0 ? static_cast<int64_t>(height - 1) * rowBytes + static_cast<int64_t>(width) * 4 : 0;
+    if (!source || width <= 0 || height <= 0 || static_cast<int64_t>(width) * 4 > rowBytes
+        || needed > env->GetDirectBufferCapacity(pixels)) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Pixels must be a direct ByteBuffer holding width x height BGRA pixels");
+        return 0;
+    }
+
+    NativeBlob *blob = ImageEncoder::encode(source, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                                            static_cast<size_t>(rowBytes), ConvertJavaEnumToCpp<ImageFormat>(env, format));
+    if (!blob) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "Image encoding failed");
+        return 0;
+    }
+    return blob->toJava();
+}
@@ -0,0 +1,53 @@
+#ifndef IMAGEENCODER_HPP
+#define IMAGEENCODER_HPP
+
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include "EnumMapping.hpp"
+#include "NativeMemory.hpp"
+
+enum class ImageFormat : uint8_t {
+    Raw,
+    Png,
+    Qoi,
+};
+
+#define UEF_IMAGE_FORMAT_ENTRIES(X) \
+    X(ImageFormat::Raw, Raw) \
+    X(ImageFormat::Png, Png) \
+    X(ImageFormat::Qoi, Qoi)
+
+UEF_DEFINE_ENUM_MAPPING(ImageFormat, "ImageFormat", UEF_IMAGE_FORMAT_ENTRIES, ImageFormat::Png);
+UEF_ASSERT_ENUM_MAPPING(ImageFormat, ImageFormat::Qoi);
+
+/**
+ * Encoders for premultiplied BGRA pixels. Every encoder returns a NativeBlob owned by the caller, or
+ * nullptr on failure.
+ *
+ * PNG is encoded in parallel on the shared WorkerPool: the image is split into row strips, each strip
+ * is filtered and deflated independently and ended on a byte boundary with Z_SYNC_FLUSH, and the raw
+ * deflate streams are stitched into one zlib stream whose Adler-32 (and the IDAT CRC) are combined
+ * from the per-strip checksums.
+ *
+ * QOI keeps the surface's premultiplied BGRA bytes as they are (channel order and alpha are not
+ * converted), which makes it a fast lossless format for internal caches rather than an interchange
+ * format; decodeQoi restores the exact surface bytes.
+ */
+class ImageEncoder {
+public:
+    static NativeBlob *encode(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes, ImageFormat format);
+
+    static NativeBlob *encodeRaw(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes);
+    static NativeBlob *encodePng(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes, int level = 6);
+    static NativeBlob *encodeQoi(const uint8_t *pixels, uint32_t width, uint32_t height, size_t rowBytes);
+
+    static bool readQoiHeader(const uint8_t *data, size_t size, uint32_t &width, uint32_t &height);
+    static bool decodeQoi(const uint8_t *data, size_t size, uint8_t *pixels, size_t rowBytes);
+};
+
+extern "C" {
+    JNIEXPORT jlong JNICALL Java_net_rk4z_juef_UefImageEncoder_encodeImage(JNIEnv *env, jclass obj, jobject pixels, jint rowBytes, jint width, jint height, jobject format);
+}
+
+#endif //IMAGEENCODER_HPP
@@ -0,0 +1,285 @@
+#include "JniRegistry.hpp"
+#include "ClasspathFileSystem.hpp"
+#include "DeltaEncoder.hpp"
+#include "DisplayClock.hpp"
+#include "Downscaler.hpp"
+#include "EngineAllocator.hpp"
+#include "EnumMapping.hpp"
+#include "FrameScheduler.hpp"
+#include "ImageEncoder.hpp"
+#include "NativeMemory.hpp"
+#include "PixelConvert.hpp"
+#include "RenderCache.hpp"
+#include "RenderService.hpp"
+#include "ResizeCoalescer.hpp"
+#include "SurfacePool.hpp"
+#include "TemplateBatch.hpp"
+#include "UefFileSystem.hpp"
+#include "UefFontLoader.hpp"
+#include "UefFrameReader.hpp"
+#include "UefPlatform.hpp"
+#include "UefRenderer.hpp"
+#include "UefView.hpp"
+#include "ViewHibernator.hpp"
+#include "ViewReadback.hpp"
+#include "VirtualFileSystem.hpp"
+
+JavaVM *JniRegistry::vm_ = nullptr;
+
+jclass JniRegistry::uefPlatformClass_ = nullptr;
+jclass JniRegistry::uefRendererClass_ = nullptr;
+jclass JniRegistry::uefViewClass_ = nullptr;
+jclass JniRegistry::uefFrameReaderClass_ = nullptr;
+jclass JniRegistry::uefRenderServiceClass_ = nullptr;
+jclass JniRegistry::nativeMemoryClass_ = nullptr;
+jclass JniRegistry::uefPixelsClass_ = nullptr;
+jclass JniRegistry::uefImageEncoderClass_ = nullptr;
+jclass JniRegistry::uefDownscalerClass_ = nullptr;
+jclass JniRegistry::uefTemplateBatchClass_ = nullptr;
+jclass JniRegistry::uefClasspathResourcesClass_ = nullptr;
+jclass JniRegistry::enumClass_ = nullptr;
+jclass JniRegistry::illegalArgumentExceptionClass_ = nullptr;
+jclass JniRegistry::illegalStateExceptionClass_ = nullptr;
+
+jfieldID JniRegistry::enumOrdinal_ = nullptr;
+jmethodID JniRegistry::uefViewConstructor_ = nullptr;
+jmethodID JniRegistry::renderServiceComplete_ = nullptr;
+jmethodID JniRegistry::renderServiceFail_ = nullptr;
+jmethodID JniRegistry::classpathRead_ = nullptr;
+
+#define NATIVE_METHOD(name, signature, function) \
+    { const_cast<char *>(name), const_cast<char *>(signature), reinterpret_cast<void *>(function) }
+
+jclass JniRegistry::findClass(JNIEnv *env, const char *name) {
+    jclass localClass = env->FindClass(name);
+    if (!localClass) {
+        return nullptr;
+    }
+
+    auto globalClass = (jclass) env->NewGlobalRef(localClass);
+    env->DeleteLocalRef(localClass);
+    return globalClass;
+}
+
+JNIEnv *JniRegistry::attach() {
+    if (!vm_) {
+        return nullptr;
+    }
+
+    JNIEnv *env = nullptr;
+    jint status = vm_->GetEnv(reinterpret_cast<void **>(&env), UEF_JNI_VERSION);
+    if (status == JNI_EDETACHED) {
+        // A daemon so attached engine threads never hold up VM shutdown.
+        status = vm_->AttachCurrentThreadAsDaemon(reinterpret_cast<void **>(&env), nullptr);
+    }
+    return status == JNI_OK ? env : nullptr;
+}
+
+bool JniRegistry::registerNatives(JNIEnv *env) {
+    static const JNINativeMethod platformMethods[] = {
+        NATIVE_METHOD("setConfig", "(Ljava/nio/ByteBuffer;J)V",
+                      Java_net_rk4z_juef_UefPlatform_setConfig),
+        NATIVE_METHOD("setSurfaceFactory", "(L" UEF_PACKAGE "util/SurfaceType;I)V",
+                      Java_net_rk4z_juef_UefPlatform_setSurfaceFactory),
+        NATIVE_METHOD("setSurfacePool", "(JZ)V", Java_net_rk4z_juef_UefPlatform_setSurfacePool),
+        NATIVE_METHOD("trimSurfacePool", "()V", Java_net_rk4z_juef_UefPlatform_trimSurfacePool),
+        NATIVE_METHOD("getSurfacePoolStats", "([J)V", Java_net_rk4z_juef_UefPlatform_getSurfacePoolStats),
+        NATIVE_METHOD("mountAssetPack", "(Ljava/lang/String;)V", Java_net_rk4z_juef_UefPlatform_mountAssetPack),
+        NATIVE_METHOD("mountClasspath", "(I[Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;J)V",
+                      Java_net_rk4z_juef_UefPlatform_mountClasspath),
+        NATIVE_METHOD("getClasspathStats", "([J)V", Java_net_rk4z_juef_UefPlatform_getClasspathStats),
+        NATIVE_METHOD("registerVirtualFile", "(Ljava/lang/String;Ljava/nio/ByteBuffer;IILjava/lang/String;Ljava/lang/String;)V",
+                      Java_net_rk4z_juef_UefPlatform_registerVirtualFile),
+        NATIVE_METHOD("unregisterVirtualFile", "(Ljava/lang/String;)Z", Java_net_rk4z_juef_UefPlatform_unregisterVirtualFile),
+        NATIVE_METHOD("setFontDirectories", "([Ljava/lang/String;)V", Java_net_rk4z_juef_UefPlatform_setFontDirectories),
+        NATIVE_METHOD("getAllocatorStats", "([J)V", Java_net_rk4z_juef_UefPlatform_getAllocatorStats),
+    };
+
+    static const JNINativeMethod rendererMethods[] = {
+        NATIVE_METHOD("create", "()V", Java_net_rk4z_juef_UefRenderer_create),
+        NATIVE_METHOD("refreshDisplay", "(I)V", Java_net_rk4z_juef_UefRenderer_refreshDisplay),
+        NATIVE_METHOD("update", "()V", Java_net_rk4z_juef_UefRenderer_update),
+        NATIVE_METHOD("render", "()V", Java_net_rk4z_juef_UefRenderer_render),
+        NATIVE_METHOD("setFrameBudget", "(DI)V", Java_net_rk4z_juef_UefRenderer_setFrameBudget),
+        NATIVE_METHOD("renderFrame", "()I", Java_net_rk4z_juef_UefRenderer_renderFrame),
+        NATIVE_METHOD("setDisplayClock", "(IDD)V", Java_net_rk4z_juef_UefRenderer_setDisplayClock),
+        NATIVE_METHOD("pumpDisplays", "(J)I", Java_net_rk4z_juef_UefRenderer_pumpDisplays),
+        NATIVE_METHOD("getDisplayStats", "(I[J)Z", Java_net_rk4z_juef_UefRenderer_getDisplayStats),
+        NATIVE_METHOD("wakeDisplay", "(I)V", Java_net_rk4z_juef_UefRenderer_wakeDisplay),
+        NATIVE_METHOD("setHibernation", "(JL" UEF_PACKAGE "util/HibernateMode;I)V", Java_net_rk4z_juef_UefRenderer_setHibernation),
+        NATIVE_METHOD("hibernateIdleViews", "()I", Java_net_rk4z_juef_UefRenderer_hibernateIdleViews),
+        NATIVE_METHOD("getHibernationStats", "([J)V", Java_net_rk4z_juef_UefRenderer_getHibernationStats),
+        NATIVE_METHOD("setResizeCoalescing", "(ZI)V", Java_net_rk4z_juef_UefRenderer_setResizeCoalescing),
+        NATIVE_METHOD("createView",
+                      "(IILjava/nio/ByteBuffer;JL" UEF_PACKAGE "UefSession;)L" UEF_PACKAGE "UefView;",
+                      Java_net_rk4z_juef_UefRenderer_createView),
+    };
+
+    static const JNINativeMethod viewMethods[] = {
+        NATIVE_METHOD("focus", "(J)V", Java_net_rk4z_juef_UefView_focus),
+        NATIVE_METHOD("unFocus", "(J)V", Java_net_rk4z_juef_UefView_unFocus),
+        NATIVE_METHOD("hasFocus", "(J)Z", Java_net_rk4z_juef_UefView_hasFocus),
+        NATIVE_METHOD("lockSurface", "(J[I)Ljava/nio/ByteBuffer;", Java_net_rk4z_juef_UefView_lockSurface),
+        NATIVE_METHOD("unlockSurface", "(J)V", Java_net_rk4z_juef_UefView_unlockSurface),
+        NATIVE_METHOD("copyDirtyTiles", "(J[I)V", Java_net_rk4z_juef_UefView_copyDirtyTiles),
+        NATIVE_METHOD("setPriority", "(JL" UEF_PACKAGE "util/ViewPriority;)V", Java_net_rk4z_juef_UefView_setPriority),
+        NATIVE_METHOD("openFrameReader", "(J)J", Java_net_rk4z_juef_UefView_openFrameReader),
+        NATIVE_METHOD("encodeDelta", "(J[J)Ljava/nio/ByteBuffer;", Java_net_rk4z_juef_UefView_encodeDelta),
+        NATIVE_METHOD("setKeyframeInterval", "(JI)V", Java_net_rk4z_juef_UefView_setKeyframeInterval),
+        NATIVE_METHOD("requestKeyframe", "(J)V", Java_net_rk4z_juef_UefView_requestKeyframe),
+        NATIVE_METHOD("hibernate", "(JL" UEF_PACKAGE "util/HibernateMode;)Z", Java_net_rk4z_juef_UefView_hibernate),
+        NATIVE_METHOD("isHibernating", "(J)Z", Java_net_rk4z_juef_UefView_isHibernating),
+        NATIVE_METHOD("resize", "(JII)V", Java_net_rk4z_juef_UefView_resize),
+        NATIVE_METHOD("readRegion", "(JIIIIL" UEF_PACKAGE "util/PixelFormat;Ljava/nio/ByteBuffer;)V", Java_net_rk4z_juef_UefView_readRegion),
+        NATIVE_METHOD("getElementBounds", "(JLjava/lang/String;[I)Z", Java_net_rk4z_juef_UefView_getElementBounds),
+        NATIVE_METHOD("release", "(J)V", Java_net_rk4z_juef_UefView_release),
+    };
+
+    static const JNINativeMethod frameReaderMethods[] = {
+        NATIVE_METHOD("acquire", "(J[J)Z", Java_net_rk4z_juef_UefFrameReader_acquire),
+        NATIVE_METHOD("buffer", "(JII)Ljava/nio/ByteBuffer;", Java_net_rk4z_juef_UefFrameReader_buffer),
+        NATIVE_METHOD("stats", "(J[J)V", Java_net_rk4z_juef_UefFrameReader_stats),
+        NATIVE_METHOD("close", "(J)V", Java_net_rk4z_juef_UefFrameReader_close),
+    };
+
+    static const JNINativeMethod renderServiceMethods[] = {
+        NATIVE_METHOD("configure", "(IIJ)V", Java_net_rk4z_juef_UefRenderService_configure),
+        NATIVE_METHOD("enqueue", "(JZLjava/lang/String;IIDL" UEF_PACKAGE "util/ImageFormat;J)Z",
+                      Java_net_rk4z_juef_UefRenderService_enqueue),
+        NATIVE_METHOD("pump", "()I", Java_net_rk4z_juef_UefRenderService_pump),
+        NATIVE_METHOD("stats", "([J)V", Java_net_rk4z_juef_UefRenderService_stats),
+        NATIVE_METHOD("configureCache", "(JJ)V", Java_net_rk4z_juef_UefRenderService_configureCache),
+        NATIVE_METHOD("clearCache", "()V", Java_net_rk4z_juef_UefRenderService_clearCache),
+        NATIVE_METHOD("cacheStats", "([J)V", Java_net_rk4z_juef_UefRenderService_cacheStats),
+    };
+
+    static const JNINativeMethod nativeMemoryMethods[] = {
+        NATIVE_METHOD("buffer", "(J)Ljava/nio/ByteBuffer;", Java_net_rk4z_juef_NativeMemory_buffer),
+        NATIVE_METHOD("free", "(J)V", Java_net_rk4z_juef_NativeMemory_free),
+    };
+
+    static const JNINativeMethod pixelsMethods[] = {
+        NATIVE_METHOD("convert",
+                      "(Ljava/nio/ByteBuffer;IIIIIL" UEF_PACKAGE "util/PixelFormat;Ljava/lang/Object;ILjava/nio/ByteBuffer;JJ)V",
+                      Java_net_rk4z_juef_UefPixels_convert),
+        NATIVE_METHOD("getInstructionSet", "()Ljava/lang/String;", Java_net_rk4z_juef_UefPixels_getInstructionSet),
+    };
+
+    static const JNINativeMethod imageEncoderMethods[] = {
+        NATIVE_METHOD("encodeImage", "(Ljava/nio/ByteBuffer;IIIL" UEF_PACKAGE "util/ImageFormat;)J",
+                      Java_net_rk4z_juef_UefImageEncoder_encodeImage),
+    };
+
+    static const JNINativeMethod downscalerMethods[] = {
+        NATIVE_METHOD("downscaleImage", "(Ljava/nio/ByteBuffer;III[IL" UEF_PACKAGE "util/ScaleFilter;)[J",
+                      Java_net_rk4z_juef_UefDownscaler_downscaleImage),
+    };
+
+    static const JNINativeMethod templateBatchMethods[] = {
+        NATIVE_METHOD("open", "(Ljava/lang/String;Ljava/lang/String;IIDL" UEF_PACKAGE "util/ImageFormat;)J",
+                      Java_net_rk4z_juef_UefTemplateBatch_open),
+        NATIVE_METHOD("enqueue", "(JJLjava/lang/String;)V", Java_net_rk4z_juef_UefTemplateBatch_enqueue),
+        NATIVE_METHOD("stats", "(J[J)V", Java_net_rk4z_juef_UefTemplateBatch_stats),
+        NATIVE_METHOD("close", "(J)V", Java_net_rk4z_juef_UefTemplateBatch_close),
+    };
+
+    return env->RegisterNatives(uefPlatformClass_, platformMethods,
+                                sizeof(platformMethods) / sizeof(platformMethods[0])) == JNI_OK
+        && env->RegisterNatives(uefRendererClass_, rendererMethods,
+                                sizeof(rendererMethods) / sizeof(rendererMethods[0])) == JNI_OK
+        && env->RegisterNatives(uefViewClass_, viewMethods,
+                                sizeof(viewMethods) / sizeof(viewMethods[0])) == JNI_OK
+        && env->RegisterNatives(uefFrameReaderClass_, frameReaderMethods,
+                                sizeof(frameReaderMethods) / sizeof(frameReaderMethods[0])) == JNI_OK
+        && env->RegisterNatives(uefRenderServiceClass_, renderServiceMethods,
+                                sizeof(renderServiceMethods) / sizeof(renderServiceMethods[0])) == JNI_OK
+        && env->RegisterNatives(nativeMemoryClass_, nativeMemoryMethods,
+                                sizeof(nativeMemoryMethods) / sizeof(nativeMemoryMethods[0])) == JNI_OK
+        && env->RegisterNatives(uefPixelsClass_, pixelsMethods,
+                                sizeof(pixelsMethods) / sizeof(pixelsMethods[0])) == JNI_OK
+        && env->RegisterNatives(uefImageEncoderClass_, imageEncoderMethods,
+                                sizeof(imageEncoderMethods) / sizeof(imageEncoderMethods[0])) == JNI_OK
+        && env->RegisterNatives(uefDownscalerClass_, downscalerMethods,
+                                sizeof(downscalerMethods) / sizeof(downscalerMethods[0])) == JNI_OK
+        && env->RegisterNatives(uefTemplateBatchClass_, templateBatchMethods,
+                                sizeof(templateBatchMethods) / sizeof(templateBatchMethods[0])) == JNI_OK;
+}
+
+bool JniRegistry::load(JNIEnv *env) {
+    uefPlatformClass_ = findClass(env, UEF_PACKAGE "UefPlatform");
+    uefRendererClass_ = findClass(env, UEF_PACKAGE "UefRenderer");
+    uefViewClass_ = findClass(env, UEF_PACKAGE "UefView");
+    uefFrameReaderClass_ = findClass(env, UEF_PACKAGE "UefFrameReader");
+    uefRenderServiceClass_ = findClass(env, UEF_PACKAGE "UefRenderService");
+    nativeMemoryClass_ = findClass(env, UEF_PACKAGE "NativeMemory");
+    uefPixelsClass_ = findClass(env, UEF_PACKAGE "UefPixels");
+    uefImageEncoderClass_ = findClass(env, UEF_PACKAGE "UefImageEncoder");
+    uefDownscalerClass_ = findClass(env, UEF_PACKAGE "UefDownscaler");
+    uefTemplateBatchClass_ = findClass(env, UEF_PACKAGE "UefTemplateBatch");
+    uefClasspathResourcesClass_ = findClass(env, UEF_PACKAGE "UefClasspathResources");
+    enumClass_ = findClass(env, "java/lang/Enum");
+    illegalArgumentExceptionClass_ = findClass(env, "java/lang/IllegalArgumentException");
+    illegalStateExceptionClass_ = findClass(env, "java/lang/IllegalStateException");
+    if (!uefPlatformClass_ || !uefRendererClass_ || !uefViewClass_ || !uefFrameReaderClass_
+        || !uefRenderServiceClass_ || !nativeMemoryClass_ || !uefPixelsClass_
+        || !uefImageEncoderClass_ || !uefDownscalerClass_ || !uefTemplateBatchClass_
+        || !uefClasspathResourcesClass_ || !enumClass_ || !illegalArgumentExceptionClass_
+        || !illegalStateExceptionClass_) {
+        return false;
+    }
+
+    enumOrdinal_ = env->GetFieldID(enumClass_, "ordinal", "I");
+    uefViewConstructor_ = env->GetMethodID(uefViewClass_, "<init>", "(J)V");
+    renderServiceComplete_ = env->GetStaticMethodID(uefRenderServiceClass_, "complete", "(JLjava/nio/ByteBuffer;J)V");
+    renderServiceFail_ = env->GetStaticMethodID(uefRenderServiceClass_, "fail", "(JLjava/lang/String;)V");
+    classpathRead_ = env->GetStaticMethodID(uefClasspathResourcesClass_, "read", "(ILjava/lang/String;)[B");
+
+    if (env->ExceptionCheck() || !LoadEnumMappings(env)) {
+        return false;
+    }
+
+    PixelConvert::select();
+
+    return registerNatives(env);
+}
+
+void JniRegistry::unload(JNIEnv *env) {
+    jclass *classes[] = {
+        &uefPlatformClass_, &uefRendererClass_, &uefViewClass_, &uefFrameReaderClass_,
+        &uefRenderServiceClass_, &nativeMemoryClass_, &uefPixelsClass_, &uefImageEncoderClass_,
+        &uefDownscalerClass_, &uefTemplateBatchClass_, &uefClasspathResourcesClass_, &enumClass_,
+        &illegalArgumentExceptionClass_, &illegalStateExceptionClass_,
+    };
+
+    for (jclass *clazz : classes) {
+        if (*clazz) {
+            env->DeleteGlobalRef(*clazz);
+            *clazz = nullptr;
+        }
+    }
+}
+
+jint JNI_OnLoad(JavaVM *vm, void *reserved) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), UEF_JNI_VERSION) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    JniRegistry::vm_ = vm;
+    if (!JniRegistry::load(env)) {
+        JniRegistry::unload(env);
+        return JNI_ERR;
+    }
+
+    return UEF_JNI_VERSION;
+}
+
+void JNI_OnUnload(JavaVM *vm, void *reserved) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), UEF_JNI_VERSION) != JNI_OK) {
+        return;
+    }
+
+    JniRegistry::unload(env);
+    JniRegistry::vm_ = nullptr;
+}
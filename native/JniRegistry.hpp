@@ -0,0 +1,56 @@
+#ifndef JNIREGISTRY_HPP
+#define JNIREGISTRY_HPP
+
+#include <jni.h>
+
+#define UEF_JNI_VERSION JNI_VERSION_1_8
+#define UEF_PACKAGE "net/rk4z/juef/"
+
+/**
+ * Every class, field and method ID the binding uses, resolved once in JNI_OnLoad.
+ * Classes are held as global refs until JNI_OnUnload so the IDs stay valid.
+ */
+class JniRegistry {
+public:
+    static JavaVM *vm_;
+
+    static jclass uefPlatformClass_;
+    static jclass uefRendererClass_;
+    static jclass uefViewClass_;
+    static jclass uefFrameReaderClass_;
+    static jclass uefRenderServiceClass_;
+    static jclass nativeMemoryClass_;
+    static jclass uefPixelsClass_;
+    static jclass uefImageEncoderClass_;
+    static jclass uefDownscalerClass_;
+    static jclass uefTemplateBatchClass_;
+    static jclass uefClasspathResourcesClass_;
+    static jclass enumClass_;
+    static jclass illegalArgumentExceptionClass_;
+    static jclass illegalStateExceptionClass_;
+
+    static jfieldID enumOrdinal_;
+    static jmethodID uefViewConstructor_;
+    static jmethodID renderServiceComplete_;
+    static jmethodID renderServiceFail_;
+    static jmethodID classpathRead_;
+
+    // The calling thread's JNIEnv, attaching it as a daemon first if it is a native thread (an engine
+    // worker, say). It stays attached; nullptr if the VM is gone or refuses.
+    static JNIEnv *attach();
+
+    static bool load(JNIEnv *env);
+    static void unload(JNIEnv *env);
+
+private:
+    static jclass findClass(JNIEnv *env, const char *name);
+    static bool registerNatives(JNIEnv *env);
+};
+
+extern "C" {
+    JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved);
+
+    JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *vm, void *reserved);
+}
+
+#endif //JNIREGISTRY_HPP
@@ -0,0 +1,26 @@
+#include "NativeMemory.hpp"
+#include "Utils.hpp"
+
+HeapBlob::HeapBlob(size_t size) {
+    data = AllocateAligned(size ? size : 1, 64);
+    this->size = data ? size : 0;
+}
+
+HeapBlob::~HeapBlob() {
+    FreeAligned(data);
+}
+
+BufferBlob::BufferBlob(RefPtr<Buffer> buffer) : buffer(std::move(buffer)) {
+    if (this->buffer) {
+        data = this->buffer->data();
+        size = this->buffer->size();
+    }
+}
+
+jobject Java_net_rk4z_juef_NativeMemory_buffer(JNIEnv *env, jclass obj, jlong blob) {
+    return reinterpret_cast<NativeBlob *>(blob)->newByteBuffer(env);
+}
+
+void Java_net_rk4z_juef_NativeMemory_free(JNIEnv *env, jclass obj, jlong blob) {
+    delete reinterpret_cast<NativeBlob *>(blob);
+}
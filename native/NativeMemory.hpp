@@ -0,0 +1,44 @@
+#ifndef NATIVEMEMORY_HPP
+#define NATIVEMEMORY_HPP
+
+#include <jni.h>
+#include <cstddef>
+#include <Ultralight/Buffer.h>
+#include <Ultralight/RefPtr.h>
+
+using namespace ultralight;
+
+/**
+ * Memory handed to Java as a direct ByteBuffer without copying. Java registers the buffer with
+ * NativeMemory, whose Cleaner deletes the blob once the buffer becomes unreachable.
+ */
+struct NativeBlob {
+    virtual ~NativeBlob() = default;
+
+    void *data = nullptr;
+    size_t size = 0;
+
+    jobject newByteBuffer(JNIEnv *env) { return env->NewDirectByteBuffer(data, static_cast<jlong>(size)); }
+    jlong toJava() { return reinterpret_cast<jlong>(this); }
+};
+
+// Cache-line aligned heap memory.
+struct HeapBlob : NativeBlob {
+    explicit HeapBlob(size_t size);
+    ~HeapBlob() override;
+};
+
+// Keeps an engine Buffer (EncodePNG output, for instance) alive for as long as Java uses it.
+struct BufferBlob : NativeBlob {
+    explicit BufferBlob(RefPtr<Buffer> buffer);
+
+    RefPtr<Buffer> buffer;
+};
+
+extern "C" {
+    JNIEXPORT jobject JNICALL Java_net_rk4z_juef_NativeMemory_buffer(JNIEnv *env, jclass obj, jlong blob);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_NativeMemory_free(JNIEnv *env, jclass obj, jlong blob);
+}
+
+#endif //NATIVEMEMORY_HPP
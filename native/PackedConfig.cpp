@@ -0,0 +1,90 @@
+#include "PackedConfig.hpp"
+#include "EnumMapping.hpp"
+
+std::vector<ViewConfigCache::Entry> ViewConfigCache::entries_;
+size_t ViewConfigCache::next_ = 0;
+
+void PackedReader::readString(String &out) {
+    auto length = read<int32_t>();
+    if (!ok_ || length < 0) {
+        return;
+    }
+
+    if (size_ - offset_ < static_cast<size_t>(length)) {
+        ok_ = false;
+        return;
+    }
+
+    out = String(reinterpret_cast<const char *>(data_ + offset_), static_cast<size_t>(length));
+    offset_ += static_cast<size_t>(length);
+}
+
+bool DecodeViewConfig(const uint8_t *data, size_t size, ViewConfig &out) {
+    PackedReader reader(data, size);
+
+    out.display_id = static_cast<uint32_t>(reader.read<int32_t>());
+    out.initial_device_scale = reader.read<double>();
+    out.is_accelerated = reader.readBool();
+    out.is_transparent = reader.readBool();
+    out.initial_focus = reader.readBool();
+    out.enable_images = reader.readBool();
+    out.enable_javascript = reader.readBool();
+    out.enable_compositor = reader.readBool();
+    reader.readString(out.font_family_standard);
+    reader.readString(out.font_family_fixed);
+    reader.readString(out.font_family_serif);
+    reader.readString(out.font_family_sans_serif);
+    reader.readString(out.user_agent);
+
+    return reader.ok();
+}
+
+bool DecodeConfig(const uint8_t *data, size_t size, Config &out, AllocatorMode &allocator) {
+    PackedReader reader(data, size);
+
+    reader.readString(out.cache_path);
+    reader.readString(out.resource_path_prefix);
+    reader.readString(out.user_stylesheet);
+    out.face_winding = ConvertOrdinalToCpp<FaceWinding>(reader.read<uint8_t>());
+    out.font_hinting = ConvertOrdinalToCpp<FontHinting>(reader.read<uint8_t>());
+    out.effect_quality = ConvertOrdinalToCpp<EffectQuality>(reader.read<uint8_t>());
+    out.force_repaint = reader.readBool();
+    out.font_gamma = reader.read<double>();
+    out.animation_timer_delay = reader.read<double>();
+    out.scroll_timer_delay = reader.read<double>();
+    out.recycle_delay = reader.read<double>();
+    out.max_update_time = reader.read<double>();
+    out.memory_cache_size = static_cast<uint32_t>(reader.read<int64_t>());
+    out.page_cache_size = static_cast<uint32_t>(reader.read<int64_t>());
+    out.override_ram_size = static_cast<uint32_t>(reader.read<int64_t>());
+    out.min_large_heap_size = static_cast<uint32_t>(reader.read<int64_t>());
+    out.min_small_heap_size = static_cast<uint32_t>(reader.read<int64_t>());
+    out.num_renderer_threads = static_cast<uint32_t>(reader.read<int64_t>());
+    out.bitmap_alignment = static_cast<uint32_t>(reader.read<int64_t>());
+    allocator = ConvertOrdinalToCpp<AllocatorMode>(reader.read<uint8_t>());
+
+    return reader.ok();
+}
+
+const ViewConfig *ViewConfigCache::get(jlong version, const uint8_t *data, size_t size) {
+    for (const Entry &entry : entries_) {
+        if (entry.version == version) {
+            return &entry.config;
+        }
+    }
+
+    Entry entry{version, ViewConfig()};
+    if (!DecodeViewConfig(data, size, entry.config)) {
+        return nullptr;
+    }
+
+    if (entries_.size() < kMaxEntries) {
+        entries_.push_back(entry);
+        return &entries_.back().config;
+    }
+
+    Entry &slot = entries_[next_];
+    next_ = (next_ + 1) % kMaxEntries;
+    slot = entry;
+    return &slot.config;
+}
@@ -0,0 +1,71 @@
+#ifndef PACKEDCONFIG_HPP
+#define PACKEDCONFIG_HPP
+
+#include <jni.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <Ultralight/View.h>
+#include <Ultralight/platform/Config.h>
+#include "EngineAllocator.hpp"
+
+using namespace ultralight;
+
+/**
+ * Reads the layout written by net.rk4z.juef.configuration.PackedWriter: native-endian scalars,
+ * enums as one ordinal byte, strings as an int byte length (-1 for null) followed by UTF-8.
+ */
+class PackedReader {
+public:
+    PackedReader(const uint8_t *data, size_t size) : data_(data), size_(size), offset_(0), ok_(data != nullptr) {}
+
+    template <typename T>
+    T read() {
+        T value{};
+        if (ok_ && size_ - offset_ >= sizeof(T)) {
+            memcpy(&value, data_ + offset_, sizeof(T));
+            offset_ += sizeof(T);
+        } else {
+            ok_ = false;
+        }
+        return value;
+    }
+
+    bool readBool() { return read<uint8_t>() != 0; }
+
+    void readString(String &out);
+
+    bool ok() const { return ok_; }
+
+private:
+    const uint8_t *data_;
+    size_t size_;
+    size_t offset_;
+    bool ok_;
+};
+
+bool DecodeViewConfig(const uint8_t *data, size_t size, ViewConfig &out);
+
+// allocator is not part of Config: it replaces ulAllocator, see EngineAllocator.
+bool DecodeConfig(const uint8_t *data, size_t size, Config &out, AllocatorMode &allocator);
+
+/**
+ * Decoded ViewConfigs keyed by the version stamp Java assigns to each distinct packing, so a burst
+ * of views created from one config decodes it once. Only touched from the renderer thread.
+ */
+class ViewConfigCache {
+public:
+    static const ViewConfig *get(jlong version, const uint8_t *data, size_t size);
+
+private:
+    struct Entry {
+        jlong version;
+        ViewConfig config;
+    };
+
+    static constexpr size_t kMaxEntries = 16;
+    static std::vector<Entry> entries_;
+    static size_t next_;
+};
+
+#endif //PACKEDCONFIG_HPP
@@ -0,0 +1,332 @@
+#include "PixelConvert.hpp"
+#include "EnumMapping.hpp"
+#include "JniRegistry.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define UEF_PIXEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define UEF_TARGET(isa)
+#else
+#define UEF_TARGET(isa) __attribute__((target(isa)))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define UEF_PIXEL_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Destination byte offsets of red, green and blue; alpha is always byte 3.
+#define UEF_RGBA_ORDER 0, 1, 2
+#define UEF_BGRA_ORDER 2, 1, 0
+
+static inline float UnpremultiplyScale(uint32_t alpha) {
+    return alpha ? 255.0f / static_cast<float>(alpha) : 0.0f;
+}
+
+static inline uint8_t Unpremultiply(uint32_t channel, float scale) {
+    float value = static_cast<float>(channel) * scale + 0.5f;
+    return value >= 255.0f ? 255 : static_cast<uint8_t>(value);
+}
+
+template <int R, int G, int B>
+static void ScalarStraight(const uint8_t *source, uint8_t *destination, uint32_t width) {
+    for (uint32_t x = 0; x < width; x++, source += 4, destination += 4) {
+        float scale = UnpremultiplyScale(source[3]);
+        destination[R] = Unpremultiply(source[2], scale);
+        destination[G] = Unpremultiply(source[1], scale);
+        destination[B] = Unpremultiply(source[0], scale);
+        destination[3] = source[3];
+    }
+}
+
+static void ScalarCopy(const uint8_t *source, uint8_t *destination, uint32_t width) {
+    memcpy(destination, source, static_cast<size_t>(width) * 4);
+}
+
+// Premultiplied color is the color composited over black, so opaque RGB only needs a swizzle.
+static void ScalarRgb(const uint8_t *source, uint8_t *destination, uint32_t width) {
+    for (uint32_t x = 0; x < width; x++, source += 4, destination += 3) {
+        destination[0] = source[2];
+        destination[1] = source[1];
+        destination[2] = source[0];
+    }
+}
+
+#ifdef UEF_PIXEL_X86
+
+UEF_TARGET("sse4.1")
+static inline __m128i Sse41Channel(__m128i pixels, int shift, __m128 scale) {
+    __m128i channel = _mm_and_si128(_mm_srli_epi32(pixels, shift), _mm_set1_epi32(0xFF));
+    __m128 value = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(channel), scale), _mm_set1_ps(0.5f));
+    return _mm_min_epi32(_mm_cvttps_epi32(value), _mm_set1_epi32(255));
+}
+
+template <bool SwapRedBlue>
+UEF_TARGET("sse4.1")
+static void Sse41Straight(const uint8_t *source, uint8_t *destination, uint32_t width) {
+    uint32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 4));
+        __m128i alpha = _mm_srli_epi32(pixels, 24);
+        __m128 alphaFloat = _mm_cvtepi32_ps(alpha);
+        __m128 scale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(255.0f), alphaFloat), _mm_cmpneq_ps(alphaFloat, _mm_setzero_ps()));
+
+        __m128i blue = Sse41Channel(pixels, 0, scale);
+        __m128i green = Sse41Channel(pixels, 8, scale);
+        __m128i red = Sse41Channel(pixels, 16, scale);
+        __m128i low = SwapRedBlue ? red : blue;
+        __m128i high = SwapRedBlue ? blue : red;
+
+        __m128i out = _mm_or_si128(_mm_or_si128(low, _mm_slli_epi32(green, 8)),
+                                   _mm_or_si128(_mm_slli_epi32(high, 16), _mm_slli_epi32(alpha, 24)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x * 4), out);
+    }
+
+    if (SwapRedBlue) {
+        ScalarStraight<UEF_RGBA_ORDER>(source + x * 4, destination + x * 4, width - x);
+    } else {
+        ScalarStraight<UEF_BGRA_ORDER>(source + x * 4, destination + x * 4, width - x);
+    }
+}
+
+UEF_TARGET("sse4.1")
+static void Sse41Rgb(const uint8_t *source, uint8_t *destination, uint32_t width) {
+    const __m128i order = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    uint32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 4));
+        __m128i packed = _mm_shuffle_epi8(pixels, order);
+        uint8_t *out = destination + x * 3;
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out), packed);
+        auto tail = static_cast<uint32_t>(_mm_extract_epi32(packed, 2));
+        memcpy(out + 8, &tail, 4);
+    }
+    ScalarRgb(source + x * 4, destination + x * 3, width - x);
+}
+
+UEF_TARGET("avx2")
+static inline __m256i Avx2Channel(__m256i pixels, int shift, __m256 scale) {
+    __m256i channel = _mm256_and_si256(_mm256_srli_epi32(pixels, shift), _mm256_set1_epi32(0xFF));
+    __m256 value = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(channel), scale), _mm256_set1_ps(0.5f));
+    return _mm256_min_epi32(_mm256_cvttps_epi32(value), _mm256_set1_epi32(255));
+}
+
+template <bool SwapRedBlue>
+UEF_TARGET("avx2")
+static void Avx2Straight(const uint8_t *source, uint8_t *destination, uint32_t width) {
+    uint32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + x * 4));
+        __m256i alpha = _mm256_srli_epi32(pixels, 24);
+        __m256 alphaFloat = _mm256_cvtepi32_ps(alpha);
+        __m256 scale = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(255.0f), alphaFloat),
+                                     _mm256_cmp_ps(alphaFloat, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+
+        __m256i blue = Avx2Channel(pixels, 0, scale);
+        __m256i green = Avx2Channel(pixels, 8, scale);
+        __m256i red = Avx2Channel(pixels, 16, scale);
+        __m256i low = SwapRedBlue ? red : blue;
+        __m256i high = SwapRedBlue ? blue : red;
+
+        __m256i out = _mm256_or_si256(_mm256_or_si256(low, _mm256_slli_epi32(green, 8)),
+                                      _mm256_or_si256(_mm256_slli_epi32(high, 16), _mm256_slli_epi32(alpha, 24)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x * 4), out);
+    }
+    Sse41Straight<SwapRedBlue>(source + x * 4, destination + x * 4, width - x);
+}
+
+static bool CpuSupportsSse41() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+static bool CpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    // libgcc also checks that the OS saves the YMM registers.
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // UEF_PIXEL_X86
+
+#ifdef UEF_PIXEL_NEON
+
+static inline float32x4_t NeonScale(uint32x4_t alpha) {
+    float32x4_t alphaFloat = vcvtq_f32_u32(alpha);
+    uint32x4_t nonZero = vmvnq_u32(vceqq_f32(alphaFloat, vdupq_n_f32(0.0f)));
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vdivq_f32(vdupq_n_f32(255.0f), alphaFloat)), nonZero));
+}
+
+static inline uint16x4_t NeonUnpremultiply(uint16x4_t channel, float32x4_t scale) {
+    float32x4_t value = vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(channel)), scale), vdupq_n_f32(0.5f));
+    return vmovn_u32(vminq_u32(vcvtq_u32_f32(value), vdupq_n_u32(255)));
+}
+
+static inline uint8x16_t NeonUnpremultiply(uint8x16_t channel, const float32x4_t (&scales)[4]) {
+    uint16x8_t low = vmovl_u8(vget_low_u8(channel));
+    uint16x8_t high = vmovl_u8(vget_high_u8(channel));
+    uint16x8_t outLow = vcombine_u16(NeonUnpremultiply(vget_low_u16(low), scales[0]), NeonUnpremultiply(vget_high_u16(low), scales[1]));
+    uint16x8_t outHigh = vcombine_u16(NeonUnpremultiply(vget_low_u16(high), scales[2]), NeonUnpremultiply(vget_high_u16(high), scales[3]));
+    return vcombine_u8(vmovn_u16(outLow), vmovn_u16(outHigh));
+}
+
+template <bool SwapRedBlue>
+static void NeonStraight(const uint8_t *source, uint8_t *destination, uint32_t width) {
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t pixels = vld4q_u8(source + x * 4);
+        uint16x8_t alphaLow = vmovl_u8(vget_low_u8(pixels.val[3]));
+        uint16x8_t alphaHigh = vmovl_u8(vget_high_u8(pixels.val[3]));
+        const float32x4_t scales[4] = {
+            NeonScale(vmovl_u16(vget_low_u16(alphaLow))), NeonScale(vmovl_u16(vget_high_u16(alphaLow))),
+            NeonScale(vmovl_u16(vget_low_u16(alphaHigh))), NeonScale(vmovl_u16(vget_high_u16(alphaHigh))),
+        };
+
+        uint8x16_t blue = NeonUnpremultiply(pixels.val[0], scales);
+        uint8x16_t green = NeonUnpremultiply(pixels.val[1], scales);
+        uint8x16_t red = NeonUnpremultiply(pixels.val[2], scales);
+
+        uint8x16x4_t out;
+        out.val[0] = SwapRedBlue ? red : blue;
+        out.val[1] = green;
+        out.val[2] = SwapRedBlue ? blue : red;
+        out.val[3] = pixels.val[3];
+        vst4q_u8(destination + x * 4, out);
+    }
+
+    if (SwapRedBlue) {
+        ScalarStraight<UEF_RGBA_ORDER>(source + x * 4, destination + x * 4, width - x);
+    } else {
+        ScalarStraight<UEF_BGRA_ORDER>(source + x * 4, destination + x * 4, width - x);
+    }
+}
+
+static void NeonRgb(const uint8_t *source, uint8_t *destination, uint32_t width) {
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t pixels = vld4q_u8(source + x * 4);
+        uint8x16x3_t out;
+        out.val[0] = pixels.val[2];
+        out.val[1] = pixels.val[1];
+        out.val[2] = pixels.val[0];
+        vst3q_u8(destination + x * 3, out);
+    }
+    ScalarRgb(source + x * 4, destination + x * 3, width - x);
+}
+
+#endif // UEF_PIXEL_NEON
+
+PixelConvert::RowFunction PixelConvert::rows_[4] = {
+    ScalarStraight<UEF_RGBA_ORDER>, ScalarStraight<UEF_BGRA_ORDER>, ScalarCopy, ScalarRgb,
+};
+const char *PixelConvert::isa_ = "scalar";
+
+void PixelConvert::select() {
+#if defined(UEF_PIXEL_X86)
+    if (CpuSupportsAvx2()) {
+        rows_[static_cast<size_t>(PixelFormat::Rgba)] = Avx2Straight<true>;
+        rows_[static_cast<size_t>(PixelFormat::IntArgb)] = Avx2Straight<false>;
+        rows_[static_cast<size_t>(PixelFormat::Rgb)] = Sse41Rgb;
+        isa_ = "avx2";
+    } else if (CpuSupportsSse41()) {
+        rows_[static_cast<size_t>(PixelFormat::Rgba)] = Sse41Straight<true>;
+        rows_[static_cast<size_t>(PixelFormat::IntArgb)] = Sse41Straight<false>;
+        rows_[static_cast<size_t>(PixelFormat::Rgb)] = Sse41Rgb;
+        isa_ = "sse4.1";
+    }
+#elif defined(UEF_PIXEL_NEON)
+    rows_[static_cast<size_t>(PixelFormat::Rgba)] = NeonStraight<true>;
+    rows_[static_cast<size_t>(PixelFormat::IntArgb)] = NeonStraight<false>;
+    rows_[static_cast<size_t>(PixelFormat::Rgb)] = NeonRgb;
+    isa_ = "neon";
+#endif
+}
+
+void PixelConvert::convert(const uint8_t *source, size_t sourceRowBytes, uint8_t *destination, size_t destinationRowBytes,
+                           uint32_t width, uint32_t height, PixelFormat format) {
+    RowFunction row = rows_[static_cast<size_t>(format)];
+    for (uint32_t y = 0; y < height; y++) {
+        row(source + y * sourceRowBytes, destination + y * destinationRowBytes, width);
+    }
+}
+
+void Java_net_rk4z_juef_UefPixels_convert(JNIEnv *env, jclass obj, jobject source, jint sourceRowBytes, jint x, jint y, jint width, jint height, jobject format, jobject destinationArray, jint elementShift, jobject destinationBuffer, jlong destinationOffset, jlong destinationRowBytes) {
+    auto sourcePixels = static_cast<const uint8_t *>(env->GetDirectBufferAddress(source));
+    if (!sourcePixels) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Source must be a direct ByteBuffer");
+        return;
+    }
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    if (x < 0 || y < 0) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Rectangle lies outside the source pixels");
+        return;
+    }
+
+    // Widened before any arithmetic: caller-supplied ints near INT_MAX must not wrap past the checks.
+    PixelFormat pixelFormat = ConvertJavaEnumToCpp<PixelFormat>(env, format);
+    auto rowLength = static_cast<int64_t>(width) * static_cast<int64_t>(PixelConvert::bytesPerPixel(pixelFormat));
+    int64_t sourceRight = (static_cast<int64_t>(x) + width) * 4;
+    int64_t sourceEnd = (static_cast<int64_t>(y) + height - 1) * sourceRowBytes + sourceRight;
+    if (sourceRight > sourceRowBytes || sourceEnd > env->GetDirectBufferCapacity(source)) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Rectangle lies outside the source pixels");
+        return;
+    }
+    if (destinationOffset < 0 || destinationRowBytes < rowLength) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Destination offset or stride is too small");
+        return;
+    }
+    if (destinationRowBytes > (INT64_MAX - destinationOffset - rowLength) / height) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Destination offset or stride is too large");
+        return;
+    }
+    int64_t destinationEnd = destinationOffset + (static_cast<int64_t>(height) - 1) * destinationRowBytes + rowLength;
+
+    const uint8_t *first = sourcePixels + static_cast<size_t>(y) * sourceRowBytes + static_cast<size_t>(x) * 4;
+    if (destinationBuffer) {
+        auto destination = static_cast<uint8_t *>(env->GetDirectBufferAddress(destinationBuffer));
+        if (!destination || destinationEnd > env->GetDirectBufferCapacity(destinationBuffer)) {
+            env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Destination must be a direct ByteBuffer large enough for the rectangle");
+            return;
+        }
+        PixelConvert::convert(first, sourceRowBytes, destination + destinationOffset, static_cast<size_t>(destinationRowBytes),
+                              static_cast<uint32_t>(width), static_cast<uint32_t>(height), pixelFormat);
+        return;
+    }
+
+    if (destinationEnd > (static_cast<int64_t>(env->GetArrayLength(static_cast<jarray>(destinationArray))) << elementShift)) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Destination array is too small for the rectangle");
+        return;
+    }
+
+    auto destination = static_cast<uint8_t *>(env->GetPrimitiveArrayCritical(static_cast<jarray>(destinationArray), nullptr));
+    if (!destination) {
+        return;
+    }
+    PixelConvert::convert(first, sourceRowBytes, destination + destinationOffset, static_cast<size_t>(destinationRowBytes),
+                          static_cast<uint32_t>(width), static_cast<uint32_t>(height), pixelFormat);
+    env->ReleasePrimitiveArrayCritical(static_cast<jarray>(destinationArray), destination, 0);
+}
+
+jstring Java_net_rk4z_juef_UefPixels_getInstructionSet(JNIEnv *env, jclass obj) {
+    return env->NewStringUTF(PixelConvert::isa());
+}
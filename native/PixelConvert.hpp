@@ -0,0 +1,55 @@
+#ifndef PIXELCONVERT_HPP
+#define PIXELCONVERT_HPP
+
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include "EnumMapping.hpp"
+
+enum class PixelFormat : uint8_t {
+    Rgba,
+    IntArgb,
+    IntArgbPre,
+    Rgb,
+};
+
+#define UEF_PIXEL_FORMAT_ENTRIES(X) \
+    X(PixelFormat::Rgba, Rgba) \
+    X(PixelFormat::IntArgb, IntArgb) \
+    X(PixelFormat::IntArgbPre, IntArgbPre) \
+    X(PixelFormat::Rgb, Rgb)
+
+UEF_DEFINE_ENUM_MAPPING(PixelFormat, "PixelFormat", UEF_PIXEL_FORMAT_ENTRIES, PixelFormat::IntArgb);
+UEF_ASSERT_ENUM_MAPPING(PixelFormat, PixelFormat::Rgb);
+
+/**
+ * Converts premultiplied BGRA surface pixels to the layouts Java consumers use, in a single pass
+ * per row: swizzle, unpremultiply and repack to the destination stride at once.
+ *
+ * One row kernel per format is picked by select() from the best instruction set the CPU supports
+ * (AVX2 or SSE4.1 on x86, NEON on AArch64, scalar otherwise). Every kernel computes
+ * c * (255 / a) + 0.5 in single precision and truncates, so all of them produce identical output.
+ */
+class PixelConvert {
+public:
+    using RowFunction = void (*)(const uint8_t *source, uint8_t *destination, uint32_t width);
+
+    static void select();
+    static const char *isa() { return isa_; }
+    static size_t bytesPerPixel(PixelFormat format) { return format == PixelFormat::Rgb ? 3 : 4; }
+
+    static void convert(const uint8_t *source, size_t sourceRowBytes, uint8_t *destination, size_t destinationRowBytes,
+                        uint32_t width, uint32_t height, PixelFormat format);
+
+private:
+    static RowFunction rows_[4];
+    static const char *isa_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPixels_convert(JNIEnv *env, jclass obj, jobject source, jint sourceRowBytes, jint x, jint y, jint width, jint height, jobject format, jobject destinationArray, jint elementShift, jobject destinationBuffer, jlong destinationOffset, jlong destinationRowBytes);
+
+    JNIEXPORT jstring JNICALL Java_net_rk4z_juef_UefPixels_getInstructionSet(JNIEnv *env, jclass obj);
+}
+
+#endif //PIXELCONVERT_HPP
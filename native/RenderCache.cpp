@@ -0,0 +1,522 @@
+#include "RenderCache.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <Ultralight/platform/Config.h>
+#include <Ultralight/platform/Platform.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Bump whenever rendering or encoding changes what a key produces, so older disk entries stop matching.
+static constexpr uint32_t kCacheVersion = 1;
+static constexpr char kCacheMagic[4] = {'U', 'E', 'F', 'C'};
+
+struct CacheFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t keyHigh;
+    uint64_t keyLow;
+    uint64_t size;
+};
+
+#ifndef _WIN32
+// A disk entry mapped copy-on-write, so Java may scribble on its buffer without touching the file.
+struct MappedBlob : NativeBlob {
+    MappedBlob(void *base, size_t length) : base(base), length(length) {
+        data = static_cast<uint8_t *>(base) + sizeof(CacheFileHeader);
+        size = length - sizeof(CacheFileHeader);
+    }
+    ~MappedBlob() override { munmap(base, length); }
+
+    void *base;
+    size_t length;
+};
+#endif
+
+/**
+ * Two independent multiply-rotate lanes over 8-byte words, finished with the murmur3 mixer. Not
+ * cryptographic, but 128 bits keep accidental collisions out of reach for any realistic cache.
+ */
+class KeyHasher {
+public:
+    void bytes(const void *data, size_t size) {
+        auto input = static_cast<const uint8_t *>(data);
+        total_ += size;
+        for (; size >= 8; input += 8, size -= 8) {
+            uint64_t word;
+            memcpy(&word, input, 8);
+            mix(word);
+        }
+        if (size) {
+            uint64_t word = 0;
+            memcpy(&word, input, size);
+            mix(word);
+        }
+    }
+
+    template <typename T>
+    void value(T value) { bytes(&value, sizeof(value)); }
+
+    void string(const String &value) {
+        const String8 &utf8 = value.utf8();
+        this->value<uint64_t>(utf8.length());
+        bytes(utf8.data(), utf8.length());
+    }
+
+    RenderCacheKey finish() const {
+        uint64_t high = finalize(a_ ^ total_);
+        uint64_t low = finalize(b_ + high);
+        return RenderCacheKey{high, low};
+    }
+
+private:
+    static uint64_t rotate(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+    static uint64_t finalize(uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xFF51AFD7ED558CCDull;
+        value ^= value >> 33;
+        value *= 0xC4CEB9FE1A85EC53ull;
+        value ^= value >> 33;
+        return value;
+    }
+
+    void mix(uint64_t word) {
+        a_ = rotate(a_ ^ (word * 0x87C37B91114253D5ull), 31) * 0x4CF5AD432745937Full;
+        b_ = rotate(b_ ^ (word * 0x9E3779B97F4A7C15ull), 27) * 0xC2B2AE3D27D4EB4Full;
+    }
+
+    uint64_t a_ = 0x243F6A8885A308D3ull;
+    uint64_t b_ = 0x13198A2E03707344ull;
+    uint64_t total_ = 0;
+};
+
+std::mutex RenderCache::mutex_;
+RenderCache::Tier RenderCache::memory_;
+RenderCache::Tier RenderCache::disk_;
+fs::path RenderCache::directory_;
+RenderCacheStats RenderCache::stats_ = {};
+
+void RenderCache::Tier::insert(Entry entry) {
+    erase(entry.key);
+    bytes += entry.size;
+    order.push_front(std::move(entry));
+    index[order.front().key] = order.begin();
+}
+
+void RenderCache::Tier::erase(const RenderCacheKey &key) {
+    auto found = index.find(key);
+    if (found == index.end()) {
+        return;
+    }
+    bytes -= found->second->size;
+    order.erase(found->second);
+    index.erase(found);
+}
+
+void RenderCache::Tier::touch(std::list<Entry>::iterator entry) {
+    order.splice(order.begin(), order, entry);
+}
+
+fs::path RenderCache::directory() {
+    const String &cachePath = Platform::instance().config().cache_path;
+    if (cachePath.empty()) {
+        return fs::path();
+    }
+    return fs::u8path(cachePath.utf8().data()) / "render";
+}
+
+fs::path RenderCache::file(const RenderCacheKey &key) {
+    char name[40];
+    snprintf(name, sizeof(name), "%016llx%016llx.uefc", static_cast<unsigned long long>(key.high),
+             static_cast<unsigned long long>(key.low));
+    return directory_ / name;
+}
+
+static void RemoveFiles(const std::vector<fs::path> &files) {
+    std::error_code error;
+    for (const fs::path &file : files) {
+        fs::remove(file, error);
+    }
+}
+
+void RenderCache::configure(size_t memoryBytes, size_t diskBytes) {
+    std::vector<fs::path> evicted;
+    fs::path scan;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        memory_.capacity = memoryBytes;
+        evict(memory_, nullptr);
+
+        // Without a cache_path there is nowhere to put the files, so the disk tier stays off.
+        fs::path directory = diskBytes ? RenderCache::directory() : fs::path();
+        if (directory.empty()) {
+            // Switching the disk tier off only forgets the index; the files are picked up again later.
+            disk_ = Tier();
+            directory_.clear();
+        } else if (directory != directory_) {
+            // The directory is switched together with the capacity, so no write lands anywhere else.
+            disk_ = Tier();
+            disk_.capacity = diskBytes;
+            directory_ = directory;
+            scan = directory;
+        } else {
+            disk_.capacity = diskBytes;
+            evict(disk_, &evicted);
+        }
+    }
+    RemoveFiles(evicted);
+
+    if (!scan.empty()) {
+        scanDisk(scan);
+    }
+}
+
+void RenderCache::scanDisk(const fs::path &directory) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+
+    std::vector<std::pair<fs::file_time_type, Entry>> found;
+    std::vector<fs::path> stale;
+    for (fs::directory_iterator item(directory, error), end; !error && item != end; item.increment(error)) {
+        const fs::path &path = item->path();
+        std::string extension = path.extension().string();
+        if (extension.compare(0, 4, ".tmp") == 0) {
+            // Left behind by a write that never finished.
+            stale.push_back(path);
+            continue;
+        }
+
+        std::string name = path.stem().string();
+        if (extension != ".uefc" || name.size() != 32
+            || name.find_first_not_of("0123456789abcdef") != std::string::npos) {
+            continue;
+        }
+
+        std::error_code statError;
+        uintmax_t size = item->file_size(statError);
+        fs::file_time_type modified = item->last_write_time(statError);
+        if (statError) {
+            continue;
+        }
+
+        RenderCacheKey key{std::stoull(name.substr(0, 16), nullptr, 16), std::stoull(name.substr(16), nullptr, 16)};
+        found.emplace_back(modified, Entry{key, static_cast<size_t>(size), nullptr});
+    }
+    RemoveFiles(stale);
+
+    // Oldest first, so the most recently used files end up at the front of the LRU order.
+    std::sort(found.begin(), found.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    std::vector<fs::path> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!disk_.capacity || directory_ != directory) {
+            // Reconfigured while scanning.
+            return;
+        }
+        for (auto &entry : found) {
+            // Files written since configure() are already indexed, and are newer.
+            if (!disk_.index.count(entry.second.key)) {
+                disk_.insert(std::move(entry.second));
+            }
+        }
+        evict(disk_, &evicted);
+    }
+    RemoveFiles(evicted);
+}
+
+void RenderCache::clear() {
+    std::vector<fs::path> files;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t memoryCapacity = memory_.capacity;
+        memory_ = Tier();
+        memory_.capacity = memoryCapacity;
+
+        for (const Entry &entry : disk_.order) {
+            files.push_back(file(entry.key));
+        }
+        size_t diskCapacity = disk_.capacity;
+        disk_ = Tier();
+        disk_.capacity = diskCapacity;
+    }
+    RemoveFiles(files);
+}
+
+bool RenderCache::enabled() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory_.capacity || disk_.capacity;
+}
+
+void RenderCache::evict(Tier &tier, std::vector<fs::path> *files) {
+    while (tier.bytes > tier.capacity && !tier.order.empty()) {
+        const Entry &oldest = tier.order.back();
+        if (files) {
+            files->push_back(file(oldest.key));
+        }
+        tier.bytes -= oldest.size;
+        tier.index.erase(oldest.key);
+        tier.order.pop_back();
+        stats_.evictions++;
+    }
+}
+
+RenderCacheKey RenderCache::key(const String &html, uint32_t width, uint32_t height, double scale,
+                                ImageFormat format, const ViewConfig &config) {
+    KeyHasher hasher;
+    hasher.value(kCacheVersion);
+    hasher.value(width);
+    hasher.value(height);
+    hasher.value(scale);
+    hasher.value(static_cast<uint8_t>(format));
+
+    // Everything in the ViewConfig that can change the pixels.
+    uint8_t flags = (config.is_accelerated ? 1 : 0) | (config.is_transparent ? 2 : 0)
+        | (config.initial_focus ? 4 : 0) | (config.enable_images ? 8 : 0)
+        | (config.enable_javascript ? 16 : 0) | (config.enable_compositor ? 32 : 0);
+    hasher.value(flags);
+    hasher.string(config.font_family_standard);
+    hasher.string(config.font_family_fixed);
+    hasher.string(config.font_family_serif);
+    hasher.string(config.font_family_sans_serif);
+    hasher.string(config.user_agent);
+
+    hasher.string(html);
+    return hasher.finish();
+}
+
+NativeBlob *RenderCache::lookup(const RenderCacheKey &key) {
+    std::shared_ptr<HeapBlob> cached;
+    fs::path path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto inMemory = memory_.index.find(key);
+        auto onDisk = disk_.index.find(key);
+        if (inMemory != memory_.index.end()) {
+            memory_.touch(inMemory->second);
+            cached = inMemory->second->blob;
+            stats_.memoryHits++;
+        } else if (onDisk != disk_.index.end()) {
+            disk_.touch(onDisk->second);
+            path = file(key);
+        } else {
+            stats_.misses++;
+            return nullptr;
+        }
+    }
+
+    // The cached blob is shared, Java gets its own copy.
+    if (cached) {
+        auto copy = new HeapBlob(cached->size);
+        if (!copy->data) {
+            delete copy;
+            return nullptr;
+        }
+        memcpy(copy->data, cached->data, cached->size);
+        return copy;
+    }
+
+    NativeBlob *mapped = map(key);
+    std::shared_ptr<HeapBlob> promoted;
+    if (mapped) {
+        std::error_code error;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+
+        promoted = std::make_shared<HeapBlob>(mapped->size);
+        if (promoted->data) {
+            memcpy(promoted->data, mapped->data, mapped->size);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!mapped) {
+        // Deleted or damaged behind our back.
+        disk_.erase(key);
+        stats_.misses++;
+        return nullptr;
+    }
+    stats_.diskHits++;
+    if (promoted->data && promoted->size <= memory_.capacity) {
+        memory_.insert(Entry{key, promoted->size, std::move(promoted)});
+        evict(memory_, nullptr);
+    }
+    return mapped;
+}
+
+NativeBlob *RenderCache::map(const RenderCacheKey &key) {
+    fs::path path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        path = file(key);
+    }
+
+    auto valid = [&key](const CacheFileHeader &header, size_t length) {
+        return memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) == 0 && header.version == kCacheVersion
+            && header.keyHigh == key.high && header.keyLow == key.low
+            && header.size == length - sizeof(CacheFileHeader);
+    };
+
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info{};
+    void *base = MAP_FAILED;
+    auto length = static_cast<size_t>(0);
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) > sizeof(CacheFileHeader)) {
+        length = static_cast<size_t>(info.st_size);
+        base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+    if (!valid(*static_cast<const CacheFileHeader *>(base), length)) {
+        munmap(base, length);
+        return nullptr;
+    }
+    return new MappedBlob(base, length);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    auto length = static_cast<size_t>(in ? static_cast<std::streamoff>(in.tellg()) : 0);
+    CacheFileHeader header{};
+    if (length <= sizeof(header) || !in.seekg(0).read(reinterpret_cast<char *>(&header), sizeof(header))
+        || !valid(header, length)) {
+        return nullptr;
+    }
+    auto blob = new HeapBlob(static_cast<size_t>(header.size));
+    if (!blob->data || !in.read(static_cast<char *>(blob->data), static_cast<std::streamsize>(blob->size))) {
+        delete blob;
+        return nullptr;
+    }
+    return blob;
+#endif
+}
+
+void RenderCache::store(const RenderCacheKey &key, const void *data, size_t size) {
+    if (!size) {
+        return;
+    }
+
+    auto blob = std::make_shared<HeapBlob>(size);
+    if (!blob->data) {
+        return;
+    }
+    memcpy(blob->data, data, size);
+
+    bool toDisk;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!memory_.capacity && !disk_.capacity) {
+            return;
+        }
+        stats_.stores++;
+        if (size <= memory_.capacity) {
+            memory_.insert(Entry{key, size, blob});
+            evict(memory_, nullptr);
+        }
+        toDisk = disk_.capacity && !disk_.index.count(key);
+    }
+
+    if (toDisk) {
+        WorkerPool::shared().submit([key, blob]() { write(key, blob); });
+    }
+}
+
+void RenderCache::write(const RenderCacheKey &key, std::shared_ptr<HeapBlob> blob) {
+    static std::atomic<uint64_t> nextTemporary{0};
+
+    fs::path path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!disk_.capacity) {
+            return;
+        }
+        path = file(key);
+    }
+
+    // Written aside and renamed into place, so a reader never maps a half-written file.
+    fs::path temporary = path;
+    temporary += ".tmp" + std::to_string(nextTemporary.fetch_add(1, std::memory_order_relaxed));
+
+    CacheFileHeader header{};
+    memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.keyHigh = key.high;
+    header.keyLow = key.low;
+    header.size = blob->size;
+
+    std::error_code error;
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(static_cast<const char *>(blob->data), static_cast<std::streamsize>(blob->size));
+        out.close();
+        if (!out) {
+            fs::remove(temporary, error);
+            return;
+        }
+    }
+    fs::rename(temporary, path, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return;
+    }
+
+    std::vector<fs::path> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!disk_.capacity || path.parent_path() != directory_) {
+            // The disk tier was turned off or moved while we were writing.
+            evicted.push_back(path);
+        } else {
+            disk_.insert(Entry{key, sizeof(header) + blob->size, nullptr});
+            evict(disk_, &evicted);
+        }
+    }
+    RemoveFiles(evicted);
+}
+
+RenderCacheStats RenderCache::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RenderCacheStats result = stats_;
+    result.memoryEntries = memory_.index.size();
+    result.memoryBytes = memory_.bytes;
+    result.diskEntries = disk_.index.size();
+    result.diskBytes = disk_.bytes;
+    return result;
+}
+
+void Java_net_rk4z_juef_UefRenderService_configureCache(JNIEnv *env, jclass obj, jlong memoryBytes, jlong diskBytes) {
+    RenderCache::configure(memoryBytes > 0 ? static_cast<size_t>(memoryBytes) : 0,
+                           diskBytes > 0 ? static_cast<size_t>(diskBytes) : 0);
+}
+
+void Java_net_rk4z_juef_UefRenderService_clearCache(JNIEnv *env, jclass obj) {
+    RenderCache::clear();
+}
+
+void Java_net_rk4z_juef_UefRenderService_cacheStats(JNIEnv *env, jclass obj, jlongArray stats) {
+    RenderCacheStats current = RenderCache::stats();
+    jlong values[UEF_RENDER_CACHE_STATS_LENGTH] = {
+        static_cast<jlong>(current.memoryHits), static_cast<jlong>(current.diskHits),
+        static_cast<jlong>(current.misses), static_cast<jlong>(current.stores),
+        static_cast<jlong>(current.evictions), static_cast<jlong>(current.memoryEntries),
+        static_cast<jlong>(current.memoryBytes), static_cast<jlong>(current.diskEntries),
+        static_cast<jlong>(current.diskBytes),
+    };
+    env->SetLongArrayRegion(stats, 0, UEF_RENDER_CACHE_STATS_LENGTH, values);
+}
@@ -0,0 +1,114 @@
+#ifndef RENDERCACHE_HPP
+#define RENDERCACHE_HPP
+
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <Ultralight/View.h>
+#include "ImageEncoder.hpp"
+#include "NativeMemory.hpp"
+
+#define UEF_RENDER_CACHE_STATS_LENGTH 9
+
+using namespace ultralight;
+
+struct RenderCacheKey {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    bool operator==(const RenderCacheKey &other) const { return high == other.high && low == other.low; }
+};
+
+struct RenderCacheKeyHash {
+    size_t operator()(const RenderCacheKey &key) const { return static_cast<size_t>(key.low); }
+};
+
+struct RenderCacheStats {
+    uint64_t memoryHits;
+    uint64_t diskHits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t evictions;
+    uint64_t memoryEntries;
+    uint64_t memoryBytes;
+    uint64_t diskEntries;
+    uint64_t diskBytes;
+};
+
+/**
+ * Content-addressed cache of RenderService results, keyed by a 128-bit hash of the HTML, the image
+ * size, device scale, format and the ViewConfig jobs render with. A hit is answered without a View.
+ *
+ * Entries live in a byte-bounded LRU in memory and, when the disk tier has a budget and the platform
+ * Config a cache_path, as one file per entry under <cache_path>/render/. Files are written on the
+ * WorkerPool and memory-mapped on a hit, and are indexed again on the next configure() so they survive
+ * restarts; a disk hit is promoted into memory.
+ *
+ * Thread-safe: lookups run on submitting threads, stores on the renderer thread and the WorkerPool.
+ */
+class RenderCache {
+public:
+    // Both budgets 0 turns the cache off, which is the default.
+    static void configure(size_t memoryBytes, size_t diskBytes);
+    static void clear();
+    static bool enabled();
+
+    static RenderCacheKey key(const String &html, uint32_t width, uint32_t height, double scale,
+                              ImageFormat format, const ViewConfig &config);
+    // A new blob owned by the caller, nullptr on a miss.
+    static NativeBlob *lookup(const RenderCacheKey &key);
+    static void store(const RenderCacheKey &key, const void *data, size_t size);
+
+    static RenderCacheStats stats();
+
+private:
+    struct Entry {
+        RenderCacheKey key;
+        size_t size;
+        // Memory tier only.
+        std::shared_ptr<HeapBlob> blob;
+    };
+
+    // Most recently used first.
+    struct Tier {
+        std::list<Entry> order;
+        std::unordered_map<RenderCacheKey, std::list<Entry>::iterator, RenderCacheKeyHash> index;
+        size_t bytes = 0;
+        size_t capacity = 0;
+
+        void insert(Entry entry);
+        void erase(const RenderCacheKey &key);
+        void touch(std::list<Entry>::iterator entry);
+    };
+
+    // <cache_path>/render, or empty without a cache_path.
+    static std::filesystem::path directory();
+    static std::filesystem::path file(const RenderCacheKey &key);
+    static void scanDisk(const std::filesystem::path &directory);
+    static void write(const RenderCacheKey &key, std::shared_ptr<HeapBlob> blob);
+    static NativeBlob *map(const RenderCacheKey &key);
+    // Drops least recently used entries past capacity; evicted files are returned for removal.
+    static void evict(Tier &tier, std::vector<std::filesystem::path> *files);
+
+    static std::mutex mutex_;
+    static Tier memory_;
+    static Tier disk_;
+    static std::filesystem::path directory_;
+    static RenderCacheStats stats_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderService_configureCache(JNIEnv *env, jclass obj, jlong memoryBytes, jlong diskBytes);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderService_clearCache(JNIEnv *env, jclass obj);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderService_cacheStats(JNIEnv *env, jclass obj, jlongArray stats);
+}
+
+#endif //RENDERCACHE_HPP
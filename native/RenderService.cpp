@@ -0,0 +1,374 @@
+#include "RenderService.hpp"
+#include "EnumMapping.hpp"
+#include "ImageEncoder.hpp"
+#include "JniRegistry.hpp"
+#include "TemplateBatch.hpp"
+#include "UefRenderer.hpp"
+#include "Utils.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+uint32_t RenderService::poolSize_ = 4;
+uint32_t RenderService::queueCapacity_ = 256;
+uint64_t RenderService::loadTimeoutNanos_ = 30000000000ull;
+std::vector<std::unique_ptr<RenderWorker>> RenderService::workers_;
+
+std::mutex RenderService::mutex_;
+std::condition_variable RenderService::notFull_;
+std::deque<RenderJob> RenderService::queue_;
+std::vector<EncodedImage> RenderService::encoded_;
+uint64_t RenderService::submitted_ = 0;
+uint64_t RenderService::completed_ = 0;
+uint64_t RenderService::failed_ = 0;
+uint64_t RenderService::rejected_ = 0;
+uint64_t RenderService::active_ = 0;
+uint64_t RenderService::latencies_[kLatencySamples] = {};
+uint64_t RenderService::completedAt_[kLatencySamples] = {};
+size_t RenderService::samples_ = 0;
+
+void RenderWorker::OnFinishLoading(View *caller, uint64_t frameId, bool isMainFrame, const String &url) {
+    if (isMainFrame && state == State::Loading) {
+        state = State::Loaded;
+    }
+}
+
+void RenderWorker::OnFailLoading(View *caller, uint64_t frameId, bool isMainFrame, const String &url,
+                                 const String &description, const String &errorDomain, int errorCode) {
+    if (isMainFrame && state == State::Loading) {
+        state = State::Failed;
+        error = description;
+    }
+}
+
+uint64_t RenderService::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void RenderService::configure(uint32_t poolSize, uint32_t queueCapacity, uint64_t loadTimeoutNanos) {
+    // Only the settings change here; pump() shrinks the pool on the renderer thread.
+    std::lock_guard<std::mutex> lock(mutex_);
+    poolSize_ = std::max(poolSize, 1u);
+    loadTimeoutNanos_ = loadTimeoutNanos;
+    queueCapacity_ = std::max(queueCapacity, 1u);
+    notFull_.notify_all();
+}
+
+ViewConfig RenderService::viewConfig(double scale) {
+    ViewConfig config;
+    config.is_accelerated = false;
+    config.initial_device_scale = scale;
+    return config;
+}
+
+bool RenderService::enqueue(RenderJob job, uint64_t waitNanos) {
+    // URLs are not cached: what they point to may change under the same address.
+    if (!job.isUrl && RenderCache::enabled()) {
+        job.cacheKey = RenderCache::key(job.source, job.width, job.height, job.scale, job.format, viewConfig(job.scale));
+        job.cacheable = true;
+
+        NativeBlob *cached = RenderCache::lookup(job.cacheKey);
+        if (cached) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            submitted_++;
+            active_++;
+            encoded_.push_back(EncodedImage{job.id, cached, now()});
+            return true;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool hasRoom = notFull_.wait_for(lock, std::chrono::nanoseconds(waitNanos), [] {
+        return queue_.size() < queueCapacity_;
+    });
+    if (!hasRoom) {
+        rejected_++;
+        return false;
+    }
+
+    job.submittedAt = now();
+    queue_.push_back(std::move(job));
+    submitted_++;
+    return true;
+}
+
+void RenderService::start(RenderWorker &worker, RenderJob job) {
+    worker.job = std::move(job);
+    worker.state = RenderWorker::State::Loading;
+    worker.startedAt = now();
+    worker.error = String();
+
+    if (!worker.view) {
+        worker.view = UefRenderer::createView(static_cast<int>(worker.job.width), static_cast<int>(worker.job.height),
+                                              viewConfig(worker.job.scale));
+        worker.view->set_load_listener(&worker);
+    } else {
+        if (worker.view->width() != worker.job.width || worker.view->height() != worker.job.height) {
+            worker.view->Resize(worker.job.width, worker.job.height);
+        }
+        if (worker.view->device_scale() != worker.job.scale) {
+            worker.view->set_device_scale(worker.job.scale);
+        }
+    }
+
+    if (worker.job.isUrl) {
+        worker.view->LoadURL(worker.job.source);
+    } else {
+        worker.view->LoadHTML(worker.job.source);
+    }
+}
+
+NativeBlob *RenderService::capture(View *view) {
+    Surface *surface = view->surface();
+    if (!surface) {
+        return nullptr;
+    }
+
+    auto pixels = static_cast<const uint8_t *>(surface->LockPixels());
+    NativeBlob *snapshot = ImageEncoder::encodeRaw(pixels, surface->width(), surface->height(), surface->row_bytes());
+    surface->UnlockPixels();
+    return snapshot;
+}
+
+void RenderService::shrink(uint32_t poolSize) {
+    // Drop idle workers only; busy ones go on a later pump() once they finish.
+    for (size_t i = workers_.size(); i-- > 0 && workers_.size() > poolSize;) {
+        if (workers_[i]->state == RenderWorker::State::Idle) {
+            if (workers_[i]->view) {
+                workers_[i]->view->set_load_listener(nullptr);
+            }
+            workers_.erase(workers_.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+}
+
+void RenderService::recordLatency(uint64_t submittedAt) {
+    uint64_t finishedAt = now();
+    size_t sample = samples_ % kLatencySamples;
+    latencies_[sample] = finishedAt - submittedAt;
+    completedAt_[sample] = finishedAt;
+    samples_++;
+}
+
+void RenderService::complete(JNIEnv *env, RenderWorker &worker) {
+    View *view = worker.view.get();
+    UefRenderer::renderer_->RenderOnly(&view, 1);
+    NativeBlob *snapshot = capture(view);
+    if (!snapshot) {
+        fail(env, worker, "Could not capture the View's surface");
+        return;
+    }
+
+    EncodedImage image{worker.job.id, snapshot, worker.job.submittedAt};
+    worker.state = RenderWorker::State::Idle;
+    worker.job.source = String();
+    bool cacheable = worker.job.cacheable;
+    RenderCacheKey cacheKey = worker.job.cacheKey;
+    if (worker.job.format == ImageFormat::Raw) {
+        if (cacheable) {
+            RenderCache::store(cacheKey, snapshot->data, snapshot->size);
+        }
+        deliver(env, image);
+        return;
+    }
+
+    // Encode off the renderer thread; the result is delivered by a later pump().
+    uint32_t width = view->width();
+    uint32_t height = view->height();
+    ImageFormat format = worker.job.format;
+    WorkerPool::shared().submit([image, width, height, format, cacheable, cacheKey]() mutable {
+        NativeBlob *snapshot = image.blob;
+        image.blob = ImageEncoder::encode(static_cast<const uint8_t *>(snapshot->data), width, height,
+                                          static_cast<size_t>(width) * 4, format);
+        delete snapshot;
+        if (cacheable && image.blob) {
+            RenderCache::store(cacheKey, image.blob->data, image.blob->size);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        encoded_.push_back(image);
+    });
+}
+
+void RenderService::deliver(JNIEnv *env, const EncodedImage &image) {
+    if (!image.blob) {
+        failJob(env, image.id, "Image encoding failed");
+        return;
+    }
+
+    jobject buffer = image.blob->newByteBuffer(env);
+    env->CallStaticVoidMethod(JniRegistry::uefRenderServiceClass_, JniRegistry::renderServiceComplete_, image.id, buffer, image.blob->toJava());
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(buffer);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_++;
+    active_--;
+    recordLatency(image.submittedAt);
+}
+
+void RenderService::fail(JNIEnv *env, RenderWorker &worker, const String &message) {
+    worker.state = RenderWorker::State::Idle;
+    worker.job.source = String();
+    failJob(env, worker.job.id, message);
+}
+
+void RenderService::failJob(JNIEnv *env, jlong id, const String &message) {
+    jstring messageJava = env->NewStringUTF(message.utf8().data());
+    env->CallStaticVoidMethod(JniRegistry::uefRenderServiceClass_, JniRegistry::renderServiceFail_, id, messageJava);
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(messageJava);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    failed_++;
+    active_--;
+}
+
+int RenderService::pump(JNIEnv *env) {
+    std::vector<EncodedImage> encoded;
+    std::vector<std::pair<RenderWorker *, RenderJob>> starting;
+    uint32_t poolSize;
+    uint64_t loadTimeoutNanos;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        poolSize = poolSize_;
+        loadTimeoutNanos = loadTimeoutNanos_;
+        encoded.swap(encoded_);
+        for (auto &worker : workers_) {
+            if (queue_.empty()) {
+                break;
+            }
+            if (worker->state == RenderWorker::State::Idle) {
+                starting.emplace_back(worker.get(), std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+        while (!queue_.empty() && workers_.size() < poolSize) {
+            workers_.push_back(std::make_unique<RenderWorker>());
+            starting.emplace_back(workers_.back().get(), std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        active_ += starting.size();
+        if (!starting.empty()) {
+            notFull_.notify_all();
+        }
+    }
+
+    for (const EncodedImage &image : encoded) {
+        deliver(env, image);
+    }
+    for (auto &entry : starting) {
+        start(*entry.first, std::move(entry.second));
+    }
+
+    shrink(poolSize);
+
+    auto finished = static_cast<int>(encoded.size());
+    finished += TemplateBatch::prepare(env);
+    bool busy = std::any_of(workers_.begin(), workers_.end(), [](const std::unique_ptr<RenderWorker> &worker) {
+        return worker->state != RenderWorker::State::Idle;
+    });
+    if (!busy && !TemplateBatch::busy()) {
+        return finished;
+    }
+
+    // Load callbacks fire from inside Update().
+    UefRenderer::renderer_->Update();
+    finished += TemplateBatch::advance(env);
+
+    uint64_t current = now();
+    for (auto &worker : workers_) {
+        switch (worker->state) {
+            case RenderWorker::State::Loaded:
+                // Raw images are delivered right away, the others once encoded.
+                complete(env, *worker);
+                finished += worker->job.format == ImageFormat::Raw ? 1 : 0;
+                break;
+            case RenderWorker::State::Failed:
+                fail(env, *worker, worker->error);
+                finished++;
+                break;
+            case RenderWorker::State::Loading:
+                if (loadTimeoutNanos && current - worker->startedAt > loadTimeoutNanos) {
+                    // The stopped navigation may still report in a later Update(), which would be charged
+                    // to the worker's next job, so the View is discarded instead of reused.
+                    worker->view->Stop();
+                    worker->view->set_load_listener(nullptr);
+                    worker->view = nullptr;
+                    fail(env, *worker, "Timed out waiting for the page to finish loading");
+                    finished++;
+                }
+                break;
+            case RenderWorker::State::Idle:
+                break;
+        }
+    }
+
+    return finished;
+}
+
+RenderServiceStats RenderService::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RenderServiceStats result{submitted_, completed_, failed_, rejected_, queue_.size(), active_, 0, 0, 0, 0};
+
+    size_t count = std::min(samples_, kLatencySamples);
+    if (count == 0) {
+        return result;
+    }
+
+    std::vector<uint64_t> sorted(latencies_, latencies_ + count);
+    auto percentile = [&sorted](double fraction) {
+        auto rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+        std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(rank), sorted.end());
+        return sorted[rank];
+    };
+    result.p50LatencyNanos = percentile(0.50);
+    result.p99LatencyNanos = percentile(0.99);
+
+    // Throughput over the completions still in the sample ring.
+    size_t newest = (samples_ - 1) % kLatencySamples;
+    size_t oldest = samples_ > kLatencySamples ? samples_ % kLatencySamples : 0;
+    result.windowJobs = count - 1;
+    result.windowNanos = completedAt_[newest] - completedAt_[oldest];
+    return result;
+}
+
+void Java_net_rk4z_juef_UefRenderService_configure(JNIEnv *env, jclass obj, jint poolSize, jint queueCapacity, jlong loadTimeoutMillis) {
+    RenderService::configure(poolSize > 0 ? static_cast<uint32_t>(poolSize) : 1,
+                             queueCapacity > 0 ? static_cast<uint32_t>(queueCapacity) : 1,
+                             loadTimeoutMillis > 0 ? static_cast<uint64_t>(loadTimeoutMillis) * 1000000ull : 0);
+}
+
+jboolean Java_net_rk4z_juef_UefRenderService_enqueue(JNIEnv *env, jclass obj, jlong id, jboolean isUrl, jstring source, jint width, jint height, jdouble scale, jobject format, jlong waitNanos) {
+    RenderJob job;
+    job.id = id;
+    job.isUrl = isUrl;
+    job.source = ConvertJavaStringToCpp(env, source);
+    job.width = static_cast<uint32_t>(width);
+    job.height = static_cast<uint32_t>(height);
+    job.scale = scale > 0 ? scale : 1.0;
+    job.format = ConvertJavaEnumToCpp<ImageFormat>(env, format);
+    return RenderService::enqueue(std::move(job), waitNanos > 0 ? static_cast<uint64_t>(waitNanos) : 0);
+}
+
+jint Java_net_rk4z_juef_UefRenderService_pump(JNIEnv *env, jclass obj) {
+    return RenderService::pump(env);
+}
+
+void Java_net_rk4z_juef_UefRenderService_stats(JNIEnv *env, jclass obj, jlongArray stats) {
+    RenderServiceStats current = RenderService::stats();
+    jlong values[UEF_RENDER_SERVICE_STATS_LENGTH] = {
+        static_cast<jlong>(current.submitted), static_cast<jlong>(current.completed),
+        static_cast<jlong>(current.failed), static_cast<jlong>(current.rejected),
+        static_cast<jlong>(current.queued), static_cast<jlong>(current.active),
+        static_cast<jlong>(current.p50LatencyNanos), static_cast<jlong>(current.p99LatencyNanos),
+        static_cast<jlong>(current.windowJobs), static_cast<jlong>(current.windowNanos),
+    };
+    env->SetLongArrayRegion(stats, 0, UEF_RENDER_SERVICE_STATS_LENGTH, values);
+}
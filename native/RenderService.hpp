@@ -0,0 +1,147 @@
+#ifndef RENDERSERVICE_HPP
+#define RENDERSERVICE_HPP
+
+#include <jni.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <Ultralight/Listener.h>
+#include <Ultralight/View.h>
+#include "ImageEncoder.hpp"
+#include "NativeMemory.hpp"
+#include "RenderCache.hpp"
+
+#define UEF_RENDER_SERVICE_STATS_LENGTH 10
+
+using namespace ultralight;
+
+struct RenderJob {
+    jlong id = 0;
+    bool isUrl = false;
+    String source;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    double scale = 1.0;
+    ImageFormat format = ImageFormat::Png;
+    uint64_t submittedAt = 0;
+    // Set when the result should be stored in the RenderCache under cacheKey.
+    bool cacheable = false;
+    RenderCacheKey cacheKey;
+};
+
+/**
+ * One pooled View of the render service and the job it is working on. The View keeps the worker as
+ * its LoadListener for its whole life, so workers are heap-allocated and never move. A View whose
+ * load timed out is dropped, and the worker creates a new one for its next job.
+ */
+struct RenderWorker : public LoadListener {
+    enum class State : uint8_t {
+        Idle,
+        Loading,
+        Loaded,
+        Failed,
+    };
+
+    RefPtr<View> view;
+    RenderJob job;
+    State state = State::Idle;
+    uint64_t startedAt = 0;
+    String error;
+
+    void OnFinishLoading(View *caller, uint64_t frameId, bool isMainFrame, const String &url) override;
+    void OnFailLoading(View *caller, uint64_t frameId, bool isMainFrame, const String &url,
+                       const String &description, const String &errorDomain, int errorCode) override;
+};
+
+// A captured job on its way back to Java; blob is nullptr when encoding failed.
+struct EncodedImage {
+    jlong id;
+    NativeBlob *blob;
+    uint64_t submittedAt;
+};
+
+struct RenderServiceStats {
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t failed;
+    uint64_t rejected;
+    uint64_t queued;
+    uint64_t active;
+    uint64_t p50LatencyNanos;
+    uint64_t p99LatencyNanos;
+    uint64_t windowJobs;
+    uint64_t windowNanos;
+};
+
+/**
+ * Headless HTML/URL-to-image service. Jobs are queued from any thread into a bounded queue (submitters
+ * wait up to a timeout while it is full) and multiplexed over a pool of reusable Views by pump(), which
+ * must run on the renderer thread: it starts queued jobs on idle Views, runs Update(), and paints and
+ * captures every View whose main frame finished loading. Captures are encoded on the WorkerPool while
+ * the renderer moves on, and delivered by a later pump().
+ *
+ * Results go back to Java through UefRenderService.complete/fail as direct ByteBuffers backed by a
+ * NativeBlob. With the RenderCache on, HTML jobs are looked up before they are queued; a hit skips
+ * the queue and the Views entirely and is delivered by the next pump().
+ *
+ * pump() also drives every open TemplateBatch, sharing one Update() with the service's own Views.
+ */
+class RenderService {
+public:
+    static constexpr size_t kLatencySamples = 1024;
+
+    static void configure(uint32_t poolSize, uint32_t queueCapacity, uint64_t loadTimeoutNanos);
+    static bool enqueue(RenderJob job, uint64_t waitNanos);
+    static int pump(JNIEnv *env);
+    static RenderServiceStats stats();
+
+    static uint64_t now();
+    // The config every service View is created with.
+    static ViewConfig viewConfig(double scale);
+    // A tightly packed copy of the View's current pixels, nullptr without a surface.
+    static NativeBlob *capture(View *view);
+
+private:
+    static void start(RenderWorker &worker, RenderJob job);
+    static void complete(JNIEnv *env, RenderWorker &worker);
+    static void fail(JNIEnv *env, RenderWorker &worker, const String &message);
+    static void deliver(JNIEnv *env, const EncodedImage &image);
+    static void failJob(JNIEnv *env, jlong id, const String &message);
+    static void shrink(uint32_t poolSize);
+    static void recordLatency(uint64_t submittedAt);
+
+    // Only touched by pump() on the renderer thread.
+    static std::vector<std::unique_ptr<RenderWorker>> workers_;
+
+    // Guards everything below; configure, enqueue and stats run on arbitrary threads.
+    static std::mutex mutex_;
+    static uint32_t poolSize_;
+    static uint32_t queueCapacity_;
+    static uint64_t loadTimeoutNanos_;
+    static std::condition_variable notFull_;
+    static std::deque<RenderJob> queue_;
+    static std::vector<EncodedImage> encoded_;
+    static uint64_t submitted_;
+    static uint64_t completed_;
+    static uint64_t failed_;
+    static uint64_t rejected_;
+    static uint64_t active_;
+    static uint64_t latencies_[kLatencySamples];
+    static uint64_t completedAt_[kLatencySamples];
+    static size_t samples_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderService_configure(JNIEnv *env, jclass obj, jint poolSize, jint queueCapacity, jlong loadTimeoutMillis);
+
+    JNIEXPORT jboolean JNICALL Java_net_rk4z_juef_UefRenderService_enqueue(JNIEnv *env, jclass obj, jlong id, jboolean isUrl, jstring source, jint width, jint height, jdouble scale, jobject format, jlong waitNanos);
+
+    JNIEXPORT jint JNICALL Java_net_rk4z_juef_UefRenderService_pump(JNIEnv *env, jclass obj);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderService_stats(JNIEnv *env, jclass obj, jlongArray stats);
+}
+
+#endif //RENDERSERVICE_HPP
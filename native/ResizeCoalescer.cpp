@@ -0,0 +1,102 @@
+#include "ResizeCoalescer.hpp"
+#include "DisplayClock.hpp"
+#include "JniRegistry.hpp"
+#include "SurfaceFactory.hpp"
+#include "UefView.hpp"
+#include "ViewRegistry.hpp"
+
+#include <chrono>
+
+bool ResizeCoalescer::slack_ = true;
+uint64_t ResizeCoalescer::settleNanos_ = 250000000;
+uint32_t ResizeCoalescer::active_ = 0;
+
+static uint64_t Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Our plain tiled surfaces only; the engine's bitmaps and triple-buffered surfaces reallocate anyway.
+static TiledSurface *SlackSurface(ViewSlot &slot) {
+    Surface *surface = slot.view->surface();
+    if (!surface || UefSurfaceFactory::asTripleBuffered(surface)) {
+        return nullptr;
+    }
+    return UefSurfaceFactory::asTiled(surface);
+}
+
+void ResizeCoalescer::configure(bool slack, uint32_t settleMillis) {
+    slack_ = slack;
+    settleNanos_ = static_cast<uint64_t>(settleMillis) * 1000000;
+}
+
+void ResizeCoalescer::request(ViewSlot &slot, uint32_t width, uint32_t height) {
+    if (!slot.resizePending && !slot.resizeSlack) {
+        active_++;
+    }
+    slot.resizePending = true;
+    slot.pendingWidth = width;
+    slot.pendingHeight = height;
+    slot.lastResizeAt = Now();
+}
+
+void ResizeCoalescer::apply() {
+    if (!active_) {
+        return;
+    }
+
+    uint64_t now = Now();
+    ViewRegistry::forEach([now](jlong handle, ViewSlot &slot) {
+        // Java still holds the locked pixels; both a resize and a shrink may reallocate them.
+        if ((!slot.resizePending && !slot.resizeSlack) || slot.surfaceLocked) {
+            return;
+        }
+        TiledSurface *surface = SlackSurface(slot);
+
+        if (slot.resizePending) {
+            slot.resizePending = false;
+            if (surface && slack_) {
+                surface->setResizeSlack(true);
+                slot.resizeSlack = true;
+            }
+            if (slot.view->width() != slot.pendingWidth || slot.view->height() != slot.pendingHeight) {
+                slot.view->Resize(slot.pendingWidth, slot.pendingHeight);
+            }
+        }
+
+        if (slot.resizeSlack && now - slot.lastResizeAt >= settleNanos_) {
+            slot.resizeSlack = false;
+            if (surface) {
+                surface->setResizeSlack(false);
+                surface->shrinkToFit();
+            }
+        }
+
+        if (!slot.resizePending && !slot.resizeSlack) {
+            active_--;
+        }
+    });
+}
+
+void ResizeCoalescer::forget(ViewSlot &slot) {
+    if (slot.resizePending || slot.resizeSlack) {
+        active_--;
+    }
+}
+
+void Java_net_rk4z_juef_UefRenderer_setResizeCoalescing(JNIEnv *env, jclass obj, jboolean slack, jint settleMillis) {
+    ResizeCoalescer::configure(slack == JNI_TRUE, settleMillis > 0 ? static_cast<uint32_t>(settleMillis) : 0);
+}
+
+void Java_net_rk4z_juef_UefView_resize(JNIEnv *env, jclass obj, jlong handle, jint width, jint height) {
+    View *view = UefView::lookup(env, handle);
+    if (!view) {
+        return;
+    }
+    if (width <= 0 || height <= 0) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "View size must be positive");
+        return;
+    }
+    ResizeCoalescer::request(*ViewRegistry::slot(handle), static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    DisplayClock::wake(view->display_id());
+}
@@ -0,0 +1,42 @@
+#ifndef RESIZECOALESCER_HPP
+#define RESIZECOALESCER_HPP
+
+#include <jni.h>
+#include <cstdint>
+
+struct ViewSlot;
+
+/**
+ * Turns the stream of resizes a window drag produces into one View::Resize per View per frame.
+ *
+ * request() only records the latest size; apply() runs right before Renderer::Update() and resizes
+ * each View that has a pending size once. With slack on, Tiled surfaces meanwhile keep their buffer
+ * whenever the new size fits and otherwise grow to the next 64 px bucket, so a drag reallocates
+ * every few dozen pixels instead of every event. Once a View's size has not changed for settleMillis
+ * its surface shrinks back to the exact size.
+ *
+ * Renderer thread only.
+ */
+class ResizeCoalescer {
+public:
+    static void configure(bool slack, uint32_t settleMillis);
+
+    static void request(ViewSlot &slot, uint32_t width, uint32_t height);
+    static void apply();
+    // Called before a slot is freed.
+    static void forget(ViewSlot &slot);
+
+private:
+    static bool slack_;
+    static uint64_t settleNanos_;
+    // Views with a pending size or a surface still holding slack, so idle frames skip the walk.
+    static uint32_t active_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_setResizeCoalescing(JNIEnv *env, jclass obj, jboolean slack, jint settleMillis);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_resize(JNIEnv *env, jclass obj, jlong handle, jint width, jint height);
+}
+
+#endif //RESIZECOALESCER_HPP
@@ -0,0 +1,50 @@
+#include "SurfaceFactory.hpp"
+
+#include <Ultralight/platform/Platform.h>
+
+UefSurfaceFactory UefSurfaceFactory::instance_;
+SurfaceType UefSurfaceFactory::type_ = SurfaceType::Bitmap;
+uint32_t UefSurfaceFactory::tileSize_ = 64;
+
+Surface *UefSurfaceFactory::CreateSurface(uint32_t width, uint32_t height) {
+    TiledSurface *surface;
+    if (type_ == SurfaceType::TripleBuffered) {
+        surface = new TripleBufferedSurface(tileSize_);
+    } else {
+        surface = new TiledSurface(tileSize_);
+    }
+    surface->Resize(width, height);
+    return surface;
+}
+
+void UefSurfaceFactory::DestroySurface(Surface *surface) {
+    // TiledSurface's destructor is virtual through Surface.
+    delete static_cast<TiledSurface *>(surface);
+}
+
+void UefSurfaceFactory::install(SurfaceType type, uint32_t tileSize) {
+    type_ = type;
+    tileSize_ = tileSize ? tileSize : 64;
+
+    if (type == SurfaceType::Bitmap) {
+        Platform::instance().set_surface_factory(GetBitmapSurfaceFactory());
+    } else {
+        Platform::instance().set_surface_factory(&instance_);
+    }
+}
+
+TiledSurface *UefSurfaceFactory::asTiled(Surface *surface) {
+    // install() is refused once the Renderer exists, so while our factory is installed every
+    // surface the engine hands out came from it.
+    if (!surface || type_ == SurfaceType::Bitmap || Platform::instance().surface_factory() != &instance_) {
+        return nullptr;
+    }
+    return static_cast<TiledSurface *>(surface);
+}
+
+TripleBufferedSurface *UefSurfaceFactory::asTripleBuffered(Surface *surface) {
+    if (type_ != SurfaceType::TripleBuffered || !asTiled(surface)) {
+        return nullptr;
+    }
+    return static_cast<TripleBufferedSurface *>(surface);
+}
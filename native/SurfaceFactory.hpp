@@ -0,0 +1,48 @@
+#ifndef SURFACEFACTORY_HPP
+#define SURFACEFACTORY_HPP
+
+#include <cstdint>
+#include <Ultralight/platform/Surface.h>
+#include "EnumMapping.hpp"
+#include "TiledSurface.hpp"
+#include "TripleBufferedSurface.hpp"
+
+using namespace ultralight;
+
+enum class SurfaceType : uint8_t {
+    Bitmap,
+    Tiled,
+    TripleBuffered,
+};
+
+#define UEF_SURFACE_TYPE_ENTRIES(X) \
+    X(SurfaceType::Bitmap, Bitmap) \
+    X(SurfaceType::Tiled, Tiled) \
+    X(SurfaceType::TripleBuffered, TripleBuffered)
+
+UEF_DEFINE_ENUM_MAPPING(SurfaceType, "SurfaceType", UEF_SURFACE_TYPE_ENTRIES, SurfaceType::Bitmap);
+UEF_ASSERT_ENUM_MAPPING(SurfaceType, SurfaceType::TripleBuffered);
+
+/**
+ * The SurfaceFactory installed for CPU-rendered Views. With SurfaceType::Bitmap the engine's own
+ * BitmapSurfaceFactory is used; every other type makes this factory create one of our surfaces,
+ * whose pixel buffers come from SurfacePool.
+ */
+class UefSurfaceFactory : public SurfaceFactory {
+public:
+    Surface *CreateSurface(uint32_t width, uint32_t height) override;
+    void DestroySurface(Surface *surface) override;
+
+    static void install(SurfaceType type, uint32_t tileSize);
+
+    // Returns the surface as one of ours, or nullptr when the engine's factory created it.
+    static TiledSurface *asTiled(Surface *surface);
+    static TripleBufferedSurface *asTripleBuffered(Surface *surface);
+
+private:
+    static UefSurfaceFactory instance_;
+    static SurfaceType type_;
+    static uint32_t tileSize_;
+};
+
+#endif //SURFACEFACTORY_HPP
@@ -0,0 +1,192 @@
+#include "SurfacePool.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+std::mutex SurfacePool::mutex_;
+size_t SurfacePool::maxIdleBytes_ = 64u << 20;
+bool SurfacePool::hugePages_ = true;
+std::unordered_map<void *, SurfacePool::Block> SurfacePool::live_;
+std::unordered_map<size_t, std::vector<SurfacePool::Block>> SurfacePool::idle_;
+std::deque<void *> SurfacePool::idleOrder_;
+SurfacePoolStats SurfacePool::stats_ = {};
+
+void SurfacePool::configure(size_t maxIdleBytes, bool hugePages) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxIdleBytes_ = maxIdleBytes;
+    hugePages_ = hugePages;
+    evict(maxIdleBytes_);
+}
+
+size_t SurfacePool::sizeClass(size_t size) {
+    size_t step = 4096;
+    if (size > (64u << 10)) {
+        // A quarter of the power of two below size, never less than a huge page for mapped buffers.
+        step = 1;
+        while (step * 8 <= size) {
+            step <<= 1;
+        }
+        if (size >= kLargeClass) {
+            step = std::max(step, kLargeClass);
+        }
+    }
+    return AlignUp(size ? size : 1, step);
+}
+
+SurfacePool::Block SurfacePool::allocate(size_t capacity, size_t alignment) {
+#ifndef _WIN32
+    if (capacity >= kLargeClass) {
+        void *data = MAP_FAILED;
+        bool huge = false;
+#ifdef MAP_HUGETLB
+        if (hugePages_) {
+            data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            huge = data != MAP_FAILED;
+        }
+#endif
+        if (data == MAP_FAILED) {
+            data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+            // Only a hint; kernels without transparent huge pages simply ignore it.
+            if (data != MAP_FAILED && hugePages_) {
+                madvise(data, capacity, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        if (data != MAP_FAILED) {
+            return Block{data, capacity, true, huge};
+        }
+    }
+#endif
+
+    void *data = AllocateAligned(capacity, std::max<size_t>(alignment, 64));
+    if (data) {
+        memset(data, 0, capacity);
+    }
+    return Block{data, capacity, false, false};
+}
+
+void SurfacePool::free(const Block &block) {
+#ifndef _WIN32
+    if (block.mapped) {
+        munmap(block.data, block.capacity);
+        return;
+    }
+#endif
+    FreeAligned(block.data);
+}
+
+void SurfacePool::evict(size_t limit) {
+    while (stats_.idleBytes > limit && !idleOrder_.empty()) {
+        void *oldest = idleOrder_.front();
+        idleOrder_.pop_front();
+
+        for (auto &entry : idle_) {
+            std::vector<Block> &blocks = entry.second;
+            auto found = std::find_if(blocks.begin(), blocks.end(), [oldest](const Block &block) {
+                return block.data == oldest;
+            });
+            if (found == blocks.end()) {
+                continue;
+            }
+
+            stats_.idleBytes -= found->capacity;
+            stats_.residentBytes -= found->capacity;
+            stats_.hugePageBytes -= found->huge ? found->capacity : 0;
+            stats_.evictions++;
+            free(*found);
+            blocks.erase(found);
+            break;
+        }
+    }
+}
+
+void *SurfacePool::acquire(size_t size, size_t alignment) {
+    size_t capacity = sizeClass(size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.acquires++;
+
+    std::vector<Block> &blocks = idle_[capacity];
+    if (!blocks.empty()) {
+        Block block = blocks.back();
+        blocks.pop_back();
+        idleOrder_.erase(std::find(idleOrder_.begin(), idleOrder_.end(), block.data));
+        stats_.idleBytes -= block.capacity;
+        stats_.hits++;
+
+        // Only the part the caller asked for; the rest of the class was never handed out.
+        memset(block.data, 0, size);
+        live_.emplace(block.data, block);
+        return block.data;
+    }
+
+    Block block = allocate(capacity, alignment);
+    if (!block.data) {
+        return nullptr;
+    }
+    stats_.residentBytes += block.capacity;
+    stats_.hugePageBytes += block.huge ? block.capacity : 0;
+    stats_.peakResidentBytes = std::max(stats_.peakResidentBytes, stats_.residentBytes);
+    live_.emplace(block.data, block);
+    return block.data;
+}
+
+void SurfacePool::release(void *buffer, bool reuse) {
+    if (!buffer) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = live_.find(buffer);
+    if (found == live_.end()) {
+        return;
+    }
+    Block block = found->second;
+    live_.erase(found);
+
+    if (!reuse || block.capacity > maxIdleBytes_) {
+        stats_.residentBytes -= block.capacity;
+        stats_.hugePageBytes -= block.huge ? block.capacity : 0;
+        free(block);
+        return;
+    }
+
+    idle_[block.capacity].push_back(block);
+    idleOrder_.push_back(block.data);
+    stats_.idleBytes += block.capacity;
+    evict(maxIdleBytes_);
+}
+
+void SurfacePool::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    evict(0);
+}
+
+SurfacePoolStats SurfacePool::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void Java_net_rk4z_juef_UefPlatform_setSurfacePool(JNIEnv *env, jclass obj, jlong maxIdleBytes, jboolean hugePages) {
+    SurfacePool::configure(maxIdleBytes > 0 ? static_cast<size_t>(maxIdleBytes) : 0, hugePages == JNI_TRUE);
+}
+
+void Java_net_rk4z_juef_UefPlatform_trimSurfacePool(JNIEnv *env, jclass obj) {
+    SurfacePool::trim();
+}
+
+void Java_net_rk4z_juef_UefPlatform_getSurfacePoolStats(JNIEnv *env, jclass obj, jlongArray stats) {
+    SurfacePoolStats current = SurfacePool::stats();
+    jlong values[UEF_SURFACE_POOL_STATS_LENGTH] = {
+        static_cast<jlong>(current.acquires), static_cast<jlong>(current.hits),
+        static_cast<jlong>(current.residentBytes), static_cast<jlong>(current.idleBytes),
+        static_cast<jlong>(current.hugePageBytes), static_cast<jlong>(current.peakResidentBytes),
+        static_cast<jlong>(current.evictions),
+    };
+    env->SetLongArrayRegion(stats, 0, UEF_SURFACE_POOL_STATS_LENGTH, values);
+}
@@ -0,0 +1,83 @@
+#ifndef SURFACEPOOL_HPP
+#define SURFACEPOOL_HPP
+
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#define UEF_SURFACE_POOL_STATS_LENGTH 7
+
+struct SurfacePoolStats {
+    uint64_t acquires;
+    uint64_t hits;
+    uint64_t residentBytes;
+    uint64_t idleBytes;
+    uint64_t hugePageBytes;
+    uint64_t peakResidentBytes;
+    uint64_t evictions;
+};
+
+/**
+ * Pixel buffers for our surfaces, recycled across CreateSurface, DestroySurface and Resize.
+ *
+ * Requests are rounded up to size classes (4 KiB steps below 64 KiB, then four classes per power of
+ * two, so at most a quarter is wasted), and released buffers wait on a per-class free list until a
+ * request of the same class takes them back. Idle buffers are capped at maxIdleBytes, evicting the
+ * longest idle first.
+ *
+ * Buffers of kLargeClass and up are mapped directly, sized to whole 2 MiB pages: with hugePages
+ * they try MAP_HUGETLB first and otherwise ask for transparent huge pages with madvise. Fresh mappings
+ * are already zero and are not touched, so their pages fault in as the engine paints them.
+ *
+ * Thread-safe: triple-buffered surfaces may free their buffers on a reader's thread.
+ */
+class SurfacePool {
+public:
+    static constexpr size_t kLargeClass = 2u << 20;
+
+    static void configure(size_t maxIdleBytes, bool hugePages);
+
+    // At least size zeroed bytes aligned to alignment (a page at most).
+    static void *acquire(size_t size, size_t alignment);
+    // With reuse false the buffer goes straight back to the system, e.g. for a hibernating View.
+    static void release(void *buffer, bool reuse = true);
+    static void trim();
+
+    static SurfacePoolStats stats();
+
+private:
+    struct Block {
+        void *data;
+        size_t capacity;
+        bool mapped;
+        bool huge;
+    };
+
+    static size_t sizeClass(size_t size);
+    static Block allocate(size_t capacity, size_t alignment);
+    static void free(const Block &block);
+    static void evict(size_t limit);
+
+    static std::mutex mutex_;
+    static size_t maxIdleBytes_;
+    static bool hugePages_;
+    static std::unordered_map<void *, Block> live_;
+    static std::unordered_map<size_t, std::vector<Block>> idle_;
+    // Idle buffers oldest first, for eviction.
+    static std::deque<void *> idleOrder_;
+    static SurfacePoolStats stats_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_setSurfacePool(JNIEnv *env, jclass obj, jlong maxIdleBytes, jboolean hugePages);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_trimSurfacePool(JNIEnv *env, jclass obj);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_getSurfacePoolStats(JNIEnv *env, jclass obj, jlongArray stats);
+}
+
+#endif //SURFACEPOOL_HPP
@@ -0,0 +1,386 @@
+#include "TemplateBatch.hpp"
+#include "EnumMapping.hpp"
+#include "JniRegistry.hpp"
+#include "RenderService.hpp"
+#include "UefRenderer.hpp"
+#include "Utils.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <JavaScriptCore/JSContextRef.h>
+#include <JavaScriptCore/JSStringRef.h>
+#include <JavaScriptCore/JSValueRef.h>
+#include <Ultralight/JavaScript.h>
+
+std::mutex TemplateBatch::batchesMutex_;
+std::vector<std::shared_ptr<TemplateBatch>> TemplateBatch::batches_;
+std::unordered_map<jlong, std::shared_ptr<TemplateBatch>> TemplateBatch::handles_;
+jlong TemplateBatch::nextHandle_ = 0;
+
+static JSStringRef CreateJSString(const String &value) {
+    String16 utf16 = value.utf16();
+    return JSStringCreateWithCharacters(reinterpret_cast<const JSChar *>(utf16.udata()), utf16.length());
+}
+
+static String DescribeJSValue(JSContextRef ctx, JSValueRef value) {
+    JSStringRef string = JSValueToStringCopy(ctx, value, nullptr);
+    if (!string) {
+        return "Unknown JavaScript exception";
+    }
+    String result(reinterpret_cast<const Char16 *>(JSStringGetCharactersPtr(string)), JSStringGetLength(string));
+    JSStringRelease(string);
+    return result;
+}
+
+TemplateBatch::TemplateBatch(String html, String function, uint32_t width, uint32_t height, double scale, ImageFormat format)
+    : html_(std::move(html)), function_(std::move(function)), width_(width), height_(height), scale_(scale), format_(format) {
+}
+
+TemplateBatch::~TemplateBatch() {
+    // Unreachable with work left: prepare() only lets go of drained batches.
+    for (const Encoded &result : encoded_) {
+        delete result.blob;
+    }
+}
+
+jlong TemplateBatch::open(std::shared_ptr<TemplateBatch> batch) {
+    std::lock_guard<std::mutex> lock(batchesMutex_);
+    batches_.push_back(batch);
+    jlong handle = ++nextHandle_;
+    handles_.emplace(handle, std::move(batch));
+    return handle;
+}
+
+std::shared_ptr<TemplateBatch> TemplateBatch::get(jlong handle) {
+    std::lock_guard<std::mutex> lock(batchesMutex_);
+    auto found = handles_.find(handle);
+    return found != handles_.end() ? found->second : nullptr;
+}
+
+bool TemplateBatch::close(jlong handle) {
+    std::shared_ptr<TemplateBatch> batch;
+    {
+        std::lock_guard<std::mutex> lock(batchesMutex_);
+        auto found = handles_.find(handle);
+        if (found == handles_.end()) {
+            return false;
+        }
+        batch = std::move(found->second);
+        handles_.erase(found);
+    }
+
+    std::lock_guard<std::mutex> lock(batch->mutex_);
+    batch->closing_ = true;
+    return true;
+}
+
+void TemplateBatch::enqueue(TemplateRecord record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(record));
+    stats_.submitted++;
+}
+
+TemplateBatchStats TemplateBatch::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TemplateBatchStats result = stats_;
+    result.queued = queue_.size();
+    return result;
+}
+
+void TemplateBatch::OnFinishLoading(View *caller, uint64_t frameId, bool isMainFrame, const String &url) {
+    if (isMainFrame && state_ == State::Loading) {
+        // Bound in advance(), outside the engine's load callback.
+        state_ = State::Ready;
+    }
+}
+
+void TemplateBatch::OnFailLoading(View *caller, uint64_t frameId, bool isMainFrame, const String &url,
+                                  const String &description, const String &errorDomain, int errorCode) {
+    if (isMainFrame && state_ == State::Loading) {
+        state_ = State::Failed;
+        error_ = description;
+    }
+}
+
+void TemplateBatch::start() {
+    view_ = UefRenderer::createView(static_cast<int>(width_), static_cast<int>(height_), RenderService::viewConfig(scale_));
+    view_->set_load_listener(this);
+    view_->LoadHTML(html_);
+    state_ = State::Loading;
+}
+
+bool TemplateBatch::bind() {
+    RefPtr<JSContext> context = view_->LockJSContext();
+    JSContextRef ctx = context->ctx();
+
+    JSStringRef script = CreateJSString(function_);
+    JSValueRef exception = nullptr;
+    JSValueRef value = JSEvaluateScript(ctx, script, nullptr, nullptr, 0, &exception);
+    JSStringRelease(script);
+
+    JSObjectRef function = value && !exception ? JSValueToObject(ctx, value, nullptr) : nullptr;
+    if (!function || !JSObjectIsFunction(ctx, function)) {
+        state_ = State::Failed;
+        error_ = exception ? DescribeJSValue(ctx, exception) : function_ + " is not a function of the template";
+        return false;
+    }
+
+    JSValueProtect(ctx, function);
+    bound_ = function;
+    return true;
+}
+
+void TemplateBatch::unbind() {
+    if (bound_) {
+        RefPtr<JSContext> context = view_->LockJSContext();
+        JSValueUnprotect(context->ctx(), bound_);
+        bound_ = nullptr;
+    }
+}
+
+bool TemplateBatch::patch(const TemplateRecord &record, String &error) {
+    RefPtr<JSContext> context = view_->LockJSContext();
+    JSContextRef ctx = context->ctx();
+
+    JSStringRef json = CreateJSString(record.patch);
+    JSValueRef argument = JSValueMakeFromJSONString(ctx, json);
+    JSStringRelease(json);
+    if (!argument) {
+        error = "Malformed JSON patch";
+        return false;
+    }
+
+    JSValueRef exception = nullptr;
+    JSObjectCallAsFunction(ctx, bound_, nullptr, 1, &argument, &exception);
+    if (exception) {
+        error = DescribeJSValue(ctx, exception);
+        return false;
+    }
+    return true;
+}
+
+int TemplateBatch::render(JNIEnv *env) {
+    uint64_t startedAt = RenderService::now();
+    View *view = view_.get();
+    int failed = 0;
+
+    for (size_t i = 0; i < kRecordsPerPump; i++) {
+        TemplateRecord record;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty() || inFlight_ >= kMaxInFlight) {
+                break;
+            }
+            record = std::move(queue_.front());
+            queue_.pop_front();
+            if (!firstPatchAt_) {
+                firstPatchAt_ = startedAt;
+            }
+        }
+
+        String error;
+        if (!patch(record, error)) {
+            failRecord(env, record.id, error);
+            failed++;
+            continue;
+        }
+
+        // Paints only what the patch invalidated; the capture has to happen before the next patch.
+        UefRenderer::renderer_->RenderOnly(&view, 1);
+        NativeBlob *snapshot = RenderService::capture(view);
+        if (!snapshot) {
+            failRecord(env, record.id, "Could not capture the View's surface");
+            failed++;
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (format_ == ImageFormat::Raw) {
+            encoded_.push_back(Encoded{record.id, snapshot});
+            continue;
+        }
+
+        inFlight_++;
+        uint32_t width = view->width();
+        uint32_t height = view->height();
+        jlong id = record.id;
+        // The batch stays registered until inFlight_ drops back to 0, so this outlives the task.
+        WorkerPool::shared().submit([this, id, snapshot, width, height]() {
+            NativeBlob *blob = ImageEncoder::encode(static_cast<const uint8_t *>(snapshot->data), width, height,
+                                                    static_cast<size_t>(width) * 4, format_);
+            delete snapshot;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            encoded_.push_back(Encoded{id, blob});
+            inFlight_--;
+        });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.rendererNanos += RenderService::now() - startedAt;
+    }
+    return failed + deliver(env);
+}
+
+int TemplateBatch::deliver(JNIEnv *env) {
+    std::vector<Encoded> encoded;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        encoded.swap(encoded_);
+    }
+
+    int completed = 0;
+    for (const Encoded &result : encoded) {
+        if (!result.blob) {
+            failRecord(env, result.id, "Image encoding failed");
+            continue;
+        }
+        jobject buffer = result.blob->newByteBuffer(env);
+        env->CallStaticVoidMethod(JniRegistry::uefRenderServiceClass_, JniRegistry::renderServiceComplete_, result.id, buffer, result.blob->toJava());
+        if (env->ExceptionCheck()) {
+            env->ExceptionClear();
+        }
+        env->DeleteLocalRef(buffer);
+        completed++;
+    }
+
+    if (completed) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.completed += static_cast<uint64_t>(completed);
+        stats_.elapsedNanos = RenderService::now() - firstPatchAt_;
+    }
+    return static_cast<int>(encoded.size());
+}
+
+void TemplateBatch::failRecord(JNIEnv *env, jlong id, const String &message) {
+    jstring messageJava = env->NewStringUTF(message.utf8().data());
+    env->CallStaticVoidMethod(JniRegistry::uefRenderServiceClass_, JniRegistry::renderServiceFail_, id, messageJava);
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(messageJava);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.failed++;
+}
+
+int TemplateBatch::failQueued(JNIEnv *env, const String &message) {
+    std::deque<TemplateRecord> queue;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue.swap(queue_);
+    }
+    for (const TemplateRecord &record : queue) {
+        failRecord(env, record.id, message);
+    }
+    return static_cast<int>(queue.size());
+}
+
+bool TemplateBatch::finished() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closing_ && queue_.empty() && encoded_.empty() && inFlight_ == 0;
+}
+
+int TemplateBatch::prepare(JNIEnv *env) {
+    std::vector<std::shared_ptr<TemplateBatch>> batches;
+    {
+        std::lock_guard<std::mutex> lock(batchesMutex_);
+        batches = batches_;
+    }
+
+    int finished = 0;
+    for (auto &batch : batches) {
+        finished += batch->deliver(env);
+        if (batch->state_ == State::Failed) {
+            finished += batch->failQueued(env, batch->error_);
+        }
+
+        // Closed batches drain what was submitted before they go.
+        if (batch->finished()) {
+            batch->unbind();
+            if (batch->view_) {
+                batch->view_->set_load_listener(nullptr);
+                batch->view_ = nullptr;
+            }
+            std::lock_guard<std::mutex> lock(batchesMutex_);
+            batches_.erase(std::remove(batches_.begin(), batches_.end(), batch), batches_.end());
+        } else if (batch->state_ == State::Created) {
+            batch->start();
+        }
+    }
+    return finished;
+}
+
+bool TemplateBatch::busy() {
+    std::lock_guard<std::mutex> lock(batchesMutex_);
+    return std::any_of(batches_.begin(), batches_.end(), [](const std::shared_ptr<TemplateBatch> &batch) {
+        if (batch->state_ == State::Loading) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(batch->mutex_);
+        return batch->state_ == State::Ready && !batch->queue_.empty();
+    });
+}
+
+int TemplateBatch::advance(JNIEnv *env) {
+    std::vector<std::shared_ptr<TemplateBatch>> batches;
+    {
+        std::lock_guard<std::mutex> lock(batchesMutex_);
+        batches = batches_;
+    }
+
+    int finished = 0;
+    for (auto &batch : batches) {
+        if (batch->state_ != State::Ready) {
+            continue;
+        }
+        if (!batch->bound_ && !batch->bind()) {
+            continue;
+        }
+        finished += batch->render(env);
+    }
+    return finished;
+}
+
+jlong Java_net_rk4z_juef_UefTemplateBatch_open(JNIEnv *env, jclass obj, jstring html, jstring function, jint width, jint height, jdouble scale, jobject format) {
+    auto batch = std::make_shared<TemplateBatch>(ConvertJavaStringToCpp(env, html), ConvertJavaStringToCpp(env, function),
+                                                 static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                                                 scale > 0 ? scale : 1.0, ConvertJavaEnumToCpp<ImageFormat>(env, format));
+    return TemplateBatch::open(std::move(batch));
+}
+
+static std::shared_ptr<TemplateBatch> LookupBatch(JNIEnv *env, jlong handle) {
+    std::shared_ptr<TemplateBatch> batch = TemplateBatch::get(handle);
+    if (!batch) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "UefTemplateBatch is closed");
+    }
+    return batch;
+}
+
+void Java_net_rk4z_juef_UefTemplateBatch_enqueue(JNIEnv *env, jclass obj, jlong pointer, jlong id, jstring patch) {
+    std::shared_ptr<TemplateBatch> batch = LookupBatch(env, pointer);
+    if (batch) {
+        batch->enqueue(TemplateRecord{id, ConvertJavaStringToCpp(env, patch)});
+    }
+}
+
+void Java_net_rk4z_juef_UefTemplateBatch_stats(JNIEnv *env, jclass obj, jlong pointer, jlongArray stats) {
+    std::shared_ptr<TemplateBatch> batch = LookupBatch(env, pointer);
+    if (!batch) {
+        return;
+    }
+
+    TemplateBatchStats current = batch->stats();
+    jlong values[UEF_TEMPLATE_BATCH_STATS_LENGTH] = {
+        static_cast<jlong>(current.submitted), static_cast<jlong>(current.completed),
+        static_cast<jlong>(current.failed), static_cast<jlong>(current.queued),
+        static_cast<jlong>(current.elapsedNanos), static_cast<jlong>(current.rendererNanos),
+    };
+    env->SetLongArrayRegion(stats, 0, UEF_TEMPLATE_BATCH_STATS_LENGTH, values);
+}
+
+void Java_net_rk4z_juef_UefTemplateBatch_close(JNIEnv *env, jclass obj, jlong pointer) {
+    // Closing twice is harmless; the Cleaner may run after an explicit close().
+    TemplateBatch::close(pointer);
+}
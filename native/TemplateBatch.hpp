@@ -0,0 +1,138 @@
+#ifndef TEMPLATEBATCH_HPP
+#define TEMPLATEBATCH_HPP
+
+#include <jni.h>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <JavaScriptCore/JSObjectRef.h>
+#include <Ultralight/Listener.h>
+#include <Ultralight/View.h>
+#include "ImageEncoder.hpp"
+#include "NativeMemory.hpp"
+
+#define UEF_TEMPLATE_BATCH_STATS_LENGTH 6
+
+using namespace ultralight;
+
+struct TemplateRecord {
+    jlong id = 0;
+    String patch;
+};
+
+struct TemplateBatchStats {
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t failed;
+    uint64_t queued;
+    // From the first record's patch to the latest delivery.
+    uint64_t elapsedNanos;
+    // Renderer time spent patching, painting and capturing, summed over all records.
+    uint64_t rendererNanos;
+};
+
+/**
+ * Renders many variants of one HTML template on a single warm View. The template is loaded once;
+ * after that every record is a JSON patch handed to a page function bound when the page finished
+ * loading, so a record costs a restyle, relayout and repaint of what the patch touched instead of
+ * a full parse. The patch function must update the DOM synchronously.
+ *
+ * Driven by RenderService::pump on the renderer thread: each pump patches, paints and captures up to
+ * kRecordsPerPump records, and their encoding runs on the WorkerPool while the renderer already works
+ * on the next record. At most kMaxInFlight captures wait for an encoder, which bounds memory when
+ * encoding is the slower half.
+ *
+ * Results are delivered through UefRenderService.complete/fail like service jobs. Java holds a handle
+ * into a checked registry; enqueue, stats and close may be called from any thread.
+ */
+class TemplateBatch : public LoadListener {
+public:
+    static constexpr size_t kRecordsPerPump = 16;
+    static constexpr size_t kMaxInFlight = 8;
+
+    TemplateBatch(String html, String function, uint32_t width, uint32_t height, double scale, ImageFormat format);
+    ~TemplateBatch() override;
+
+    // Handles are never reused: get() and close() see a closed or unknown one as nullptr/false.
+    static jlong open(std::shared_ptr<TemplateBatch> batch);
+    static std::shared_ptr<TemplateBatch> get(jlong handle);
+    static bool close(jlong handle);
+
+    void enqueue(TemplateRecord record);
+    TemplateBatchStats stats();
+
+    // Renderer thread, from RenderService::pump: prepare before Update(), advance after it.
+    static int prepare(JNIEnv *env);
+    static bool busy();
+    static int advance(JNIEnv *env);
+
+    void OnFinishLoading(View *caller, uint64_t frameId, bool isMainFrame, const String &url) override;
+    void OnFailLoading(View *caller, uint64_t frameId, bool isMainFrame, const String &url,
+                       const String &description, const String &errorDomain, int errorCode) override;
+
+private:
+    enum class State : uint8_t {
+        Created,
+        Loading,
+        Ready,
+        Failed,
+    };
+
+    struct Encoded {
+        jlong id;
+        NativeBlob *blob;
+    };
+
+    void start();
+    bool bind();
+    void unbind();
+    int render(JNIEnv *env);
+    bool patch(const TemplateRecord &record, String &error);
+    int deliver(JNIEnv *env);
+    int failQueued(JNIEnv *env, const String &message);
+    void failRecord(JNIEnv *env, jlong id, const String &message);
+    bool finished();
+
+    const String html_;
+    const String function_;
+    const uint32_t width_;
+    const uint32_t height_;
+    const double scale_;
+    const ImageFormat format_;
+
+    // Renderer-owned.
+    RefPtr<View> view_;
+    State state_ = State::Created;
+    String error_;
+    JSObjectRef bound_ = nullptr;
+
+    // Guards everything below.
+    std::mutex mutex_;
+    std::deque<TemplateRecord> queue_;
+    std::vector<Encoded> encoded_;
+    size_t inFlight_ = 0;
+    bool closing_ = false;
+    TemplateBatchStats stats_ = {};
+    uint64_t firstPatchAt_ = 0;
+
+    static std::mutex batchesMutex_;
+    static std::vector<std::shared_ptr<TemplateBatch>> batches_;
+    // Batches Java has not closed yet, by handle.
+    static std::unordered_map<jlong, std::shared_ptr<TemplateBatch>> handles_;
+    static jlong nextHandle_;
+};
+
+extern "C" {
+    JNIEXPORT jlong JNICALL Java_net_rk4z_juef_UefTemplateBatch_open(JNIEnv *env, jclass obj, jstring html, jstring function, jint width, jint height, jdouble scale, jobject format);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefTemplateBatch_enqueue(JNIEnv *env, jclass obj, jlong pointer, jlong id, jstring patch);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefTemplateBatch_stats(JNIEnv *env, jclass obj, jlong pointer, jlongArray stats);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefTemplateBatch_close(JNIEnv *env, jclass obj, jlong pointer);
+}
+
+#endif //TEMPLATEBATCH_HPP
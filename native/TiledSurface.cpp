@@ -0,0 +1,211 @@
+#include "TiledSurface.hpp"
+#include "ImageEncoder.hpp"
+#include "SurfacePool.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <Ultralight/platform/Config.h>
+#include <Ultralight/platform/Platform.h>
+
+static int CountTrailingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+void TileDirtyMap::reset(uint32_t width, uint32_t height, uint32_t tileSize) {
+    width_ = width;
+    height_ = height;
+    tileSize_ = tileSize ? tileSize : 64;
+    tilesX_ = (width + tileSize_ - 1) / tileSize_;
+    tilesY_ = (height + tileSize_ - 1) / tileSize_;
+    wordsPerRow_ = (tilesX_ + 63) / 64;
+    bits_.assign(static_cast<size_t>(wordsPerRow_) * tilesY_, 0);
+}
+
+void TileDirtyMap::mark(const IntRect &rect) {
+    int left = std::max(rect.left, 0);
+    int top = std::max(rect.top, 0);
+    int right = std::min(rect.right, static_cast<int>(width_));
+    int bottom = std::min(rect.bottom, static_cast<int>(height_));
+    if (right <= left || bottom <= top) {
+        return;
+    }
+
+    uint32_t firstX = static_cast<uint32_t>(left) / tileSize_;
+    uint32_t lastX = static_cast<uint32_t>(right - 1) / tileSize_;
+    uint32_t firstY = static_cast<uint32_t>(top) / tileSize_;
+    uint32_t lastY = static_cast<uint32_t>(bottom - 1) / tileSize_;
+
+    for (uint32_t y = firstY; y <= lastY; y++) {
+        uint64_t *row = bits_.data() + static_cast<size_t>(y) * wordsPerRow_;
+        for (uint32_t x = firstX; x <= lastX;) {
+            uint32_t bit = x % 64;
+            uint32_t count = std::min(64 - bit, lastX - x + 1);
+            uint64_t mask = count == 64 ? ~0ull : ((1ull << count) - 1) << bit;
+            row[x / 64] |= mask;
+            x += count;
+        }
+    }
+}
+
+void TileDirtyMap::markAll() {
+    mark(IntRect{0, 0, static_cast<int>(width_), static_cast<int>(height_)});
+}
+
+void TileDirtyMap::clear() {
+    std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+void TileDirtyMap::collect(std::vector<jint> &out) const {
+    for (uint32_t y = 0; y < tilesY_; y++) {
+        const uint64_t *row = bits_.data() + static_cast<size_t>(y) * wordsPerRow_;
+        for (uint32_t word = 0; word < wordsPerRow_; word++) {
+            uint64_t bits = row[word];
+            while (bits) {
+                uint32_t x = word * 64 + static_cast<uint32_t>(CountTrailingZeros(bits));
+                out.push_back(static_cast<jint>((y << 16) | x));
+                bits &= bits - 1;
+            }
+        }
+    }
+}
+
+TiledSurface::TiledSurface(uint32_t tileSize) {
+    tiles_.reset(0, 0, tileSize);
+}
+
+TiledSurface::~TiledSurface() {
+    SurfacePool::release(pixels_);
+}
+
+void TiledSurface::allocate(uint32_t width, uint32_t height) {
+    size_t alignment = Platform::instance().config().bitmap_alignment;
+
+    SurfacePool::release(pixels_);
+    hibernating_ = false;
+    hibernated_.reset();
+    width_ = width;
+    height_ = height;
+    rowBytes_ = static_cast<uint32_t>(AlignUp(static_cast<size_t>(capacityWidth_) * 4, alignment));
+    pixels_ = capacityBytes() ? SurfacePool::acquire(capacityBytes(), alignment) : nullptr;
+
+    tiles_.reset(width, height, tiles_.tileSize());
+}
+
+void *TiledSurface::LockPixels() {
+    if (hibernating_) {
+        wake();
+    }
+    return pixels_;
+}
+
+void TiledSurface::Resize(uint32_t width, uint32_t height) {
+    if (width == width_ && height == height_) {
+        return;
+    }
+
+    if (slack_ && pixels_ && width <= capacityWidth_ && height <= capacityHeight_) {
+        // Same buffer and stride; the engine lays out and paints the new size from scratch anyway.
+        width_ = width;
+        height_ = height;
+        tiles_.reset(width, height, tiles_.tileSize());
+        Surface::ClearDirtyBounds();
+        return;
+    }
+
+    capacityWidth_ = slack_ ? static_cast<uint32_t>(AlignUp(width, kSlackBucket)) : width;
+    capacityHeight_ = slack_ ? static_cast<uint32_t>(AlignUp(height, kSlackBucket)) : height;
+    allocate(width, height);
+    Surface::ClearDirtyBounds();
+}
+
+bool TiledSurface::shrinkToFit() {
+    if (hibernating_ || (capacityWidth_ == width_ && capacityHeight_ == height_)) {
+        return false;
+    }
+
+    size_t alignment = Platform::instance().config().bitmap_alignment;
+    void *previous = pixels_;
+    uint32_t previousRowBytes = rowBytes_;
+
+    capacityWidth_ = width_;
+    capacityHeight_ = height_;
+    rowBytes_ = static_cast<uint32_t>(AlignUp(static_cast<size_t>(width_) * 4, alignment));
+    pixels_ = capacityBytes() ? SurfacePool::acquire(capacityBytes(), alignment) : nullptr;
+
+    // Nothing is dirty, so the engine will not repaint: the pixels have to come along.
+    if (pixels_ && previous) {
+        for (uint32_t y = 0; y < height_; y++) {
+            memcpy(static_cast<uint8_t *>(pixels_) + static_cast<size_t>(y) * rowBytes_,
+                   static_cast<const uint8_t *>(previous) + static_cast<size_t>(y) * previousRowBytes,
+                   static_cast<size_t>(width_) * 4);
+        }
+    }
+    SurfacePool::release(previous);
+    return true;
+}
+
+void TiledSurface::set_dirty_bounds(const IntRect &bounds) {
+    tiles_.mark(bounds);
+    Surface::set_dirty_bounds(bounds);
+}
+
+void TiledSurface::takeDirtyTiles(std::vector<jint> &out) {
+    out.clear();
+    tiles_.collect(out);
+    tiles_.clear();
+}
+
+size_t TiledSurface::hibernate(HibernateMode mode) {
+    if (hibernating_ || !pixels_) {
+        return 0;
+    }
+
+    std::unique_ptr<NativeBlob> copy;
+    if (mode == HibernateMode::Compress) {
+        copy.reset(ImageEncoder::encodeQoi(static_cast<const uint8_t *>(pixels_), width_, height_, rowBytes_));
+        if (!copy || copy->size >= capacityBytes()) {
+            return 0;
+        }
+    }
+
+    size_t released = capacityBytes() - (copy ? copy->size : 0);
+    SurfacePool::release(pixels_, false);
+    pixels_ = nullptr;
+    hibernated_ = std::move(copy);
+    hibernating_ = true;
+    return released;
+}
+
+bool TiledSurface::wake() {
+    if (!hibernating_) {
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t alignment = Platform::instance().config().bitmap_alignment;
+    pixels_ = capacityBytes() ? SurfacePool::acquire(capacityBytes(), alignment) : nullptr;
+
+    bool restored = pixels_ && hibernated_
+        && ImageEncoder::decodeQoi(static_cast<const uint8_t *>(hibernated_->data), hibernated_->size,
+                                   static_cast<uint8_t *>(pixels_), rowBytes_);
+    if (pixels_ && !restored) {
+        memset(pixels_, 0, size());
+    }
+    hibernated_.reset();
+    hibernating_ = false;
+
+    lastWakeNanos_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    return restored;
+}
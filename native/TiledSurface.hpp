@@ -0,0 +1,119 @@
+#ifndef TILEDSURFACE_HPP
+#define TILEDSURFACE_HPP
+
+#include <jni.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <Ultralight/platform/Surface.h>
+#include "EnumMapping.hpp"
+#include "NativeMemory.hpp"
+
+using namespace ultralight;
+
+enum class HibernateMode : uint8_t {
+    Compress,
+    Drop,
+};
+
+#define UEF_HIBERNATE_MODE_ENTRIES(X) \
+    X(HibernateMode::Compress, Compress) \
+    X(HibernateMode::Drop, Drop)
+
+UEF_DEFINE_ENUM_MAPPING(HibernateMode, "HibernateMode", UEF_HIBERNATE_MODE_ENTRIES, HibernateMode::Compress);
+UEF_ASSERT_ENUM_MAPPING(HibernateMode, HibernateMode::Drop);
+
+/**
+ * One bit per tile of a surface. Painted rects are recorded tile by tile, so two small damaged
+ * areas in opposite corners stay two small sets of tiles instead of one page-sized union.
+ */
+class TileDirtyMap {
+public:
+    void reset(uint32_t width, uint32_t height, uint32_t tileSize);
+    void mark(const IntRect &rect);
+    void markAll();
+    void clear();
+
+    // Appends every dirty tile as (tileY << 16) | tileX, in row-major order.
+    void collect(std::vector<jint> &out) const;
+
+    uint32_t tileSize() const { return tileSize_; }
+
+private:
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t tileSize_ = 64;
+    uint32_t tilesX_ = 0;
+    uint32_t tilesY_ = 0;
+    uint32_t wordsPerRow_ = 0;
+    std::vector<uint64_t> bits_;
+};
+
+/**
+ * CPU surface backed by a single aligned pixel buffer that records damage into a TileDirtyMap on top
+ * of the usual union dirty_bounds().
+ *
+ * While resize slack is on (see ResizeCoalescer) the buffer is allocated in kSlackBucket steps and
+ * kept as long as the new size fits in it, rows keeping the stride of the allocated width.
+ *
+ * The buffer can be released while the View is out of sight, see ViewHibernator. A hibernating
+ * surface keeps its size and wakes up by itself the next time it is locked, so the engine never
+ * sees the difference.
+ */
+class TiledSurface : public Surface {
+public:
+    static constexpr uint32_t kSlackBucket = 64;
+
+    // Starts out empty; the factory sizes it with Resize() once construction has finished so that
+    // subclasses get their own allocate().
+    explicit TiledSurface(uint32_t tileSize);
+    ~TiledSurface() override;
+
+    uint32_t width() const override { return width_; }
+    uint32_t height() const override { return height_; }
+    uint32_t row_bytes() const override { return rowBytes_; }
+    size_t size() const override { return static_cast<size_t>(rowBytes_) * height_; }
+
+    void *LockPixels() override;
+    void UnlockPixels() override {}
+    void Resize(uint32_t width, uint32_t height) override;
+
+    void setResizeSlack(bool slack) { slack_ = slack; }
+    // Moves the pixels into a buffer of exactly the current size; false if it already was one.
+    bool shrinkToFit();
+
+    void set_dirty_bounds(const IntRect &bounds) override;
+
+    // Moves the dirty tiles into out and clears the tile map (dirty_bounds() is left untouched).
+    void takeDirtyTiles(std::vector<jint> &out);
+    uint32_t tileSize() const { return tiles_.tileSize(); }
+
+    // Frees the pixel buffer, keeping a QOI copy of it with Compress. Returns the bytes released net
+    // of that copy, or 0 when the surface was left alone (already hibernating, or incompressible).
+    size_t hibernate(HibernateMode mode);
+    // Reallocates the buffer; false when there was no copy to restore and the pixels are now blank.
+    bool wake();
+    bool hibernating() const { return hibernating_; }
+    uint64_t lastWakeNanos() const { return lastWakeNanos_; }
+
+protected:
+    // Allocates for the capacity set by Resize(), which is at least width x height.
+    virtual void allocate(uint32_t width, uint32_t height);
+    size_t capacityBytes() const { return static_cast<size_t>(rowBytes_) * capacityHeight_; }
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t rowBytes_ = 0;
+    uint32_t capacityWidth_ = 0;
+    uint32_t capacityHeight_ = 0;
+    void *pixels_ = nullptr;
+    TileDirtyMap tiles_;
+
+private:
+    bool slack_ = false;
+    bool hibernating_ = false;
+    std::unique_ptr<NativeBlob> hibernated_;
+    uint64_t lastWakeNanos_ = 0;
+};
+
+#endif //TILEDSURFACE_HPP
@@ -0,0 +1,208 @@
+#include "TripleBufferedSurface.hpp"
+#include "SurfacePool.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <Ultralight/platform/Config.h>
+#include <Ultralight/platform/Platform.h>
+
+FrameBufferSet::~FrameBufferSet() {
+    for (void *buffer : buffers) {
+        SurfacePool::release(buffer);
+    }
+}
+
+uint64_t FrameExchange::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void FrameExchange::resize(uint32_t width, uint32_t height, uint32_t rowBytes, size_t alignment) {
+    auto set = std::make_unique<FrameBufferSet>();
+    set->generation = sets_.empty() ? 1 : sets_.back()->generation + 1;
+    set->width = width;
+    set->height = height;
+    set->rowBytes = rowBytes;
+
+    size_t size = static_cast<size_t>(rowBytes) * height;
+    for (void *&buffer : set->buffers) {
+        buffer = size ? SurfacePool::acquire(size, alignment) : nullptr;
+    }
+
+    set_.store(set.get(), std::memory_order_release);
+    sets_.push_back(std::move(set));
+    resizeFrame_ = frame_;
+
+    // Free every retired set the reader has moved past; the current one always stays.
+    uint32_t readerGeneration = readerGeneration_.load(std::memory_order_acquire);
+    sets_.erase(std::remove_if(sets_.begin(), sets_.end() - 1, [readerGeneration](const std::unique_ptr<FrameBufferSet> &retired) {
+        return retired->generation < readerGeneration;
+    }), sets_.end() - 1);
+}
+
+void FrameExchange::copyRect(const FrameBufferSet &set, uint32_t from, uint32_t to, const IntRect &rect) {
+    int left = std::max(rect.left, 0);
+    int top = std::max(rect.top, 0);
+    int right = std::min(rect.right, static_cast<int>(set.width));
+    int bottom = std::min(rect.bottom, static_cast<int>(set.height));
+    if (right <= left || bottom <= top || !set.buffers[from] || !set.buffers[to]) {
+        return;
+    }
+
+    size_t offset = static_cast<size_t>(left) * 4;
+    size_t length = static_cast<size_t>(right - left) * 4;
+    auto source = static_cast<const uint8_t *>(set.buffers[from]);
+    auto destination = static_cast<uint8_t *>(set.buffers[to]);
+    for (int y = top; y < bottom; y++) {
+        size_t row = static_cast<size_t>(y) * set.rowBytes + offset;
+        memcpy(destination + row, source + row, length);
+    }
+}
+
+void *FrameExchange::beginWrite() {
+    FrameBufferSet *set = set_.load(std::memory_order_relaxed);
+    if (!set) {
+        return nullptr;
+    }
+
+    // Bring the buffer up to the latest frame before the engine paints its next damage on top.
+    uint64_t have = bufferFrame_[write_];
+    if (have != frame_ && frame_ > resizeFrame_) {
+        IntRect stale = IntRect::MakeEmpty();
+        if (have <= resizeFrame_ || frame_ - have >= kHistory) {
+            stale = IntRect{0, 0, static_cast<int>(set->width), static_cast<int>(set->height)};
+        } else {
+            for (uint64_t frame = have + 1; frame <= frame_; frame++) {
+                stale.Join(history_[frame % kHistory]);
+            }
+        }
+        copyRect(*set, latest_, write_, stale);
+        bufferFrame_[write_] = frame_;
+    }
+
+    writing_ = true;
+    return set->buffers[write_];
+}
+
+void FrameExchange::endWrite() {
+    FrameBufferSet *set = set_.load(std::memory_order_relaxed);
+    if (!writing_ || !set) {
+        return;
+    }
+    writing_ = false;
+
+    frame_++;
+    history_[frame_ % kHistory] = pendingDirty_;
+    pendingDirty_ = IntRect::MakeEmpty();
+
+    bufferFrame_[write_] = frame_;
+    publishedFrame_[write_] = frame_;
+    publishedAt_[write_] = now();
+    publishedGeneration_[write_] = set->generation;
+    latest_ = write_;
+
+    uint32_t previous = ready_.exchange(write_ | kFresh, std::memory_order_acq_rel);
+    if (previous & kFresh) {
+        superseded_.fetch_add(1, std::memory_order_relaxed);
+    }
+    write_ = previous & kIndexMask;
+    published_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameExchange::recordDirty(const IntRect &rect) {
+    // Damage reported outside a Lock/Unlock pair belongs to the frame that was just published.
+    if (writing_) {
+        pendingDirty_.Join(rect);
+    } else {
+        history_[frame_ % kHistory].Join(rect);
+    }
+}
+
+bool FrameExchange::acquire(FrameInfo &out) {
+    bool fresh = (ready_.load(std::memory_order_relaxed) & kFresh) != 0;
+    if (fresh) {
+        read_ = ready_.exchange(read_, std::memory_order_acq_rel) & kIndexMask;
+
+        uint64_t latency = now() - publishedAt_[read_];
+        lastLatency_.store(latency, std::memory_order_relaxed);
+        totalLatency_.fetch_add(latency, std::memory_order_relaxed);
+        if (latency > maxLatency_.load(std::memory_order_relaxed)) {
+            maxLatency_.store(latency, std::memory_order_relaxed);
+        }
+        acquired_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FrameBufferSet *set = set_.load(std::memory_order_acquire);
+    if (!set || publishedFrame_[read_] == 0 || publishedGeneration_[read_] != set->generation) {
+        // Nothing published yet, or the frame we hold predates a resize.
+        return false;
+    }
+
+    if (readerSet_ != set) {
+        readerSet_ = set;
+        readerGeneration_.store(set->generation, std::memory_order_release);
+    }
+
+    out.pixels = set->buffers[read_];
+    out.index = read_;
+    out.generation = set->generation;
+    out.width = set->width;
+    out.height = set->height;
+    out.rowBytes = set->rowBytes;
+    out.number = publishedFrame_[read_];
+    out.fresh = fresh;
+    return true;
+}
+
+void *FrameExchange::buffer(uint32_t index, uint32_t generation, size_t &size) const {
+    if (!readerSet_ || readerSet_->generation != generation || index > 2) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(readerSet_->rowBytes) * readerSet_->height;
+    return readerSet_->buffers[index];
+}
+
+FrameStats FrameExchange::stats() const {
+    return FrameStats{
+        published_.load(std::memory_order_relaxed),
+        acquired_.load(std::memory_order_relaxed),
+        superseded_.load(std::memory_order_relaxed),
+        lastLatency_.load(std::memory_order_relaxed),
+        maxLatency_.load(std::memory_order_relaxed),
+        totalLatency_.load(std::memory_order_relaxed),
+    };
+}
+
+TripleBufferedSurface::TripleBufferedSurface(uint32_t tileSize)
+    : TiledSurface(tileSize), exchange_(std::make_shared<FrameExchange>()) {
+}
+
+TripleBufferedSurface::~TripleBufferedSurface() = default;
+
+void TripleBufferedSurface::allocate(uint32_t width, uint32_t height) {
+    size_t alignment = Platform::instance().config().bitmap_alignment;
+
+    // The frame exchange reallocates on every resize; surface-level slack does not apply.
+    width_ = width;
+    height_ = height;
+    capacityWidth_ = width;
+    capacityHeight_ = height;
+    rowBytes_ = static_cast<uint32_t>(AlignUp(static_cast<size_t>(width) * 4, alignment));
+    exchange_->resize(width, height, rowBytes_, alignment);
+    tiles_.reset(width, height, tiles_.tileSize());
+}
+
+void *TripleBufferedSurface::LockPixels() {
+    return exchange_->beginWrite();
+}
+
+void TripleBufferedSurface::UnlockPixels() {
+    exchange_->endWrite();
+}
+
+void TripleBufferedSurface::set_dirty_bounds(const IntRect &bounds) {
+    TiledSurface::set_dirty_bounds(bounds);
+    exchange_->recordDirty(bounds);
+}
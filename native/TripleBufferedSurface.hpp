@@ -0,0 +1,129 @@
+#ifndef TRIPLEBUFFEREDSURFACE_HPP
+#define TRIPLEBUFFEREDSURFACE_HPP
+
+#include <jni.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "TiledSurface.hpp"
+
+struct FrameBufferSet {
+    uint32_t generation = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t rowBytes = 0;
+    void *buffers[3] = {};
+
+    ~FrameBufferSet();
+};
+
+struct FrameInfo {
+    void *pixels;
+    uint32_t index;
+    uint32_t generation;
+    uint32_t width;
+    uint32_t height;
+    uint32_t rowBytes;
+    uint64_t number;
+    bool fresh;
+};
+
+struct FrameStats {
+    uint64_t published;
+    uint64_t acquired;
+    uint64_t superseded;
+    uint64_t lastLatencyNanos;
+    uint64_t maxLatencyNanos;
+    uint64_t totalLatencyNanos;
+};
+
+/**
+ * Lock-free triple buffer between the renderer (single writer) and one Java consumer (single reader).
+ * The three buffer indices are always a permutation of {write, ready, read}; publishing and acquiring
+ * are each a single atomic exchange on the ready slot, so neither side ever waits for the other.
+ *
+ * The engine only repaints damaged areas, so before a buffer is written again the rects painted since
+ * it last held a frame are copied into it from the most recent frame.
+ *
+ * Owned through a shared_ptr by both the surface and any open reader, so a reader stays valid after
+ * its View is released.
+ */
+class FrameExchange {
+public:
+    // Writer side, renderer thread only.
+    void resize(uint32_t width, uint32_t height, uint32_t rowBytes, size_t alignment);
+    void *beginWrite();
+    void endWrite();
+    void recordDirty(const IntRect &rect);
+
+    // Reader side, one consumer thread at a time.
+    bool acquire(FrameInfo &out);
+    // Pixels of one buffer of the set the reader last acquired from, nullptr once that set is gone.
+    void *buffer(uint32_t index, uint32_t generation, size_t &size) const;
+
+    FrameStats stats() const;
+
+private:
+    static constexpr uint32_t kFresh = 4;
+    static constexpr uint32_t kIndexMask = 3;
+    static constexpr uint64_t kHistory = 8;
+
+    static uint64_t now();
+    void copyRect(const FrameBufferSet &set, uint32_t from, uint32_t to, const IntRect &rect);
+
+    std::atomic<FrameBufferSet *> set_{nullptr};
+    std::atomic<uint32_t> ready_{1};
+    std::atomic<uint32_t> readerGeneration_{0};
+
+    // Writer-owned.
+    uint32_t write_ = 0;
+    uint32_t latest_ = 0;
+    uint64_t frame_ = 0;
+    uint64_t resizeFrame_ = 0;
+    bool writing_ = false;
+    IntRect pendingDirty_ = IntRect::MakeEmpty();
+    IntRect history_[kHistory] = {};
+    uint64_t bufferFrame_[3] = {};
+    std::vector<std::unique_ptr<FrameBufferSet>> sets_;
+
+    // Written by the writer for the buffer it publishes, read by the reader once it owns that buffer.
+    uint64_t publishedFrame_[3] = {};
+    uint64_t publishedAt_[3] = {};
+    uint32_t publishedGeneration_[3] = {};
+
+    // Reader-owned.
+    uint32_t read_ = 2;
+    FrameBufferSet *readerSet_ = nullptr;
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> acquired_{0};
+    std::atomic<uint64_t> superseded_{0};
+    std::atomic<uint64_t> lastLatency_{0};
+    std::atomic<uint64_t> maxLatency_{0};
+    std::atomic<uint64_t> totalLatency_{0};
+};
+
+/**
+ * Tiled surface whose pixels live in a FrameExchange: every UnlockPixels publishes a completed frame
+ * that Java can pick up from any thread without locking, see UefFrameReader.
+ */
+class TripleBufferedSurface : public TiledSurface {
+public:
+    explicit TripleBufferedSurface(uint32_t tileSize);
+    ~TripleBufferedSurface() override;
+
+    void *LockPixels() override;
+    void UnlockPixels() override;
+    void set_dirty_bounds(const IntRect &bounds) override;
+
+    const std::shared_ptr<FrameExchange> &exchange() const { return exchange_; }
+
+protected:
+    void allocate(uint32_t width, uint32_t height) override;
+
+private:
+    std::shared_ptr<FrameExchange> exchange_;
+};
+
+#endif //TRIPLEBUFFEREDSURFACE_HPP
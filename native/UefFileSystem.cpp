@@ -0,0 +1,123 @@
+#include "UefFileSystem.hpp"
+#include "AssetPack.hpp"
+#include "JniRegistry.hpp"
+#include "UefRenderer.hpp"
+#include "Utils.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <Ultralight/platform/Platform.h>
+
+UefFileSystem UefFileSystem::instance_;
+std::shared_ptr<const UefFileSystem::Layers> UefFileSystem::layers_ = std::make_shared<const Layers>();
+
+String UefFileSystem::normalize(const String &path) {
+    const String8 &utf8 = path.utf8();
+    const char *data = utf8.data();
+    size_t length = utf8.length();
+
+    size_t start = 0;
+    while (start < length) {
+        if (data[start] == '/' || data[start] == '\\') {
+            start++;
+        } else if (data[start] == '.' && start + 1 < length && (data[start + 1] == '/' || data[start + 1] == '\\')) {
+            start += 2;
+        } else {
+            break;
+        }
+    }
+
+    bool clean = start == 0;
+    for (size_t i = start; clean && i < length; i++) {
+        clean = data[i] != '\\';
+    }
+    if (clean) {
+        return path;
+    }
+
+    std::string normalized(data + start, length - start);
+    for (char &c : normalized) {
+        if (c == '\\') {
+            c = '/';
+        }
+    }
+    return String(normalized.data(), normalized.size());
+}
+
+std::shared_ptr<const UefFileSystem::Layers> UefFileSystem::layers() {
+    return std::atomic_load(&layers_);
+}
+
+FileSystem *UefFileSystem::owner(const Layers &layers, const String &path) {
+    for (const auto &layer : layers) {
+        if (layer->FileExists(path)) {
+            return layer.get();
+        }
+    }
+    return nullptr;
+}
+
+bool UefFileSystem::FileExists(const String &file_path) {
+    return owner(*layers(), normalize(file_path)) != nullptr;
+}
+
+String UefFileSystem::GetFileMimeType(const String &file_path) {
+    String path = normalize(file_path);
+    FileSystem *layer = owner(*layers(), path);
+    return layer ? layer->GetFileMimeType(path) : String("application/unknown");
+}
+
+String UefFileSystem::GetFileCharset(const String &file_path) {
+    String path = normalize(file_path);
+    FileSystem *layer = owner(*layers(), path);
+    return layer ? layer->GetFileCharset(path) : String("utf-8");
+}
+
+RefPtr<Buffer> UefFileSystem::OpenFile(const String &file_path) {
+    String path = normalize(file_path);
+    for (const auto &layer : *layers()) {
+        RefPtr<Buffer> buffer = layer->OpenFile(path);
+        if (buffer) {
+            return buffer;
+        }
+    }
+    return nullptr;
+}
+
+bool UefFileSystem::installed() {
+    return Platform::instance().file_system() == &instance_;
+}
+
+void UefFileSystem::mount(std::shared_ptr<FileSystem> layer) {
+    // Mounts come from Java threads and serialize here; readers only contend on the pointer swap.
+    static std::mutex mountMutex;
+    std::lock_guard<std::mutex> lock(mountMutex);
+
+    std::shared_ptr<const Layers> current = layers();
+    auto next = std::make_shared<Layers>();
+    next->reserve(current->size() + 1);
+    next->push_back(std::move(layer));
+    next->insert(next->end(), current->begin(), current->end());
+    std::atomic_store(&layers_, std::shared_ptr<const Layers>(std::move(next)));
+
+    if (!installed()) {
+        Platform::instance().set_file_system(&instance_);
+    }
+}
+
+void Java_net_rk4z_juef_UefPlatform_mountAssetPack(JNIEnv *env, jclass obj, jstring path) {
+    if (UefRenderer::renderer_ && !UefFileSystem::installed()) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "The first file system must be mounted before the Renderer is created");
+        return;
+    }
+
+    const String8 packPath = ConvertJavaStringToCpp(env, path).utf8();
+    std::string error;
+    std::shared_ptr<AssetPack> pack = AssetPack::open(std::string(packPath.data(), packPath.length()), error);
+    if (!pack) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, error.c_str());
+        return;
+    }
+    UefFileSystem::mount(std::move(pack));
+}
@@ -0,0 +1,48 @@
+#ifndef UEFFILESYSTEM_HPP
+#define UEFFILESYSTEM_HPP
+
+#include <jni.h>
+#include <memory>
+#include <vector>
+#include <Ultralight/platform/FileSystem.h>
+
+using namespace ultralight;
+
+/**
+ * The FileSystem installed for the engine once something is mounted: a stack of layers, each a
+ * FileSystem of its own, asked most recently mounted first. Paths are normalized once here (leading
+ * slashes and "./" dropped, backslashes turned into slashes) before any layer sees them.
+ *
+ * The engine calls in from its worker threads, so the layer list is an immutable snapshot swapped
+ * by mount() through std::atomic_load/atomic_store. Those are not lock-free for shared_ptr (libstdc++
+ * guards them with a small internal mutex pool), but the lock only covers the pointer copy, so a
+ * lookup never waits while mount() builds the next list.
+ */
+class UefFileSystem : public FileSystem {
+public:
+    using Layers = std::vector<std::shared_ptr<FileSystem>>;
+
+    bool FileExists(const String &file_path) override;
+    String GetFileMimeType(const String &file_path) override;
+    String GetFileCharset(const String &file_path) override;
+    RefPtr<Buffer> OpenFile(const String &file_path) override;
+
+    static String normalize(const String &path);
+    static bool installed();
+    // Installs the file system on the first call, which must come before the Renderer is created.
+    static void mount(std::shared_ptr<FileSystem> layer);
+
+private:
+    static std::shared_ptr<const Layers> layers();
+    // The topmost layer that has the file, nullptr when none does.
+    static FileSystem *owner(const Layers &layers, const String &path);
+
+    static UefFileSystem instance_;
+    static std::shared_ptr<const Layers> layers_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_mountAssetPack(JNIEnv *env, jclass obj, jstring path);
+}
+
+#endif //UEFFILESYSTEM_HPP
@@ -0,0 +1,433 @@
+#include "UefFontLoader.hpp"
+#include "JniRegistry.hpp"
+#include "UefRenderer.hpp"
+#include "Utils.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+#include <Ultralight/platform/Config.h>
+#include <Ultralight/platform/Platform.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Distinct characters looked at per fallback query; runs longer than this are rare and the first
+// characters decide anyway.
+static constexpr size_t kMaxFallbackCharacters = 64;
+static constexpr size_t kMaxRememberedFallbacks = 4096;
+
+std::mutex UefFontLoader::installMutex_;
+std::atomic<UefFontLoader *> UefFontLoader::instance_{nullptr};
+
+#ifndef _WIN32
+static void Unmap(void *userData, void *data) {
+    munmap(data, reinterpret_cast<uintptr_t>(userData));
+}
+#endif
+
+static std::string Fold(const std::string &name) {
+    std::string folded(name);
+    for (char &c : folded) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return folded;
+}
+
+static bool IsFontFile(const fs::path &path) {
+    std::string extension = Fold(path.extension().string());
+    return extension == ".ttf" || extension == ".otf" || extension == ".ttc" || extension == ".otc";
+}
+
+// Characters no font needs a glyph for: spaces, joiners, directional marks and variation selectors.
+static bool IsInvisible(uint32_t codepoint) {
+    return codepoint <= 0x20 || (codepoint >= 0x7F && codepoint <= 0xA0) || (codepoint >= 0x200B && codepoint <= 0x200F)
+        || (codepoint >= 0x2028 && codepoint <= 0x202E) || (codepoint >= 0x2060 && codepoint <= 0x206F)
+        || (codepoint >= 0xFE00 && codepoint <= 0xFE0F) || codepoint == 0xFEFF
+        || (codepoint >= 0xE0100 && codepoint <= 0xE01EF);
+}
+
+// Lower is better: an italic mismatch outweighs any weight difference, and among equally distant
+// weights the CSS direction wins (lighter when asking for up to 500, heavier above).
+static int StyleDistance(const FontFace &face, int weight, bool italic) {
+    int distance = std::abs(face.weight - weight) * 2;
+    if (weight <= 500 ? face.weight > weight : face.weight < weight) {
+        distance++;
+    }
+    return distance + (face.italic != italic ? 10000 : 0);
+}
+
+static bool ParseFile(FontFace &face) {
+#ifndef _WIN32
+    int fd = ::open(face.path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info{};
+    bool parsed = false;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        auto length = static_cast<size_t>(info.st_size);
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping != MAP_FAILED) {
+            parsed = FontIndex::parse(static_cast<const uint8_t *>(mapping), length, face);
+            munmap(mapping, length);
+        }
+    }
+    close(fd);
+    return parsed;
+#else
+    std::ifstream in(fs::u8path(face.path), std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return FontIndex::parse(reinterpret_cast<const uint8_t *>(data.data()), data.size(), face);
+#endif
+}
+
+UefFontLoader::UefFontLoader(std::vector<fs::path> directories, fs::path indexFile)
+    : directories_(std::move(directories)), indexFile_(std::move(indexFile)) {
+}
+
+bool UefFontLoader::install(std::vector<fs::path> directories, fs::path indexFile, String &error) {
+    // Covers the checks and the publication, so two callers cannot both install a loader.
+    std::lock_guard<std::mutex> lock(installMutex_);
+    if (UefRenderer::renderer_) {
+        error = "The font directories must be set before the Renderer is created";
+        return false;
+    }
+    if (installed()) {
+        error = "The font directories are already set";
+        return false;
+    }
+
+    auto loader = new UefFontLoader(std::move(directories), std::move(indexFile));
+    Platform::instance().set_font_loader(loader);
+    instance_.store(loader, std::memory_order_release);
+    WorkerPool::shared().submit([loader] { loader->scan(); });
+    return true;
+}
+
+std::vector<fs::path> UefFontLoader::systemDirectories() {
+    std::vector<fs::path> directories;
+#if defined(_WIN32)
+    if (const char *windows = std::getenv("WINDIR")) {
+        directories.push_back(fs::u8path(windows) / "Fonts");
+    }
+    if (const char *local = std::getenv("LOCALAPPDATA")) {
+        directories.push_back(fs::u8path(local) / "Microsoft" / "Windows" / "Fonts");
+    }
+#elif defined(__APPLE__)
+    directories.emplace_back("/System/Library/Fonts");
+    directories.emplace_back("/Library/Fonts");
+    if (const char *home = std::getenv("HOME")) {
+        directories.push_back(fs::u8path(home) / "Library" / "Fonts");
+    }
+#else
+    directories.emplace_back("/usr/share/fonts");
+    directories.emplace_back("/usr/local/share/fonts");
+    if (const char *home = std::getenv("HOME")) {
+        directories.push_back(fs::u8path(home) / ".local" / "share" / "fonts");
+        directories.push_back(fs::u8path(home) / ".fonts");
+    }
+#endif
+    return directories;
+}
+
+void UefFontLoader::scan() {
+    buildIndex();
+    if (families_.empty()) {
+        std::vector<fs::path> system = systemDirectories();
+        if (directories_ != system) {
+            // Nothing usable below the given directories; the system's fonts beat rendering no text.
+            directories_ = std::move(system);
+            buildIndex();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        ready_.store(true, std::memory_order_release);
+    }
+    readyChanged_.notify_all();
+}
+
+void UefFontLoader::waitReady() const {
+    if (ready_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(readyMutex_);
+    readyChanged_.wait(lock, [this] { return ready_.load(std::memory_order_acquire); });
+}
+
+void UefFontLoader::buildIndex() {
+    std::vector<FontFace> previous;
+    if (!indexFile_.empty()) {
+        FontIndex::read(indexFile_, previous);
+    }
+    std::unordered_map<std::string, FontFace *> known;
+    for (FontFace &face : previous) {
+        known.emplace(face.path, &face);
+    }
+
+    // Unchanged files are taken from the saved index; only new and modified ones are parsed.
+    std::vector<FontFace> faces;
+    std::vector<size_t> changed;
+    std::unordered_set<std::string> seen;
+    for (const fs::path &directory : directories_) {
+        std::error_code error;
+        auto options = fs::directory_options::skip_permission_denied | fs::directory_options::follow_directory_symlink;
+        for (fs::recursive_directory_iterator it(directory, options, error), end; !error && it != end; it.increment(error)) {
+            std::error_code fileError;
+            if (!it->is_regular_file(fileError) || !IsFontFile(it->path())) {
+                continue;
+            }
+            FontFace face;
+            face.path = it->path().u8string();
+            face.size = it->file_size(fileError);
+            face.modified = static_cast<int64_t>(it->last_write_time(fileError).time_since_epoch().count());
+            if (fileError || !seen.insert(face.path).second) {
+                continue;
+            }
+
+            auto cached = known.find(face.path);
+            if (cached != known.end() && cached->second->size == face.size && cached->second->modified == face.modified) {
+                faces.push_back(std::move(*cached->second));
+            } else {
+                changed.push_back(faces.size());
+                faces.push_back(std::move(face));
+            }
+        }
+    }
+
+    WorkerPool::shared().parallelFor(changed.size(), [&](size_t i) {
+        FontFace &face = faces[changed[i]];
+        // Files that are not fonts stay in the index with no family, so they are not parsed again next time.
+        if (!ParseFile(face)) {
+            face.family.clear();
+            face.legacyFamily.clear();
+            face.coverage = FontCoverage();
+        }
+    });
+
+    if (!indexFile_.empty() && (!changed.empty() || faces.size() != previous.size())) {
+        std::error_code error;
+        fs::create_directories(indexFile_.parent_path(), error);
+        FontIndex::write(indexFile_, faces);
+    }
+
+    faces_ = std::move(faces);
+    families_.clear();
+    pages_.clear();
+    for (uint32_t i = 0; i < faces_.size(); i++) {
+        const FontFace &face = faces_[i];
+        if (face.family.empty()) {
+            continue;
+        }
+        families_[Fold(face.family)].push_back(i);
+        if (!face.legacyFamily.empty()) {
+            families_[Fold(face.legacyFamily)].push_back(i);
+        }
+        for (uint16_t page : face.coverage.pages()) {
+            pages_[page].push_back(i);
+        }
+    }
+
+    static const char *const kPreferredFallbacks[] = {
+        "Arial", "Helvetica", "Segoe UI", "Liberation Sans", "DejaVu Sans", "Noto Sans", "Roboto",
+    };
+    for (const char *family : kPreferredFallbacks) {
+        if (families_.count(Fold(family))) {
+            fallback_ = family;
+            break;
+        }
+    }
+    if (fallback_.empty()) {
+        // No well-known sans: whichever face covers the most of Latin-1, or failing that the most
+        // characters at all, so the default is always a family Load can find.
+        const FontFace *widest = nullptr;
+        size_t widestLatin = 0;
+        for (const FontFace &face : faces_) {
+            if (face.family.empty()) {
+                continue;
+            }
+            size_t latin = 0;
+            for (uint32_t codepoint = 0x20; codepoint < 0x100; codepoint++) {
+                latin += face.coverage.contains(codepoint);
+            }
+            if (!widest || latin > widestLatin || (latin == widestLatin && face.coverage.count() > widest->coverage.count())) {
+                widest = &face;
+                widestLatin = latin;
+            }
+        }
+        if (widest) {
+            fallback_ = String(widest->family.data(), widest->family.size());
+        }
+    }
+}
+
+const FontFace *UefFontLoader::match(const std::string &family, int weight, bool italic) const {
+    auto found = families_.find(Fold(family));
+    if (found == families_.end()) {
+        return nullptr;
+    }
+    const FontFace *best = nullptr;
+    int bestDistance = 0;
+    for (uint32_t index : found->second) {
+        int distance = StyleDistance(faces_[index], weight, italic);
+        if (!best || distance < bestDistance) {
+            best = &faces_[index];
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+String UefFontLoader::fallback_font() const {
+    waitReady();
+    return fallback_;
+}
+
+String UefFontLoader::fallback_font_for_characters(const String &characters, int weight, bool italic) const {
+    waitReady();
+
+    String16 utf16 = characters.utf16();
+    const Char16 *units = utf16.data();
+    size_t length = utf16.length();
+    std::vector<uint32_t> codepoints;
+    for (size_t i = 0; i < length && codepoints.size() < kMaxFallbackCharacters; i++) {
+        uint32_t codepoint = units[i];
+        if (codepoint >= 0xD800 && codepoint < 0xDC00 && i + 1 < length && units[i + 1] >= 0xDC00 && units[i + 1] < 0xE000) {
+            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (units[++i] - 0xDC00);
+        }
+        if (!IsInvisible(codepoint) && std::find(codepoints.begin(), codepoints.end(), codepoint) == codepoints.end()) {
+            codepoints.push_back(codepoint);
+        }
+    }
+    if (codepoints.empty()) {
+        return fallback_;
+    }
+
+    std::string key(reinterpret_cast<const char *>(codepoints.data()), codepoints.size() * sizeof(uint32_t));
+    key += static_cast<char>(italic);
+    key.append(reinterpret_cast<const char *>(&weight), sizeof(weight));
+    {
+        std::lock_guard<std::mutex> lock(fallbacksMutex_);
+        auto remembered = fallbacks_.find(key);
+        if (remembered != fallbacks_.end()) {
+            return remembered->second;
+        }
+    }
+
+    // Only faces with something on the first character's page can cover it at all.
+    const FontFace *best = nullptr;
+    size_t bestCovered = 0;
+    int bestDistance = 0;
+    bool bestDefault = false;
+    const String8 &fallback = fallback_.utf8();
+    auto candidates = pages_.find(static_cast<uint16_t>(codepoints[0] >> 8));
+    if (candidates != pages_.end()) {
+        for (uint32_t index : candidates->second) {
+            const FontFace &face = faces_[index];
+            size_t covered = 0;
+            for (uint32_t codepoint : codepoints) {
+                covered += face.coverage.contains(codepoint);
+            }
+            if (!covered) {
+                continue;
+            }
+            // Most characters covered, then the closest style, then the default family, then the broadest
+            // font, so a run keeps to one font instead of patching several together.
+            int distance = StyleDistance(face, weight, italic);
+            bool isDefault = face.family.size() == fallback.length()
+                && face.family.compare(0, face.family.size(), fallback.data(), fallback.length()) == 0;
+            if (!best || covered > bestCovered || (covered == bestCovered && (distance < bestDistance
+                || (distance == bestDistance && (isDefault > bestDefault
+                || (isDefault == bestDefault && face.coverage.count() > best->coverage.count())))))) {
+                best = &face;
+                bestCovered = covered;
+                bestDistance = distance;
+                bestDefault = isDefault;
+            }
+        }
+    }
+    String family = best ? String(best->family.data(), best->family.size()) : fallback_;
+
+    std::lock_guard<std::mutex> lock(fallbacksMutex_);
+    if (fallbacks_.size() >= kMaxRememberedFallbacks) {
+        fallbacks_.clear();
+    }
+    fallbacks_.emplace(std::move(key), family);
+    return family;
+}
+
+RefPtr<FontFile> UefFontLoader::Load(const String &family, int weight, bool italic) {
+    waitReady();
+
+    const String8 &utf8 = family.utf8();
+    const FontFace *face = match(std::string(utf8.data(), utf8.length()), weight, italic);
+    if (!face) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(filesMutex_);
+    auto loaded = files_.find(face->path);
+    if (loaded != files_.end()) {
+        return loaded->second;
+    }
+
+    RefPtr<FontFile> file;
+#ifndef _WIN32
+    int fd = ::open(face->path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        auto length = static_cast<size_t>(info.st_size);
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping != MAP_FAILED) {
+            file = FontFile::Create(Buffer::Create(mapping, length, reinterpret_cast<void *>(static_cast<uintptr_t>(length)), Unmap));
+        }
+    }
+    close(fd);
+#else
+    file = FontFile::Create(String(face->path.data(), face->path.size()));
+#endif
+    if (file) {
+        files_.emplace(face->path, file);
+    }
+    return file;
+}
+
+void Java_net_rk4z_juef_UefPlatform_setFontDirectories(JNIEnv *env, jclass obj, jobjectArray directories) {
+    std::vector<fs::path> paths;
+    jsize count = directories ? env->GetArrayLength(directories) : 0;
+    for (jsize i = 0; i < count; i++) {
+        auto element = static_cast<jstring>(env->GetObjectArrayElement(directories, i));
+        String directory = ConvertJavaStringToCpp(env, element);
+        paths.push_back(fs::u8path(std::string(directory.utf8().data(), directory.utf8().length())));
+        env->DeleteLocalRef(element);
+    }
+    if (paths.empty()) {
+        paths = UefFontLoader::systemDirectories();
+    }
+
+    fs::path indexFile;
+    const String &cachePath = Platform::instance().config().cache_path;
+    if (!cachePath.empty()) {
+        indexFile = fs::u8path(cachePath.utf8().data()) / "fonts" / "index.uefi";
+    }
+    String error;
+    if (!UefFontLoader::install(std::move(paths), std::move(indexFile), error)) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, error.utf8().data());
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef UEFFONTLOADER_HPP
+#define UEFFONTLOADER_HPP
+
+#include "FontIndex.hpp"
+
+#include <jni.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Ultralight/platform/FontLoader.h>
+
+using namespace ultralight;
+
+/**
+ * The engine's FontLoader, backed by an index of every font below a set of directories. The index is
+ * built once on the WorkerPool as soon as the loader is installed: families, weights and italics for
+ * Load, and each face's cmap coverage for fallback_font_for_characters, which then only looks at the
+ * faces touching the first character's 256-codepoint page.
+ *
+ * The index is saved below the cache path; on the next start only files whose size or modification
+ * time changed are parsed again. Engine calls made before the first scan finishes wait for it. When
+ * the directories hold no font at all, the operating system's own directories are indexed instead.
+ */
+class UefFontLoader : public FontLoader {
+public:
+    String fallback_font() const override;
+    String fallback_font_for_characters(const String &characters, int weight, bool italic) const override;
+    RefPtr<FontFile> Load(const String &family, int weight, bool italic) override;
+
+    static bool installed() { return instance_.load(std::memory_order_acquire) != nullptr; }
+    // Sets the platform's font loader and starts the scan. Fails once the Renderer exists or when a loader
+    // is already set. indexFile may be empty to keep nothing on disk.
+    static bool install(std::vector<std::filesystem::path> directories, std::filesystem::path indexFile, String &error);
+    // Where fonts live on this OS, for when no directories are given.
+    static std::vector<std::filesystem::path> systemDirectories();
+
+private:
+    UefFontLoader(std::vector<std::filesystem::path> directories, std::filesystem::path indexFile);
+
+    void scan();
+    void buildIndex();
+    void waitReady() const;
+    // The face of the family that best matches the requested style, nullptr for an unknown family.
+    const FontFace *match(const std::string &family, int weight, bool italic) const;
+
+    std::vector<std::filesystem::path> directories_;
+    std::filesystem::path indexFile_;
+
+    // Written by scan() before ready_ is set, read-only afterwards.
+    std::vector<FontFace> faces_;
+    std::unordered_map<std::string, std::vector<uint32_t>> families_;
+    std::unordered_map<uint16_t, std::vector<uint32_t>> pages_;
+    String fallback_;
+
+    mutable std::mutex readyMutex_;
+    mutable std::condition_variable readyChanged_;
+    std::atomic<bool> ready_{false};
+
+    // Fonts stay mapped once loaded; a page needs a handful of them.
+    std::mutex filesMutex_;
+    std::unordered_map<std::string, RefPtr<FontFile>> files_;
+
+    mutable std::mutex fallbacksMutex_;
+    mutable std::unordered_map<std::string, String> fallbacks_;
+
+    static std::mutex installMutex_;
+    static std::atomic<UefFontLoader *> instance_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_setFontDirectories(JNIEnv *env, jclass obj, jobjectArray directories);
+}
+
+#endif //UEFFONTLOADER_HPP
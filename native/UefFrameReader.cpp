@@ -0,0 +1,57 @@
+#include "UefFrameReader.hpp"
+
+jlong UefFrameReader::open(const std::shared_ptr<FrameExchange> &exchange) {
+    return reinterpret_cast<jlong>(new std::shared_ptr<FrameExchange>(exchange));
+}
+
+FrameExchange *UefFrameReader::get(jlong pointer) {
+    return pointer ? reinterpret_cast<std::shared_ptr<FrameExchange> *>(pointer)->get() : nullptr;
+}
+
+jboolean Java_net_rk4z_juef_UefFrameReader_acquire(JNIEnv *env, jclass obj, jlong pointer, jlongArray info) {
+    FrameExchange *exchange = UefFrameReader::get(pointer);
+    FrameInfo frame{};
+    if (!exchange || !exchange->acquire(frame)) {
+        return JNI_FALSE;
+    }
+
+    jlong values[UEF_FRAME_INFO_LENGTH] = {
+        frame.index, frame.generation, frame.width, frame.height, frame.rowBytes,
+        static_cast<jlong>(frame.number), frame.fresh ? 1 : 0,
+    };
+    env->SetLongArrayRegion(info, 0, UEF_FRAME_INFO_LENGTH, values);
+    return JNI_TRUE;
+}
+
+jobject Java_net_rk4z_juef_UefFrameReader_buffer(JNIEnv *env, jclass obj, jlong pointer, jint index, jint generation) {
+    FrameExchange *exchange = UefFrameReader::get(pointer);
+    if (!exchange) {
+        return nullptr;
+    }
+
+    size_t size = 0;
+    void *pixels = exchange->buffer(static_cast<uint32_t>(index), static_cast<uint32_t>(generation), size);
+    if (!pixels) {
+        return nullptr;
+    }
+    return env->NewDirectByteBuffer(pixels, static_cast<jlong>(size));
+}
+
+void Java_net_rk4z_juef_UefFrameReader_stats(JNIEnv *env, jclass obj, jlong pointer, jlongArray stats) {
+    FrameExchange *exchange = UefFrameReader::get(pointer);
+    if (!exchange) {
+        return;
+    }
+
+    FrameStats current = exchange->stats();
+    jlong values[UEF_FRAME_STATS_LENGTH] = {
+        static_cast<jlong>(current.published), static_cast<jlong>(current.acquired),
+        static_cast<jlong>(current.superseded), static_cast<jlong>(current.lastLatencyNanos),
+        static_cast<jlong>(current.maxLatencyNanos), static_cast<jlong>(current.totalLatencyNanos),
+    };
+    env->SetLongArrayRegion(stats, 0, UEF_FRAME_STATS_LENGTH, values);
+}
+
+void Java_net_rk4z_juef_UefFrameReader_close(JNIEnv *env, jclass obj, jlong pointer) {
+    delete reinterpret_cast<std::shared_ptr<FrameExchange> *>(pointer);
+}
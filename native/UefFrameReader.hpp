@@ -0,0 +1,32 @@
+#ifndef UEFFRAMEREADER_HPP
+#define UEFFRAMEREADER_HPP
+
+#include <jni.h>
+#include <memory>
+#include "TripleBufferedSurface.hpp"
+
+#define UEF_FRAME_INFO_LENGTH 7
+#define UEF_FRAME_STATS_LENGTH 6
+
+/**
+ * Native side of UefFrameReader: a heap-allocated shared_ptr to the View's FrameExchange, so the
+ * buffers outlive the View until the reader is closed. Unlike everything else in the binding these
+ * functions may be called from any thread.
+ */
+class UefFrameReader {
+public:
+    static jlong open(const std::shared_ptr<FrameExchange> &exchange);
+    static FrameExchange *get(jlong pointer);
+};
+
+extern "C" {
+    JNIEXPORT jboolean JNICALL Java_net_rk4z_juef_UefFrameReader_acquire(JNIEnv *env, jclass obj, jlong pointer, jlongArray info);
+
+    JNIEXPORT jobject JNICALL Java_net_rk4z_juef_UefFrameReader_buffer(JNIEnv *env, jclass obj, jlong pointer, jint index, jint generation);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefFrameReader_stats(JNIEnv *env, jclass obj, jlong pointer, jlongArray stats);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefFrameReader_close(JNIEnv *env, jclass obj, jlong pointer);
+}
+
+#endif //UEFFRAMEREADER_HPP
@@ -1,92 +1,54 @@
 #include "UefPlatform.hpp"
-#include "Utils.hpp"
+#include "EngineAllocator.hpp"
+#include "JniRegistry.hpp"
+#include "PackedConfig.hpp"
+#include "SurfaceFactory.hpp"
+#include "UefRenderer.hpp"
+#include "EnumMapping.hpp"
 #include <Ultralight/platform/Config.h>
 
+jlong UefPlatform::configVersion_ = 0;
+
 void UefPlatform::setConfig(const Config& config) {
     Platform::instance().set_config(config);
 }
 
-void Java_net_rk4z_juef_UefPlatform_setConfig(JNIEnv *env, jobject obj, jobject config) {
-    jclass configClass = env->GetObjectClass(config);
-
-    jfieldID cachePathField = env->GetFieldID(configClass, "cachePath", "Ljava/lang/String;");
-    jfieldID resourcePathPrefixField = env->GetFieldID(configClass, "resourcePathPrefix", "Ljava/lang/String;");
-    jfieldID faceWindingField = env->GetFieldID(configClass, "faceWinding", "Lnet/rk4z/juef/util/FaceWinding;");
-    jfieldID fontHintingField = env->GetFieldID(configClass, "fontHinting", "Lnet/rk4z/juef/util/FontHinting;");
-    jfieldID fontGammaField = env->GetFieldID(configClass, "fontGamma", "D");
-    jfieldID userStylesheetField = env->GetFieldID(configClass, "userStylesheet", "Ljava/lang/String;");
-    jfieldID forceRepaintField = env->GetFieldID(configClass, "forceRepaint", "Z");
-    jfieldID animationTimerDelayField = env->GetFieldID(configClass, "animationTimerDelay", "D");
-    jfieldID scrollTimerDelayField = env->GetFieldID(configClass, "scrollTimerDelay", "D");
-    jfieldID recycleDelayField = env->GetFieldID(configClass, "recycleDelay", "D");
-    jfieldID memoryCacheSizeField = env->GetFieldID(configClass, "memoryCacheSize", "J");
-    jfieldID pageCacheSizeField = env->GetFieldID(configClass, "pageCacheSize", "J");
-    jfieldID overrideRamSizeField = env->GetFieldID(configClass, "overrideRamSize", "J");
-    jfieldID minLargeHeapSizeField = env->GetFieldID(configClass, "minLargeHeapSize", "J");
-    jfieldID minSmallHeapSizeField = env->GetFieldID(configClass, "minSmallHeapSize", "J");
-    jfieldID numRendererThreadsField = env->GetFieldID(configClass, "numRendererThreads", "J");
-    jfieldID maxUpdateTimeField = env->GetFieldID(configClass, "maxUpdateTime", "D");
-    jfieldID bitmapAlignmentField = env->GetFieldID(configClass, "bitmapAlignment", "J");
-    jfieldID effectQualityField = env->GetFieldID(configClass, "effectQuality", "Lnet/rk4z/juef/util/EffectQuality;");
-
-    auto cachePathJava = (jstring) env->GetObjectField(config, cachePathField);
-    auto resourcePathPrefixJava = (jstring) env->GetObjectField(config, resourcePathPrefixField);
-    jdouble fontGamma = env->GetDoubleField(config, fontGammaField);
-    auto userStylesheetJava = (jstring) env->GetObjectField(config, userStylesheetField);
-    jboolean forceRepaint = env->GetBooleanField(config, forceRepaintField);
-    jdouble animationTimerDelay = env->GetDoubleField(config, animationTimerDelayField);
-    jdouble scrollTimerDelay = env->GetDoubleField(config, scrollTimerDelayField);
-    jdouble recycleDelay = env->GetDoubleField(config, recycleDelayField);
-    jlong memoryCacheSize = env->GetLongField(config, memoryCacheSizeField);
-    jlong pageCacheSize = env->GetLongField(config, pageCacheSizeField);
-    jlong overrideRamSize = env->GetLongField(config, overrideRamSizeField);
-    jlong minLargeHeapSize = env->GetLongField(config, minLargeHeapSizeField);
-    jlong minSmallHeapSize = env->GetLongField(config, minSmallHeapSizeField);
-    jlong numRendererThreads = env->GetLongField(config, numRendererThreadsField);
-    jdouble maxUpdateTime = env->GetDoubleField(config, maxUpdateTimeField);
-    jlong bitmapAlignment = env->GetLongField(config, bitmapAlignmentField);
-
-    const char *cachePathCStr = env->GetStringUTFChars(cachePathJava, nullptr);
-    String cachePath(cachePathCStr);
-    env->ReleaseStringUTFChars(cachePathJava, cachePathCStr);
-
-    const char *resourcePathPrefixCStr = env->GetStringUTFChars(resourcePathPrefixJava, nullptr);
-    String resourcePathPrefix(resourcePathPrefixCStr);
-    env->ReleaseStringUTFChars(resourcePathPrefixJava, resourcePathPrefixCStr);
+void Java_net_rk4z_juef_UefPlatform_setConfig(JNIEnv *env, jclass obj, jobject config, jlong configVersion) {
+    if (configVersion != 0 && configVersion == UefPlatform::configVersion_) {
+        return;
+    }
 
-    const char *userStylesheetCStr = env->GetStringUTFChars(userStylesheetJava, nullptr);
-    String userStylesheet(userStylesheetCStr);
-    env->ReleaseStringUTFChars(userStylesheetJava, userStylesheetCStr);
-
-    jobject javaFaceWinding = env->GetObjectField(config, faceWindingField);
-    FaceWinding faceWinding = ConvertJavaFaceWindingToCpp(env, javaFaceWinding);
-
-    jobject javaFontHinting = env->GetObjectField(config, fontHintingField);
-    FontHinting fontHinting = ConvertJavaFontHintingToCpp(env, javaFontHinting);
-
-    jobject javaEffectQuality = env->GetObjectField(config, effectQualityField);
-    EffectQuality effectQuality = ConvertJavaEffectQualityToCpp(env, javaEffectQuality);
+    auto data = static_cast<const uint8_t *>(env->GetDirectBufferAddress(config));
+    auto size = static_cast<size_t>(env->GetDirectBufferCapacity(config));
 
     Config UefConfig;
-    UefConfig.cache_path = cachePath;
-    UefConfig.resource_path_prefix = resourcePathPrefix;
-    UefConfig.face_winding = faceWinding;
-    UefConfig.font_hinting = fontHinting;
-    UefConfig.font_gamma = fontGamma;
-    UefConfig.user_stylesheet = userStylesheet;
-    UefConfig.force_repaint = static_cast<bool>(forceRepaint);
-    UefConfig.animation_timer_delay = animationTimerDelay;
-    UefConfig.scroll_timer_delay = scrollTimerDelay;
-    UefConfig.recycle_delay = recycleDelay;
-    UefConfig.memory_cache_size = memoryCacheSize;
-    UefConfig.page_cache_size = pageCacheSize;
-    UefConfig.override_ram_size = overrideRamSize;
-    UefConfig.min_large_heap_size = minLargeHeapSize;
-    UefConfig.min_small_heap_size = minSmallHeapSize;
-    UefConfig.num_renderer_threads = numRendererThreads;
-    UefConfig.max_update_time = maxUpdateTime;
-    UefConfig.bitmap_alignment = bitmapAlignment;
-    UefConfig.effect_quality = effectQuality;
+    AllocatorMode allocator = AllocatorMode::System;
+    if (!DecodeConfig(data, size, UefConfig, allocator)) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Malformed packed UefConfig");
+        return;
+    }
+
+    // Before anything below reaches into the engine, so that as little as possible predates the switch.
+    if (allocator != EngineAllocator::mode()) {
+        if (UefRenderer::renderer_) {
+            env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "The allocator must be chosen before the Renderer is created");
+            return;
+        }
+        if (!EngineAllocator::install(allocator)) {
+            env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "The pooled allocator cannot be replaced once installed");
+            return;
+        }
+    }
 
     UefPlatform::setConfig(UefConfig);
+    UefPlatform::configVersion_ = configVersion;
 }
+
+void Java_net_rk4z_juef_UefPlatform_setSurfaceFactory(JNIEnv *env, jclass obj, jobject type, jint tileSize) {
+    if (UefRenderer::renderer_) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "The surface factory must be set before the Renderer is created");
+        return;
+    }
+
+    UefSurfaceFactory::install(ConvertJavaEnumToCpp<SurfaceType>(env, type), tileSize > 0 ? static_cast<uint32_t>(tileSize) : 64);
+}
\ No newline at end of file
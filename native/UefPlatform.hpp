@@ -8,11 +8,15 @@ using namespace ultralight;
 
 class UefPlatform {
 public:
+    static jlong configVersion_;
+
     static void setConfig(const Config& config);
 };
 
 extern "C" {
-    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_setConfig(JNIEnv *env, jobject obj, jobject config);
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_setConfig(JNIEnv *env, jclass obj, jobject config, jlong configVersion);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_setSurfaceFactory(JNIEnv *env, jclass obj, jobject type, jint tileSize);
 }
 
 #endif //UEFPLATFORM_HPP
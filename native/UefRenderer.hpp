@@ -2,6 +2,7 @@
 #define UEFRENDERER_HPP
 
 #include <jni.h>
+#include <thread>
 #include <Ultralight/Renderer.h>
 
 using namespace ultralight;
@@ -10,16 +11,27 @@ class UefRenderer {
 public:
     static RefPtr<Session> session_;
     static RefPtr<Renderer> renderer_;
+    static std::thread::id thread_;
 
     static void create();
     static void refreshDisplay(int displayId);
+    static void update();
+    static void render();
     static RefPtr<View> createView(int width, int height, const ViewConfig &config, const RefPtr<Session>& session = nullptr);
+
+    static bool isRendererThread() { return std::this_thread::get_id() == thread_; }
 };
 
 extern "C" {
     JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_create(JNIEnv *env, jclass obj);
 
-    JNIEXPORT jobject JNICALL Java_net_rk4z_juef_UefRenderer_createView(JNIEnv *env, jclass obj, jint width, jint height, jobject config, jobject session);
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_refreshDisplay(JNIEnv *env, jclass obj, jint displayId);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_update(JNIEnv *env, jclass obj);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_render(JNIEnv *env, jclass obj);
+
+    JNIEXPORT jobject JNICALL Java_net_rk4z_juef_UefRenderer_createView(JNIEnv *env, jclass obj, jint width, jint height, jobject config, jlong configVersion, jobject session);
 }
 
 #endif //UEFRENDERER_HPP
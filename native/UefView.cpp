@@ -1 +1,159 @@
 #include "UefView.hpp"
+#include "DisplayClock.hpp"
+#include "JniRegistry.hpp"
+#include "SurfaceFactory.hpp"
+#include "UefFrameReader.hpp"
+#include "UefRenderer.hpp"
+#include "ViewRegistry.hpp"
+
+View *UefView::lookup(JNIEnv *env, jlong handle) {
+    View *view = ViewRegistry::get(handle);
+    if (!view) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "UefView has already been released");
+    }
+    return view;
+}
+
+Surface *UefView::lookupSurface(JNIEnv *env, jlong handle) {
+    View *view = lookup(env, handle);
+    if (!view) {
+        return nullptr;
+    }
+
+    Surface *surface = view->surface();
+    if (!surface) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "UefView has no Surface (accelerated Views render to a texture)");
+    }
+    return surface;
+}
+
+void UefView::release(jlong handle) {
+    if (UefRenderer::isRendererThread()) {
+        ViewRegistry::remove(handle);
+    } else {
+        ViewRegistry::enqueueRelease(handle);
+    }
+}
+
+void UefView::collectDamage(ViewSlot *slot, Surface *surface) {
+    IntRect dirty = surface->dirty_bounds();
+    if (dirty.IsEmpty()) {
+        return;
+    }
+    surface->ClearDirtyBounds();
+
+    slot->lockDamage.Join(dirty);
+    if (slot->delta) {
+        slot->deltaDamage.Join(dirty);
+    }
+}
+
+void Java_net_rk4z_juef_UefView_focus(JNIEnv *env, jclass obj, jlong handle) {
+    if (View *view = UefView::lookup(env, handle)) {
+        view->Focus();
+        DisplayClock::wake(view->display_id());
+    }
+}
+
+void Java_net_rk4z_juef_UefView_unFocus(JNIEnv *env, jclass obj, jlong handle) {
+    if (View *view = UefView::lookup(env, handle)) {
+        view->Unfocus();
+        DisplayClock::wake(view->display_id());
+    }
+}
+
+jboolean Java_net_rk4z_juef_UefView_hasFocus(JNIEnv *env, jclass obj, jlong handle) {
+    View *view = UefView::lookup(env, handle);
+    return view && view->HasFocus();
+}
+
+jobject Java_net_rk4z_juef_UefView_lockSurface(JNIEnv *env, jclass obj, jlong handle, jintArray info) {
+    Surface *surface = UefView::lookupSurface(env, handle);
+    if (!surface) {
+        return nullptr;
+    }
+
+    if (UefSurfaceFactory::asTripleBuffered(surface)) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "Triple-buffered surfaces are read through UefView#openFrameReader()");
+        return nullptr;
+    }
+
+    ViewSlot *slot = ViewRegistry::slot(handle);
+    if (slot->surfaceLocked) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "UefView surface is already locked");
+        return nullptr;
+    }
+
+    void *pixels = surface->LockPixels();
+    slot->surfaceLocked = true;
+
+    UefView::collectDamage(slot, surface);
+    IntRect dirty = slot->lockDamage;
+    slot->lockDamage.SetEmpty();
+
+    jint tileSize = 0;
+    slot->dirtyTiles.clear();
+    if (TiledSurface *tiled = UefSurfaceFactory::asTiled(surface)) {
+        tiled->takeDirtyTiles(slot->dirtyTiles);
+        tileSize = static_cast<jint>(tiled->tileSize());
+    }
+
+    jint values[UEF_SURFACE_INFO_LENGTH] = {
+        static_cast<jint>(surface->width()), static_cast<jint>(surface->height()),
+        static_cast<jint>(surface->row_bytes()), dirty.left, dirty.top, dirty.right, dirty.bottom,
+        static_cast<jint>(slot->dirtyTiles.size()), tileSize,
+    };
+    env->SetIntArrayRegion(info, 0, UEF_SURFACE_INFO_LENGTH, values);
+
+    // Java keeps the previous buffer; only wrap the pixels again when the backing store moved.
+    if (pixels == slot->surfacePixels && surface->size() == slot->surfaceSize) {
+        return nullptr;
+    }
+
+    slot->surfacePixels = pixels;
+    slot->surfaceSize = surface->size();
+    return env->NewDirectByteBuffer(pixels, static_cast<jlong>(surface->size()));
+}
+
+void Java_net_rk4z_juef_UefView_unlockSurface(JNIEnv *env, jclass obj, jlong handle) {
+    ViewSlot *slot = ViewRegistry::slot(handle);
+    if (!slot || !slot->surfaceLocked) {
+        return;
+    }
+
+    slot->surfaceLocked = false;
+    if (Surface *surface = slot->view->surface()) {
+        surface->UnlockPixels();
+    }
+}
+
+void Java_net_rk4z_juef_UefView_copyDirtyTiles(JNIEnv *env, jclass obj, jlong handle, jintArray tiles) {
+    ViewSlot *slot = ViewRegistry::slot(handle);
+    if (!slot) {
+        return;
+    }
+
+    auto count = static_cast<jsize>(slot->dirtyTiles.size());
+    if (count > env->GetArrayLength(tiles)) {
+        count = env->GetArrayLength(tiles);
+    }
+    env->SetIntArrayRegion(tiles, 0, count, slot->dirtyTiles.data());
+}
+
+jlong Java_net_rk4z_juef_UefView_openFrameReader(JNIEnv *env, jclass obj, jlong handle) {
+    Surface *surface = UefView::lookupSurface(env, handle);
+    if (!surface) {
+        return 0;
+    }
+
+    TripleBufferedSurface *tripleBuffered = UefSurfaceFactory::asTripleBuffered(surface);
+    if (!tripleBuffered) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "Frame readers need SurfaceType.TripleBuffered");
+        return 0;
+    }
+    return UefFrameReader::open(tripleBuffered->exchange());
+}
+
+void Java_net_rk4z_juef_UefView_release(JNIEnv *env, jclass obj, jlong handle) {
+    UefView::release(handle);
+}
\ No newline at end of file
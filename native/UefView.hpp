@@ -4,14 +4,39 @@
 #include <jni.h>
 #include <Ultralight/View.h>
 
+#define UEF_SURFACE_INFO_LENGTH 9
+
+using namespace ultralight;
+
+struct ViewSlot;
+
 class UefView {
 public:
-    void focus();
-    void unFocus();
+    static View *lookup(JNIEnv *env, jlong handle);
+    static Surface *lookupSurface(JNIEnv *env, jlong handle);
+    static void release(jlong handle);
+
+    // Moves the surface's dirty_bounds() into the damage of every consumer of the slot (lockSurface
+    // and, once created, the DeltaEncoder), so reading one does not discard the other's.
+    static void collectDamage(ViewSlot *slot, Surface *surface);
 };
 
 extern "C" {
-    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_focus(JNIEnv *env, jclass obj);
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_focus(JNIEnv *env, jclass obj, jlong handle);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_unFocus(JNIEnv *env, jclass obj, jlong handle);
+
+    JNIEXPORT jboolean JNICALL Java_net_rk4z_juef_UefView_hasFocus(JNIEnv *env, jclass obj, jlong handle);
+
+    JNIEXPORT jobject JNICALL Java_net_rk4z_juef_UefView_lockSurface(JNIEnv *env, jclass obj, jlong handle, jintArray info);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_unlockSurface(JNIEnv *env, jclass obj, jlong handle);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_copyDirtyTiles(JNIEnv *env, jclass obj, jlong handle, jintArray tiles);
+
+    JNIEXPORT jlong JNICALL Java_net_rk4z_juef_UefView_openFrameReader(JNIEnv *env, jclass obj, jlong handle);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_release(JNIEnv *env, jclass obj, jlong handle);
 }
 
 #endif //UEFVIEW_HPP
@@ -1,63 +1,48 @@
 #include "Utils.hpp"
 
-#include <cstring>
+#include <cstdlib>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 FaceWinding ConvertJavaFaceWindingToCpp(JNIEnv *env, jobject javaFaceWinding) {
-    jclass enumClass = env->GetObjectClass(javaFaceWinding);
-    jmethodID toStringMethod = env->GetMethodID(enumClass, "toString", "()Ljava/lang/String;");
-
-    auto enumNameJava = (jstring) env->CallObjectMethod(javaFaceWinding, toStringMethod);
-    const char *enumNameCStr = env->GetStringUTFChars(enumNameJava, nullptr);
+    return ConvertJavaEnumToCpp<FaceWinding>(env, javaFaceWinding);
+}
 
-    FaceWinding faceWinding;
-    if (strcmp(enumNameCStr, "CounterClockwise") == 0) {
-        faceWinding = FaceWinding::CounterClockwise;
-    } else {
-        faceWinding = FaceWinding::Clockwise;
-    }
+FontHinting ConvertJavaFontHintingToCpp(JNIEnv *env, jobject javaFontHinting) {
+    return ConvertJavaEnumToCpp<FontHinting>(env, javaFontHinting);
+}
 
-    env->ReleaseStringUTFChars(enumNameJava, enumNameCStr);
-    return faceWinding;
+EffectQuality ConvertJavaEffectQualityToCpp(JNIEnv *env, jobject javaEffectQuality) {
+    return ConvertJavaEnumToCpp<EffectQuality>(env, javaEffectQuality);
 }
 
-FontHinting ConvertJavaFontHintingToCpp(JNIEnv *env, jobject javaFontHinting) {
-    jclass enumClass = env->GetObjectClass(javaFontHinting);
-    jmethodID toStringMethod = env->GetMethodID(enumClass, "toString", "()Ljava/lang/String;");
-
-    const auto enumNameJava = (jstring) env->CallObjectMethod(javaFontHinting, toStringMethod);
-    const char *enumNameCStr = env->GetStringUTFChars(enumNameJava, nullptr);
-
-    FontHinting fontHinting;
-    if (strcmp(enumNameCStr, "Smooth") == 0) {
-        fontHinting = FontHinting::Smooth;
-    } else if (strcmp(enumNameCStr, "Monochrome") == 0) {
-        fontHinting = FontHinting::Monochrome;
-    } else if (strcmp(enumNameCStr, "None") == 0) {
-        fontHinting = FontHinting::None;
-    } else {
-        fontHinting = FontHinting::Normal;
+String ConvertJavaStringToCpp(JNIEnv *env, jstring javaString) {
+    if (!javaString) {
+        return String();
     }
 
-    env->ReleaseStringUTFChars(enumNameJava, enumNameCStr);
-    return fontHinting;
+    jsize length = env->GetStringLength(javaString);
+    const jchar *chars = env->GetStringCritical(javaString, nullptr);
+    String result(reinterpret_cast<const Char16 *>(chars), static_cast<size_t>(length));
+    env->ReleaseStringCritical(javaString, chars);
+    return result;
 }
 
-EffectQuality ConvertJavaEffectQualityToCpp(JNIEnv *env, jobject javaEffectQuality) {
-    jclass enumClass = env->GetObjectClass(javaEffectQuality);
-    jmethodID toStringMethod = env->GetMethodID(enumClass, "toString", "()Ljava/lang/String;");
-
-    const auto enumNameJava = (jstring) env->CallObjectMethod(javaEffectQuality, toStringMethod);
-    const char *enumNameCStr = env->GetStringUTFChars(enumNameJava, nullptr);
-
-    EffectQuality effectQuality;
-    if (strcmp(enumNameCStr, "Low") == 0) {
-        effectQuality = EffectQuality::Low;
-    } else if (strcmp(enumNameCStr, "High") == 0) {
-        effectQuality = EffectQuality::High;
-    } else {
-        effectQuality = EffectQuality::Medium;
-    }
+void *AllocateAligned(size_t size, size_t alignment) {
+    alignment = alignment < sizeof(void *) ? sizeof(void *) : alignment;
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void *pointer = nullptr;
+    return posix_memalign(&pointer, alignment, size) == 0 ? pointer : nullptr;
+#endif
+}
 
-    env->ReleaseStringUTFChars(enumNameJava, enumNameCStr);
-    return effectQuality;
+void FreeAligned(void *pointer) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif
 }
\ No newline at end of file
@@ -2,7 +2,10 @@
 #define UTILS_HPP
 
 #include <jni.h>
+#include <cstddef>
+#include <Ultralight/String.h>
 #include <Ultralight/platform/Config.h>
+#include "EnumMapping.hpp"
 
 using namespace ultralight;
 
@@ -12,4 +15,15 @@ FontHinting ConvertJavaFontHintingToCpp(JNIEnv *env, jobject javaFontHinting);
 
 EffectQuality ConvertJavaEffectQualityToCpp(JNIEnv *env, jobject javaEffectQuality);
 
+// Converts through UTF-16, so unlike GetStringUTFChars supplementary characters survive intact.
+String ConvertJavaStringToCpp(JNIEnv *env, jstring javaString);
+
+void *AllocateAligned(size_t size, size_t alignment);
+
+void FreeAligned(void *pointer);
+
+inline size_t AlignUp(size_t value, size_t alignment) {
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
 #endif //UTILS_HPP
@@ -0,0 +1,172 @@
+#include "ViewHibernator.hpp"
+#include "EnumMapping.hpp"
+#include "SurfaceFactory.hpp"
+#include "UefRenderer.hpp"
+#include "UefView.hpp"
+#include "ViewRegistry.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+uint64_t ViewHibernator::hiddenNanos_ = 0;
+HibernateMode ViewHibernator::mode_ = HibernateMode::Compress;
+uint32_t ViewHibernator::purgeAfter_ = 16;
+uint32_t ViewHibernator::sincePurge_ = 0;
+HibernationStats ViewHibernator::stats_;
+
+static uint64_t Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void ViewHibernator::configure(uint64_t hiddenMillis, HibernateMode mode, uint32_t purgeAfter) {
+    hiddenNanos_ = hiddenMillis * 1000000;
+    mode_ = mode;
+    purgeAfter_ = purgeAfter;
+}
+
+TiledSurface *ViewHibernator::surfaceOf(ViewSlot &slot) {
+    Surface *surface = slot.view->surface();
+    if (!surface || UefSurfaceFactory::asTripleBuffered(surface)) {
+        return nullptr;
+    }
+    return UefSurfaceFactory::asTiled(surface);
+}
+
+uint32_t ViewHibernator::pump() {
+    if (!hiddenNanos_ && !stats_.hibernated) {
+        return 0;
+    }
+
+    uint64_t now = Now();
+    uint32_t count = 0;
+    ViewRegistry::forEach([now, &count](jlong handle, ViewSlot &slot) {
+        TiledSurface *surface = surfaceOf(slot);
+        if (!surface) {
+            return;
+        }
+
+        if (slot.hibernated) {
+            // The engine painted the View and the surface woke up on its own.
+            if (!surface->hibernating()) {
+                woke(slot, *surface, slot.hibernateMode == HibernateMode::Compress);
+            }
+            return;
+        }
+
+        if (hiddenNanos_ && slot.priority == ViewPriority::Hidden && now - slot.hiddenSince >= hiddenNanos_
+            && hibernate(slot, mode_)) {
+            count++;
+        }
+    });
+    return count;
+}
+
+bool ViewHibernator::hibernate(ViewSlot &slot, HibernateMode mode) {
+    TiledSurface *surface = surfaceOf(slot);
+    if (!surface || slot.hibernated || slot.surfaceLocked) {
+        return false;
+    }
+
+    size_t released = surface->hibernate(mode);
+    if (!released) {
+        return false;
+    }
+
+    slot.hibernated = true;
+    slot.hibernateMode = mode;
+    slot.hibernatedBytes = released;
+    stats_.hibernated++;
+    stats_.bytesSaved += released;
+    stats_.hibernations++;
+
+    if (purgeAfter_ && ++sincePurge_ >= purgeAfter_) {
+        UefRenderer::renderer_->PurgeMemory();
+        sincePurge_ = 0;
+        stats_.purges++;
+    }
+    return true;
+}
+
+void ViewHibernator::restore(ViewSlot &slot) {
+    TiledSurface *surface = surfaceOf(slot);
+    if (!surface || !slot.hibernated) {
+        return;
+    }
+    woke(slot, *surface, surface->wake());
+}
+
+void ViewHibernator::woke(ViewSlot &slot, const TiledSurface &surface, bool restored) {
+    forget(slot);
+
+    stats_.restores++;
+    stats_.lastRestoreNanos = surface.lastWakeNanos();
+    stats_.maxRestoreNanos = std::max(stats_.maxRestoreNanos, stats_.lastRestoreNanos);
+    stats_.totalRestoreNanos += stats_.lastRestoreNanos;
+
+    if (!restored) {
+        // The pixels are blank and the engine only repaints damage, so have it repaint the whole View.
+        slot.view->set_needs_paint(true);
+    }
+}
+
+void ViewHibernator::priorityChanged(ViewSlot &slot) {
+    if (slot.priority == ViewPriority::Hidden) {
+        if (!slot.hiddenSince) {
+            slot.hiddenSince = Now();
+        }
+        return;
+    }
+
+    slot.hiddenSince = 0;
+    if (slot.hibernated) {
+        restore(slot);
+    }
+}
+
+void ViewHibernator::forget(ViewSlot &slot) {
+    if (!slot.hibernated) {
+        return;
+    }
+    slot.hibernated = false;
+    stats_.hibernated--;
+    stats_.bytesSaved -= slot.hibernatedBytes;
+    slot.hibernatedBytes = 0;
+}
+
+void Java_net_rk4z_juef_UefRenderer_setHibernation(JNIEnv *env, jclass obj, jlong hiddenMillis, jobject mode, jint purgeAfter) {
+    ViewHibernator::configure(hiddenMillis > 0 ? static_cast<uint64_t>(hiddenMillis) : 0,
+                              ConvertJavaEnumToCpp<HibernateMode>(env, mode),
+                              purgeAfter > 0 ? static_cast<uint32_t>(purgeAfter) : 0);
+}
+
+jint Java_net_rk4z_juef_UefRenderer_hibernateIdleViews(JNIEnv *env, jclass obj) {
+    return static_cast<jint>(ViewHibernator::pump());
+}
+
+void Java_net_rk4z_juef_UefRenderer_getHibernationStats(JNIEnv *env, jclass obj, jlongArray stats) {
+    const HibernationStats &current = ViewHibernator::stats();
+    jlong values[UEF_HIBERNATION_STATS_LENGTH] = {
+        current.hibernated, static_cast<jlong>(current.bytesSaved),
+        static_cast<jlong>(current.hibernations), static_cast<jlong>(current.restores),
+        static_cast<jlong>(current.lastRestoreNanos), static_cast<jlong>(current.maxRestoreNanos),
+        static_cast<jlong>(current.totalRestoreNanos), static_cast<jlong>(current.purges),
+    };
+    env->SetLongArrayRegion(stats, 0, UEF_HIBERNATION_STATS_LENGTH, values);
+}
+
+jboolean Java_net_rk4z_juef_UefView_hibernate(JNIEnv *env, jclass obj, jlong handle, jobject mode) {
+    if (!UefView::lookup(env, handle)) {
+        return JNI_FALSE;
+    }
+    return ViewHibernator::hibernate(*ViewRegistry::slot(handle), ConvertJavaEnumToCpp<HibernateMode>(env, mode)) ? JNI_TRUE : JNI_FALSE;
+}
+
+jboolean Java_net_rk4z_juef_UefView_isHibernating(JNIEnv *env, jclass obj, jlong handle) {
+    if (!UefView::lookup(env, handle)) {
+        return JNI_FALSE;
+    }
+    ViewSlot *slot = ViewRegistry::slot(handle);
+    TiledSurface *surface = UefSurfaceFactory::asTiled(slot->view->surface());
+    return surface && surface->hibernating() ? JNI_TRUE : JNI_FALSE;
+}
@@ -0,0 +1,78 @@
+#ifndef VIEWHIBERNATOR_HPP
+#define VIEWHIBERNATOR_HPP
+
+#include <jni.h>
+#include <cstdint>
+#include "TiledSurface.hpp"
+
+#define UEF_HIBERNATION_STATS_LENGTH 8
+
+struct ViewSlot;
+
+struct HibernationStats {
+    // Views currently hibernating and the surface memory they give back.
+    uint32_t hibernated = 0;
+    uint64_t bytesSaved = 0;
+
+    uint64_t hibernations = 0;
+    uint64_t restores = 0;
+    uint64_t lastRestoreNanos = 0;
+    uint64_t maxRestoreNanos = 0;
+    uint64_t totalRestoreNanos = 0;
+    uint64_t purges = 0;
+};
+
+/**
+ * Gives back the surface memory of Views that have been Hidden for a while.
+ *
+ * A hibernating View's TiledSurface frees its pixel buffer and, with Compress, keeps a QOI copy of
+ * it. Showing the View again (any priority but Hidden) restores the pixels; so does the engine
+ * locking the surface to paint it, which pump() then accounts for. With Drop, or when the copy
+ * cannot be decoded, the View is flagged with set_needs_paint(true) so the engine paints all of it
+ * again on the next frame. Every purgeAfter hibernations the Renderer is asked to PurgeMemory() as
+ * well.
+ *
+ * Only Tiled surfaces hibernate: Bitmap surfaces belong to the engine, and triple-buffered ones
+ * may be read concurrently. Renderer thread only.
+ */
+class ViewHibernator {
+public:
+    static void configure(uint64_t hiddenMillis, HibernateMode mode, uint32_t purgeAfter);
+
+    // Hibernates every View hidden for longer than the threshold; returns how many it hibernated.
+    static uint32_t pump();
+
+    static bool hibernate(ViewSlot &slot, HibernateMode mode);
+    static void restore(ViewSlot &slot);
+
+    // Called after slot.priority changed.
+    static void priorityChanged(ViewSlot &slot);
+    // Called before a slot is freed.
+    static void forget(ViewSlot &slot);
+
+    static const HibernationStats &stats() { return stats_; }
+
+private:
+    static TiledSurface *surfaceOf(ViewSlot &slot);
+    static void woke(ViewSlot &slot, const TiledSurface &surface, bool restored);
+
+    static uint64_t hiddenNanos_;
+    static HibernateMode mode_;
+    static uint32_t purgeAfter_;
+    static uint32_t sincePurge_;
+    static HibernationStats stats_;
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_setHibernation(JNIEnv *env, jclass obj, jlong hiddenMillis, jobject mode, jint purgeAfter);
+
+    JNIEXPORT jint JNICALL Java_net_rk4z_juef_UefRenderer_hibernateIdleViews(JNIEnv *env, jclass obj);
+
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefRenderer_getHibernationStats(JNIEnv *env, jclass obj, jlongArray stats);
+
+    JNIEXPORT jboolean JNICALL Java_net_rk4z_juef_UefView_hibernate(JNIEnv *env, jclass obj, jlong handle, jobject mode);
+
+    JNIEXPORT jboolean JNICALL Java_net_rk4z_juef_UefView_isHibernating(JNIEnv *env, jclass obj, jlong handle);
+}
+
+#endif //VIEWHIBERNATOR_HPP
@@ -0,0 +1,116 @@
+#include "ViewReadback.hpp"
+#include "EnumMapping.hpp"
+#include "JniRegistry.hpp"
+#include "PixelConvert.hpp"
+#include "SurfaceFactory.hpp"
+#include "UefView.hpp"
+#include "Utils.hpp"
+#include "ViewRegistry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+// Quotes UTF-8 text as a JavaScript string literal.
+static std::string QuoteScriptString(const char *text, size_t length) {
+    std::string quoted = "\"";
+    for (size_t i = 0; i < length; i++) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            quoted += escape;
+        } else {
+            quoted += static_cast<char>(c);
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+bool ViewReadback::elementBounds(View *view, const String &selector, IntRect &bounds, String &exception) {
+    const String8 &utf8 = selector.utf8();
+    std::string script = "(function(){var e=document.querySelector(" + QuoteScriptString(utf8.data(), utf8.length())
+        + ");if(!e)return '';var r=e.getBoundingClientRect();return r.left+','+r.top+','+r.right+','+r.bottom;})()";
+
+    String result = view->EvaluateScript(String(script.c_str(), script.size()), &exception);
+    if (!exception.empty()) {
+        return false;
+    }
+
+    double left, top, right, bottom;
+    if (sscanf(result.utf8().data(), "%lf,%lf,%lf,%lf", &left, &top, &right, &bottom) != 4) {
+        return false;
+    }
+
+    // CSS pixels to surface pixels, rounded outwards so the element is never cut.
+    double scale = view->device_scale();
+    bounds.left = std::max(static_cast<int>(std::floor(left * scale)), 0);
+    bounds.top = std::max(static_cast<int>(std::floor(top * scale)), 0);
+    bounds.right = std::min(static_cast<int>(std::ceil(right * scale)), static_cast<int>(view->width()));
+    bounds.bottom = std::min(static_cast<int>(std::ceil(bottom * scale)), static_cast<int>(view->height()));
+    return bounds.right > bounds.left && bounds.bottom > bounds.top;
+}
+
+void Java_net_rk4z_juef_UefView_readRegion(JNIEnv *env, jclass obj, jlong handle, jint x, jint y, jint width, jint height, jobject format, jobject destination) {
+    Surface *surface = UefView::lookupSurface(env, handle);
+    if (!surface) {
+        return;
+    }
+    if (UefSurfaceFactory::asTripleBuffered(surface)) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "Triple-buffered surfaces are read through UefView#openFrameReader()");
+        return;
+    }
+    if (ViewRegistry::slot(handle)->surfaceLocked) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "UefView surface is locked; convert from the UefSurface instead");
+        return;
+    }
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || static_cast<int64_t>(x) + width > surface->width()
+        || static_cast<int64_t>(y) + height > surface->height()) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Region lies outside the View");
+        return;
+    }
+
+    PixelFormat pixelFormat = ConvertJavaEnumToCpp<PixelFormat>(env, format);
+    size_t rowLength = static_cast<size_t>(width) * PixelConvert::bytesPerPixel(pixelFormat);
+    auto target = static_cast<uint8_t *>(env->GetDirectBufferAddress(destination));
+    if (!target || static_cast<int64_t>(rowLength * height) > env->GetDirectBufferCapacity(destination)) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "Destination must be a direct ByteBuffer large enough for the region");
+        return;
+    }
+
+    auto pixels = static_cast<const uint8_t *>(surface->LockPixels());
+    if (pixels) {
+        size_t rowBytes = surface->row_bytes();
+        PixelConvert::convert(pixels + static_cast<size_t>(y) * rowBytes + static_cast<size_t>(x) * 4, rowBytes, target, rowLength,
+                              static_cast<uint32_t>(width), static_cast<uint32_t>(height), pixelFormat);
+    }
+    surface->UnlockPixels();
+}
+
+jboolean Java_net_rk4z_juef_UefView_getElementBounds(JNIEnv *env, jclass obj, jlong handle, jstring selector, jintArray bounds) {
+    View *view = UefView::lookup(env, handle);
+    if (!view) {
+        return JNI_FALSE;
+    }
+
+    IntRect rect = IntRect::MakeEmpty();
+    String exception;
+    bool found = ViewReadback::elementBounds(view, ConvertJavaStringToCpp(env, selector), rect, exception);
+    if (!exception.empty()) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, exception.utf8().data());
+        return JNI_FALSE;
+    }
+    if (!found) {
+        return JNI_FALSE;
+    }
+
+    jint values[4] = {rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top};
+    env->SetIntArrayRegion(bounds, 0, 4, values);
+    return JNI_TRUE;
+}
@@ -0,0 +1,29 @@
+#ifndef VIEWREADBACK_HPP
+#define VIEWREADBACK_HPP
+
+#include <jni.h>
+#include <Ultralight/View.h>
+
+using namespace ultralight;
+
+/**
+ * Reads parts of a View's CPU surface without going through a full-surface Bitmap.
+ *
+ * Regions are converted straight from the locked surface into the caller's buffer, touching only
+ * the requested rows and columns. Element bounds come from getBoundingClientRect() evaluated in the
+ * page, scaled to surface pixels and clipped to the View.
+ */
+class ViewReadback {
+public:
+    // Surface-pixel bounds of the first element matching selector; false when nothing matched or the
+    // element is entirely outside the View. A script error (e.g. an invalid selector) lands in exception.
+    static bool elementBounds(View *view, const String &selector, IntRect &bounds, String &exception);
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefView_readRegion(JNIEnv *env, jclass obj, jlong handle, jint x, jint y, jint width, jint height, jobject format, jobject destination);
+
+    JNIEXPORT jboolean JNICALL Java_net_rk4z_juef_UefView_getElementBounds(JNIEnv *env, jclass obj, jlong handle, jstring selector, jintArray bounds);
+}
+
+#endif //VIEWREADBACK_HPP
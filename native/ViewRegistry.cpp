@@ -0,0 +1,81 @@
+#include "ViewRegistry.hpp"
+#include "ResizeCoalescer.hpp"
+#include "ViewHibernator.hpp"
+
+std::vector<ViewSlot> ViewRegistry::slots_;
+std::vector<uint32_t> ViewRegistry::freeSlots_;
+
+std::mutex ViewRegistry::releaseMutex_;
+std::vector<jlong> ViewRegistry::pendingReleases_;
+
+jlong ViewRegistry::add(RefPtr<View> view) {
+    uint32_t index;
+    if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    ViewSlot &slot = slots_[index];
+    slot.view = std::move(view);
+    return makeHandle(index, slot.generation);
+}
+
+ViewSlot *ViewRegistry::slot(jlong handle) {
+    auto index = static_cast<uint32_t>(static_cast<uint64_t>(handle));
+    auto generation = static_cast<uint32_t>(static_cast<uint64_t>(handle) >> 32);
+
+    if (index >= slots_.size()) {
+        return nullptr;
+    }
+
+    ViewSlot &slot = slots_[index];
+    return slot.generation == generation && slot.view ? &slot : nullptr;
+}
+
+View *ViewRegistry::get(jlong handle) {
+    ViewSlot *found = slot(handle);
+    return found ? found->view.get() : nullptr;
+}
+
+void ViewRegistry::remove(jlong handle) {
+    ViewSlot *found = slot(handle);
+    if (!found) {
+        return;
+    }
+
+    if (found->surfaceLocked && found->view->surface()) {
+        found->view->surface()->UnlockPixels();
+    }
+
+    ViewHibernator::forget(*found);
+    ResizeCoalescer::forget(*found);
+
+    // Reset the whole slot so per-view state never leaks into the next occupant.
+    uint32_t generation = found->generation + 1;
+    *found = ViewSlot();
+    found->generation = generation == 0 ? 1 : generation;
+    freeSlots_.push_back(static_cast<uint32_t>(found - slots_.data()));
+}
+
+void ViewRegistry::enqueueRelease(jlong handle) {
+    std::lock_guard<std::mutex> lock(releaseMutex_);
+    pendingReleases_.push_back(handle);
+}
+
+void ViewRegistry::drainReleases() {
+    std::vector<jlong> releases;
+    {
+        std::lock_guard<std::mutex> lock(releaseMutex_);
+        if (pendingReleases_.empty()) {
+            return;
+        }
+        releases.swap(pendingReleases_);
+    }
+
+    for (jlong handle : releases) {
+        remove(handle);
+    }
+}
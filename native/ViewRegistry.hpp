@@ -0,0 +1,93 @@
+#ifndef VIEWREGISTRY_HPP
+#define VIEWREGISTRY_HPP
+
+#include <jni.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <Ultralight/View.h>
+#include "DeltaEncoder.hpp"
+#include "FrameScheduler.hpp"
+#include "TiledSurface.hpp"
+
+using namespace ultralight;
+
+struct ViewSlot {
+    RefPtr<View> view;
+    uint32_t generation = 1;
+
+    // Pixels of the last direct ByteBuffer handed to Java, so an unchanged buffer is not re-wrapped.
+    void *surfacePixels = nullptr;
+    size_t surfaceSize = 0;
+    bool surfaceLocked = false;
+
+    // Scheduling state, see FrameScheduler.
+    ViewPriority priority = ViewPriority::Visible;
+    uint32_t deferredFrames = 0;
+
+    // Hibernation state, see ViewHibernator. hiddenSince is 0 unless the View is Hidden.
+    uint64_t hiddenSince = 0;
+    bool hibernated = false;
+    HibernateMode hibernateMode = HibernateMode::Compress;
+    size_t hibernatedBytes = 0;
+
+    // Latest size requested through ResizeCoalescer, applied before the next Update().
+    bool resizePending = false;
+    bool resizeSlack = false;
+    uint32_t pendingWidth = 0;
+    uint32_t pendingHeight = 0;
+    uint64_t lastResizeAt = 0;
+
+    // Damage collected by UefView::collectDamage but not yet handed to lockSurface / encodeDelta.
+    IntRect lockDamage = IntRect::MakeEmpty();
+    IntRect deltaDamage = IntRect::MakeEmpty();
+
+    // Tiles taken from a TiledSurface by the last lock, waiting to be copied out to Java.
+    std::vector<jint> dirtyTiles;
+
+    // Created by the first encodeDelta/keyframe call; deltaPacket is the storage last wrapped for Java.
+    std::unique_ptr<DeltaEncoder> delta;
+    const uint8_t *deltaPacket = nullptr;
+};
+
+/**
+ * Slot map owning every View handed out to Java. A handle packs the slot index in the low 32 bits
+ * and the slot's generation in the high 32 bits, so a lookup is one bounds check plus one
+ * generation compare, and handles to freed or reused slots are rejected.
+ *
+ * Everything except enqueueRelease must be called on the renderer thread. enqueueRelease is what the
+ * Java Cleaner calls; the slot itself is freed on the renderer thread by drainReleases.
+ */
+class ViewRegistry {
+public:
+    static jlong add(RefPtr<View> view);
+    static ViewSlot *slot(jlong handle);
+    static View *get(jlong handle);
+    static void remove(jlong handle);
+
+    static void enqueueRelease(jlong handle);
+    static void drainReleases();
+
+    template <typename F>
+    static void forEach(F &&function) {
+        for (size_t i = 0; i < slots_.size(); i++) {
+            if (slots_[i].view) {
+                function(makeHandle(static_cast<uint32_t>(i), slots_[i].generation), slots_[i]);
+            }
+        }
+    }
+
+private:
+    static jlong makeHandle(uint32_t index, uint32_t generation) {
+        return static_cast<jlong>((static_cast<uint64_t>(generation) << 32) | index);
+    }
+
+    static std::vector<ViewSlot> slots_;
+    static std::vector<uint32_t> freeSlots_;
+
+    static std::mutex releaseMutex_;
+    static std::vector<jlong> pendingReleases_;
+};
+
+#endif //VIEWREGISTRY_HPP
@@ -0,0 +1,141 @@
+#include "VirtualFileSystem.hpp"
+#include "JniRegistry.hpp"
+#include "UefFileSystem.hpp"
+#include "UefRenderer.hpp"
+#include "Utils.hpp"
+
+#include <mutex>
+#include <thread>
+#include <utility>
+
+std::atomic<const VirtualFileSystem::Files *> VirtualFileSystem::files_{new Files()};
+std::atomic<uint32_t> VirtualFileSystem::epoch_{0};
+std::atomic<uint32_t> VirtualFileSystem::readers_[2] = {};
+
+static void ReleaseFile(void *userData, void *data) {
+    delete static_cast<std::shared_ptr<VirtualFile> *>(userData);
+}
+
+VirtualFile::VirtualFile(jobject buffer, void *data, size_t size, String mime, String charset)
+    : buffer(buffer), data(data), size(size), mime(std::move(mime)), charset(std::move(charset)) {
+}
+
+VirtualFile::~VirtualFile() {
+    // Usually the last Buffer goes away on an engine thread, which may never have touched Java.
+    JNIEnv *env = JniRegistry::attach();
+    if (env) {
+        env->DeleteGlobalRef(buffer);
+    }
+}
+
+static std::string Key(const String &path) {
+    const String8 &utf8 = path.utf8();
+    return std::string(utf8.data(), utf8.length());
+}
+
+std::shared_ptr<VirtualFile> VirtualFileSystem::find(const String &file_path) {
+    std::string key = Key(file_path);
+
+    // Count this reader in the current epoch; if the epoch moved meanwhile, a writer may already
+    // have checked that counter, so count again in the new one.
+    uint32_t epoch;
+    for (;;) {
+        epoch = epoch_.load();
+        readers_[epoch & 1].fetch_add(1);
+        if (epoch_.load() == epoch) {
+            break;
+        }
+        readers_[epoch & 1].fetch_sub(1);
+    }
+
+    const Files *current = files_.load();
+    auto file = current->find(key);
+    std::shared_ptr<VirtualFile> found = file != current->end() ? file->second : nullptr;
+    readers_[epoch & 1].fetch_sub(1, std::memory_order_release);
+    return found;
+}
+
+bool VirtualFileSystem::FileExists(const String &file_path) {
+    return find(file_path) != nullptr;
+}
+
+String VirtualFileSystem::GetFileMimeType(const String &file_path) {
+    std::shared_ptr<VirtualFile> file = find(file_path);
+    return file && !file->mime.empty() ? file->mime : String("application/unknown");
+}
+
+String VirtualFileSystem::GetFileCharset(const String &file_path) {
+    std::shared_ptr<VirtualFile> file = find(file_path);
+    return file && !file->charset.empty() ? file->charset : String("utf-8");
+}
+
+RefPtr<Buffer> VirtualFileSystem::OpenFile(const String &file_path) {
+    std::shared_ptr<VirtualFile> file = find(file_path);
+    if (!file) {
+        return nullptr;
+    }
+    return Buffer::Create(file->data, file->size, new std::shared_ptr<VirtualFile>(file), ReleaseFile);
+}
+
+// Writers come from Java threads and serialize here; readers never take it.
+static std::mutex writeMutex;
+
+void VirtualFileSystem::publish(const Files *next) {
+    const Files *previous = files_.exchange(next);
+
+    // Readers counted under the old parity may still hold previous; later ones see next.
+    uint32_t epoch = epoch_.fetch_add(1);
+    while (readers_[epoch & 1].load() != 0) {
+        std::this_thread::yield();
+    }
+    delete previous;
+}
+
+void VirtualFileSystem::add(const String &path, std::shared_ptr<VirtualFile> file) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    static bool mounted = false;
+    if (!mounted) {
+        UefFileSystem::mount(std::make_shared<VirtualFileSystem>());
+        mounted = true;
+    }
+
+    auto next = new Files(*files_.load());
+    (*next)[Key(path)] = std::move(file);
+    publish(next);
+}
+
+bool VirtualFileSystem::remove(const String &path) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    const Files *current = files_.load();
+    if (!current->count(Key(path))) {
+        return false;
+    }
+    auto next = new Files(*current);
+    next->erase(Key(path));
+    publish(next);
+    return true;
+}
+
+void Java_net_rk4z_juef_UefPlatform_registerVirtualFile(JNIEnv *env, jclass obj, jstring path, jobject buffer,
+                                                        jint offset, jint length, jstring mime, jstring charset) {
+    if (UefRenderer::renderer_ && !UefFileSystem::installed()) {
+        env->ThrowNew(JniRegistry::illegalStateExceptionClass_, "The first file system must be mounted before the Renderer is created");
+        return;
+    }
+
+    auto base = static_cast<uint8_t *>(env->GetDirectBufferAddress(buffer));
+    if (!base) {
+        env->ThrowNew(JniRegistry::illegalArgumentExceptionClass_, "The buffer must be a direct ByteBuffer");
+        return;
+    }
+
+    jobject global = env->NewGlobalRef(buffer);
+    auto file = std::make_shared<VirtualFile>(global, base + offset, static_cast<size_t>(length),
+                                              ConvertJavaStringToCpp(env, mime), ConvertJavaStringToCpp(env, charset));
+    VirtualFileSystem::add(UefFileSystem::normalize(ConvertJavaStringToCpp(env, path)), std::move(file));
+}
+
+jboolean Java_net_rk4z_juef_UefPlatform_unregisterVirtualFile(JNIEnv *env, jclass obj, jstring path) {
+    return VirtualFileSystem::remove(UefFileSystem::normalize(ConvertJavaStringToCpp(env, path))) ? JNI_TRUE : JNI_FALSE;
+}
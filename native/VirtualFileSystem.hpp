@@ -0,0 +1,67 @@
+#ifndef VIRTUALFILESYSTEM_HPP
+#define VIRTUALFILESYSTEM_HPP
+
+#include <jni.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <Ultralight/platform/FileSystem.h>
+
+using namespace ultralight;
+
+// A direct ByteBuffer registered from Java. The global ref keeps its memory alive until both the
+// registration and every Buffer handed to the engine are gone.
+struct VirtualFile {
+    VirtualFile(jobject buffer, void *data, size_t size, String mime, String charset);
+    ~VirtualFile();
+
+    jobject buffer;
+    void *data;
+    size_t size;
+    String mime;
+    String charset;
+};
+
+/**
+ * A mount layer of files whose contents live in Java direct ByteBuffers, registered and removed at any
+ * time. OpenFile hands the engine the buffer's own memory, never a copy.
+ *
+ * The engine reads from its worker threads, so the path map is an immutable snapshot behind an atomic
+ * pointer, and lookups take no lock. A change copies the map, swaps the copy in and frees the old one
+ * after a grace period: readers announce themselves in one of two counters picked by the epoch's
+ * parity, and the writer flips the epoch and waits for the old parity's counter to drain.
+ */
+class VirtualFileSystem : public FileSystem {
+public:
+    using Files = std::unordered_map<std::string, std::shared_ptr<VirtualFile>>;
+
+    bool FileExists(const String &file_path) override;
+    String GetFileMimeType(const String &file_path) override;
+    String GetFileCharset(const String &file_path) override;
+    RefPtr<Buffer> OpenFile(const String &file_path) override;
+
+    // Mounts the layer on the first call; replaces any file already at the path.
+    static void add(const String &path, std::shared_ptr<VirtualFile> file);
+    static bool remove(const String &path);
+
+private:
+    static std::shared_ptr<VirtualFile> find(const String &file_path);
+    // Swaps next in and deletes the previous snapshot once no reader can still see it. Writers only.
+    static void publish(const Files *next);
+
+    static std::atomic<const Files *> files_;
+    static std::atomic<uint32_t> epoch_;
+    static std::atomic<uint32_t> readers_[2];
+};
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_net_rk4z_juef_UefPlatform_registerVirtualFile(JNIEnv *env, jclass obj, jstring path,
+        jobject buffer, jint offset, jint length, jstring mime, jstring charset);
+
+    JNIEXPORT jboolean JNICALL Java_net_rk4z_juef_UefPlatform_unregisterVirtualFile(JNIEnv *env, jclass obj, jstring path);
+}
+
+#endif //VIRTUALFILESYSTEM_HPP
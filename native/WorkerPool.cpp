@@ -0,0 +1,95 @@
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+WorkerPool::WorkerPool(unsigned threads) {
+    for (unsigned i = 0; i < std::max(threads, 1u); i++) {
+        threads_.emplace_back([this] { run(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &thread : threads_) {
+        thread.join();
+    }
+}
+
+WorkerPool &WorkerPool::shared() {
+    static WorkerPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return pool;
+}
+
+void WorkerPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+void WorkerPool::run() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)> &task) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1) {
+        task(0);
+        return;
+    }
+
+    // Helpers may start after every index is taken (or after this call returned), so the shared
+    // state outlives the call and they only run the task when they claimed an index.
+    struct State {
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t finished = 0;
+    };
+    auto state = std::make_shared<State>();
+    const std::function<void(size_t)> *function = &task;
+
+    auto work = [state, function, count] {
+        size_t ran = 0;
+        for (size_t index; (index = state->next.fetch_add(1)) < count; ran++) {
+            (*function)(index);
+        }
+        if (ran) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->finished += ran;
+            if (state->finished == count) {
+                state->done.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(count - 1, static_cast<size_t>(size()));
+    for (size_t i = 0; i < helpers; i++) {
+        submit(work);
+    }
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state, count] { return state->finished == count; });
+}
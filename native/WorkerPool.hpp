@@ -0,0 +1,42 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of native worker threads for CPU-bound work outside the engine (encoding, scaling...).
+ * Workers never touch the engine and are not attached to the JVM.
+ */
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned threads);
+    ~WorkerPool();
+
+    void submit(std::function<void()> task);
+
+    // Runs task(0) ... task(count - 1) on the pool and the calling thread and returns once all of them
+    // finished. The caller takes part, so this is safe to call from inside a pool task.
+    void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()); }
+
+    // One worker per core besides the caller's, created on first use.
+    static WorkerPool &shared();
+
+private:
+    void run();
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+};
+
+#endif //WORKERPOOL_HPP
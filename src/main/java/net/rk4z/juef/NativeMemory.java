@@ -0,0 +1,45 @@
+package net.rk4z.juef;
+
+import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+
+/**
+ * Ties native memory exposed as a direct ByteBuffer to that buffer's lifetime: the memory is freed
+ * once the buffer (and every view of it) becomes unreachable.
+ */
+final class NativeMemory {
+    private static final Cleaner CLEANER = Cleaner.create();
+
+    private NativeMemory() {
+    }
+
+    static ByteBuffer register(ByteBuffer buffer, long blobPtr) {
+        CLEANER.register(buffer, new Free(blobPtr));
+        return buffer;
+    }
+
+    static ByteBuffer wrap(long blobPtr) {
+        return register(buffer(blobPtr), blobPtr);
+    }
+
+//>------------------- Native methods --------------------<\\
+
+    private static native ByteBuffer buffer(long blobPtr);
+
+    private static native void free(long blobPtr);
+
+//>------------------- Native methods --------------------<\\
+
+    private static final class Free implements Runnable {
+        private final long blobPtr;
+
+        private Free(long blobPtr) {
+            this.blobPtr = blobPtr;
+        }
+
+        @Override
+        public void run() {
+            free(blobPtr);
+        }
+    }
+}
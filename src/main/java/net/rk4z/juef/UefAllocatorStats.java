@@ -0,0 +1,120 @@
+package net.rk4z.juef;
+
+import net.rk4z.juef.util.AllocatorMode;
+
+/**
+ * The engine's heap as seen by the allocator selected with {@link AllocatorMode}, see
+ * {@link UefPlatform#getAllocatorStats()}. All zero with {@link AllocatorMode#System}. Every thread
+ * reports its activity in batches, so the figures can trail by a few hundred KiB per engine thread.
+ * A snapshot; it does not update by itself.
+ */
+public final class UefAllocatorStats {
+    static final int CLASSES = 37;
+    static final int LENGTH = 7 + 3 * CLASSES;
+
+    private final long liveBytes;
+    private final long peakBytes;
+    private final long allocations;
+    private final long frees;
+    private final long allocatedBytes;
+    private final long reservedBytes;
+    private final long timestamp;
+    private final long[] classSizes = new long[CLASSES];
+    private final long[] classAllocations = new long[CLASSES];
+    private final long[] classLiveBlocks = new long[CLASSES];
+
+    UefAllocatorStats(long[] stats) {
+        liveBytes = stats[0];
+        peakBytes = stats[1];
+        allocations = stats[2];
+        frees = stats[3];
+        allocatedBytes = stats[4];
+        reservedBytes = stats[5];
+        timestamp = stats[6];
+        for (int i = 0; i < CLASSES; i++) {
+            classSizes[i] = stats[7 + 3 * i];
+            classAllocations[i] = stats[8 + 3 * i];
+            classLiveBlocks[i] = stats[9 + 3 * i];
+        }
+    }
+
+    /**
+     * @return Bytes allocated and not yet freed, counted as the blocks backing them
+     */
+    public long getLiveBytes() {
+        return liveBytes;
+    }
+
+    public long getPeakBytes() {
+        return peakBytes;
+    }
+
+    /**
+     * @return Allocations since the allocator was installed, reallocations included
+     */
+    public long getAllocations() {
+        return allocations;
+    }
+
+    public long getFrees() {
+        return frees;
+    }
+
+    /**
+     * @return Bytes allocated since the allocator was installed, never decreasing
+     */
+    public long getAllocatedBytes() {
+        return allocatedBytes;
+    }
+
+    /**
+     * @return Memory taken from the system for the pool's size classes, 0 for the other modes
+     */
+    public long getReservedBytes() {
+        return reservedBytes;
+    }
+
+    /**
+     * @return When the snapshot was taken, in {@link System#nanoTime()}-like nanoseconds
+     */
+    public long getTimestamp() {
+        return timestamp;
+    }
+
+    /**
+     * @param since An earlier snapshot
+     * @return Bytes allocated per second between the two snapshots, 0 if no time passed
+     */
+    public double getAllocationRate(UefAllocatorStats since) {
+        long nanos = timestamp - since.timestamp;
+        return nanos > 0 ? (allocatedBytes - since.allocatedBytes) * 1e9 / nanos : 0;
+    }
+
+    /**
+     * @return The number of size classes; the last one takes every allocation too large for the others
+     */
+    public int getClassCount() {
+        return CLASSES;
+    }
+
+    /**
+     * @return The largest allocation the size class takes, {@link Long#MAX_VALUE} for the last
+     */
+    public long getClassSize(int sizeClass) {
+        return classSizes[sizeClass];
+    }
+
+    /**
+     * @return Allocations served by the size class
+     */
+    public long getClassAllocations(int sizeClass) {
+        return classAllocations[sizeClass];
+    }
+
+    /**
+     * @return Blocks of the size class currently allocated
+     */
+    public long getClassLiveBlocks(int sizeClass) {
+        return classLiveBlocks[sizeClass];
+    }
+}
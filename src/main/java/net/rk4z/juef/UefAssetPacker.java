@@ -0,0 +1,199 @@
+package net.rk4z.juef;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.nio.file.StandardCopyOption;
+import java.nio.file.StandardOpenOption;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Locale;
+import java.util.Map;
+import java.util.stream.Stream;
+
+/**
+ * Builds the asset packs served by {@link UefPlatform#mountAssetPack(String)}: every file below a
+ * directory in one file, with a sorted path index that carries each file's mime type and charset.
+ *
+ * <p>Layout (little-endian): a 64-byte header, 40-byte index entries sorted by UTF-8 path, a string
+ * table, then the file contents, each aligned to 64 bytes and files of 4 KiB and up to a page. Also
+ * runnable as {@code UefAssetPacker <directory> <pack>}, which is what the {@code packAssets} Gradle
+ * task does.</p>
+ */
+public final class UefAssetPacker {
+    private static final byte[] MAGIC = {'U', 'E', 'F', 'P', 'A', 'C', 'K', 0};
+    private static final int VERSION = 1;
+    private static final int HEADER_SIZE = 64;
+    private static final int ENTRY_SIZE = 40;
+    private static final int ALIGNMENT = 64;
+    private static final int PAGE = 4096;
+
+    private static final Map<String, String> MIME_TYPES = new HashMap<>();
+
+    static {
+        String[][] types = {
+            {"html", "text/html"}, {"htm", "text/html"}, {"css", "text/css"}, {"txt", "text/plain"},
+            {"js", "application/javascript"}, {"mjs", "application/javascript"}, {"json", "application/json"},
+            {"xml", "application/xml"}, {"svg", "image/svg+xml"}, {"png", "image/png"}, {"jpg", "image/jpeg"},
+            {"jpeg", "image/jpeg"}, {"gif", "image/gif"}, {"webp", "image/webp"}, {"avif", "image/avif"},
+            {"ico", "image/x-icon"}, {"bmp", "image/bmp"}, {"woff", "font/woff"}, {"woff2", "font/woff2"},
+            {"ttf", "font/ttf"}, {"otf", "font/otf"}, {"wasm", "application/wasm"}, {"mp3", "audio/mpeg"},
+            {"ogg", "audio/ogg"}, {"wav", "audio/wav"}, {"mp4", "video/mp4"}, {"webm", "video/webm"},
+            {"pem", "application/x-pem-file"}, {"crt", "application/x-x509-ca-cert"},
+            {"dat", "application/octet-stream"},
+        };
+        for (String[] type : types) {
+            MIME_TYPES.put(type[0], type[1]);
+        }
+    }
+
+    private UefAssetPacker() {
+    }
+
+    public static void main(String[] args) throws IOException {
+        if (args.length != 2) {
+            System.err.println("Usage: UefAssetPacker <directory> <pack>");
+            System.exit(2);
+        }
+        int count = pack(Paths.get(args[0]), Paths.get(args[1]));
+        System.out.println("Packed " + count + " files into " + args[1]);
+    }
+
+    /**
+     * Pack every regular file below a directory, keyed by its path relative to it with forward slashes.
+     *
+     * @param root The directory, e.g. one holding the engine's {@code resources/} next to the app's assets
+     * @param output The pack to write, replaced if it exists
+     * @return How many files were packed
+     */
+    public static int pack(Path root, Path output) throws IOException {
+        List<Entry> entries = new ArrayList<>();
+        try (Stream<Path> files = Files.walk(root)) {
+            for (Path file : (Iterable<Path>) files.filter(Files::isRegularFile)::iterator) {
+                String path = root.relativize(file).toString().replace('\\', '/');
+                entries.add(new Entry(file, path.getBytes(StandardCharsets.UTF_8), Files.size(file)));
+            }
+        }
+        entries.sort((a, b) -> Arrays.compareUnsigned(a.path, b.path));
+
+        // Strings are deduplicated, so the handful of mime types and charsets are stored once.
+        Map<String, Integer> offsets = new HashMap<>();
+        ByteArrayBuilder strings = new ByteArrayBuilder();
+        for (Entry entry : entries) {
+            entry.pathOffset = strings.append(entry.path);
+            String mime = mimeType(new String(entry.path, StandardCharsets.UTF_8));
+            entry.mime = mime.getBytes(StandardCharsets.US_ASCII);
+            entry.mimeOffset = offsets.computeIfAbsent(mime, key -> strings.append(entry.mime));
+            String charset = charset(mime);
+            entry.charset = charset.getBytes(StandardCharsets.US_ASCII);
+            entry.charsetOffset = offsets.computeIfAbsent("charset:" + charset, key -> strings.append(entry.charset));
+        }
+
+        long indexOffset = HEADER_SIZE;
+        long stringsOffset = indexOffset + (long) entries.size() * ENTRY_SIZE;
+        long offset = stringsOffset + strings.size();
+        for (Entry entry : entries) {
+            offset = align(offset, entry.size >= PAGE ? PAGE : ALIGNMENT);
+            entry.dataOffset = offset;
+            offset += entry.size;
+        }
+        long fileSize = offset;
+
+        ByteBuffer head = ByteBuffer.allocate((int) stringsOffset).order(ByteOrder.LITTLE_ENDIAN);
+        head.put(MAGIC).putInt(VERSION).putInt(entries.size()).putLong(indexOffset).putLong(stringsOffset)
+            .putLong(strings.size()).putLong(fileSize).position(HEADER_SIZE);
+        for (Entry entry : entries) {
+            head.putLong(entry.dataOffset).putLong(entry.size)
+                .putInt(entry.pathOffset).putInt(entry.path.length)
+                .putInt(entry.mimeOffset).putInt(entry.mime.length)
+                .putInt(entry.charsetOffset).putInt(entry.charset.length);
+        }
+        head.flip();
+
+        Path temporary = output.resolveSibling(output.getFileName() + ".tmp");
+        try (FileChannel channel = FileChannel.open(temporary, StandardOpenOption.CREATE, StandardOpenOption.WRITE,
+                                                    StandardOpenOption.TRUNCATE_EXISTING)) {
+            writeFully(channel, head, 0);
+            writeFully(channel, ByteBuffer.wrap(strings.bytes(), 0, strings.size()), stringsOffset);
+            for (Entry entry : entries) {
+                try (FileChannel in = FileChannel.open(entry.file, StandardOpenOption.READ)) {
+                    long copied = 0;
+                    while (copied < entry.size) {
+                        long count = in.transferTo(copied, entry.size - copied, channel.position(entry.dataOffset + copied));
+                        if (count <= 0) {
+                            throw new IOException(entry.file + " changed while it was being packed");
+                        }
+                        copied += count;
+                    }
+                }
+            }
+            // An empty last file leaves only alignment padding at the end; the length must still match the header.
+            if (channel.size() < fileSize) {
+                writeFully(channel, ByteBuffer.allocate(1), fileSize - 1);
+            }
+        }
+        Files.move(temporary, output, StandardCopyOption.REPLACE_EXISTING);
+        return entries.size();
+    }
+
+    private static void writeFully(FileChannel channel, ByteBuffer buffer, long position) throws IOException {
+        while (buffer.hasRemaining()) {
+            position += channel.write(buffer, position);
+        }
+    }
+
+    private static long align(long value, long alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Shared with UefClasspathResources, so packed and classpath files are typed alike.
+    static String mimeType(String name) {
+        int dot = name.lastIndexOf('.');
+        String type = dot < 0 || dot < name.lastIndexOf('/') ? null : MIME_TYPES.get(name.substring(dot + 1).toLowerCase(Locale.ROOT));
+        return type != null ? type : "application/octet-stream";
+    }
+
+    static String charset(String mime) {
+        boolean text = mime.startsWith("text/") || mime.equals("application/javascript") || mime.equals("application/json")
+            || mime.equals("application/xml") || mime.equals("image/svg+xml");
+        return text ? "utf-8" : "";
+    }
+
+    private static final class Entry {
+        final Path file;
+        final byte[] path;
+        final long size;
+        byte[] mime;
+        byte[] charset;
+        int pathOffset;
+        int mimeOffset;
+        int charsetOffset;
+        long dataOffset;
+
+        Entry(Path file, byte[] path, long size) {
+            this.file = file;
+            this.path = path;
+            this.size = size;
+        }
+    }
+
+    private static final class ByteArrayBuilder extends ByteArrayOutputStream {
+        int append(byte[] bytes) {
+            int offset = count;
+            write(bytes, 0, bytes.length);
+            return offset;
+        }
+
+        byte[] bytes() {
+            return buf;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+package net.rk4z.juef;
+
+import java.io.IOException;
+import java.io.InputStream;
+import java.net.JarURLConnection;
+import java.net.URISyntaxException;
+import java.net.URL;
+import java.net.URLConnection;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Enumeration;
+import java.util.List;
+import java.util.Set;
+import java.util.TreeSet;
+import java.util.jar.JarEntry;
+import java.util.jar.JarFile;
+import java.util.stream.Stream;
+
+/**
+ * The Java half of {@link UefPlatform#mountClasspath(ClassLoader, String, long)}: lists what lies below
+ * a classpath directory once, when it is mounted, and reads a single resource whenever the native
+ * layer misses its cache.
+ */
+final class UefClasspathResources {
+    private static final List<UefClasspathResources> MOUNTS = new ArrayList<>();
+
+    final int id;
+    final String[] names;
+    final String[] mimes;
+    final String[] charsets;
+
+    private final ClassLoader loader;
+    private final String prefix;
+
+    private UefClasspathResources(int id, ClassLoader loader, String prefix, Set<String> names) {
+        this.id = id;
+        this.loader = loader;
+        this.prefix = prefix;
+        this.names = names.toArray(new String[0]);
+        this.mimes = new String[this.names.length];
+        this.charsets = new String[this.names.length];
+        for (int i = 0; i < this.names.length; i++) {
+            mimes[i] = UefAssetPacker.mimeType(this.names[i]);
+            charsets[i] = UefAssetPacker.charset(mimes[i]);
+        }
+    }
+
+    /**
+     * List every resource below a directory, in each JAR and class directory that has it. JARs must
+     * carry directory entries, which Gradle and Maven write by default.
+     */
+    static UefClasspathResources list(ClassLoader loader, String root) throws IOException {
+        String directory = root.replace('\\', '/');
+        while (directory.startsWith("/")) {
+            directory = directory.substring(1);
+        }
+        while (directory.endsWith("/")) {
+            directory = directory.substring(0, directory.length() - 1);
+        }
+        if (directory.isEmpty()) {
+            throw new IllegalArgumentException("The classpath root must name a directory, e.g. \"web\"");
+        }
+
+        Set<String> names = new TreeSet<>();
+        Enumeration<URL> urls = loader.getResources(directory);
+        while (urls.hasMoreElements()) {
+            URL url = urls.nextElement();
+            if (url.getProtocol().equals("file")) {
+                listDirectory(url, names);
+                continue;
+            }
+            URLConnection connection = url.openConnection();
+            if (connection instanceof JarURLConnection) {
+                listJar((JarURLConnection) connection, names);
+            }
+        }
+        if (names.isEmpty()) {
+            throw new IllegalArgumentException("Nothing below " + directory + " on the classpath");
+        }
+
+        synchronized (MOUNTS) {
+            UefClasspathResources resources = new UefClasspathResources(MOUNTS.size(), loader, directory + "/", names);
+            MOUNTS.add(resources);
+            return resources;
+        }
+    }
+
+    private static void listDirectory(URL url, Set<String> names) throws IOException {
+        final Path root;
+        try {
+            root = Paths.get(url.toURI());
+        } catch (URISyntaxException e) {
+            throw new IOException("Cannot list " + url, e);
+        }
+        try (Stream<Path> files = Files.walk(root)) {
+            files.filter(Files::isRegularFile).forEach(file -> names.add(root.relativize(file).toString().replace('\\', '/')));
+        }
+    }
+
+    private static void listJar(JarURLConnection connection, Set<String> names) throws IOException {
+        // Uncached, so closing it here does not close the JarFile the class loader reads through.
+        connection.setUseCaches(false);
+        String prefix = connection.getEntryName() + "/";
+        try (JarFile jar = connection.getJarFile()) {
+            Enumeration<JarEntry> entries = jar.entries();
+            while (entries.hasMoreElements()) {
+                JarEntry entry = entries.nextElement();
+                if (!entry.isDirectory() && entry.getName().startsWith(prefix)) {
+                    names.add(entry.getName().substring(prefix.length()));
+                }
+            }
+        }
+    }
+
+    /**
+     * Called from native code, on whichever engine thread opened the file.
+     *
+     * @return The resource's bytes, null if the class loader no longer has it
+     */
+    static byte[] read(int mount, String path) throws IOException {
+        UefClasspathResources resources;
+        synchronized (MOUNTS) {
+            resources = MOUNTS.get(mount);
+        }
+        try (InputStream in = resources.loader.getResourceAsStream(resources.prefix + path)) {
+            return in != null ? in.readAllBytes() : null;
+        }
+    }
+}
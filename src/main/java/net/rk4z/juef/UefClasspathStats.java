@@ -0,0 +1,78 @@
+package net.rk4z.juef;
+
+/**
+ * How the classpath mounts are being served, summed over all of them, see
+ * {@link UefPlatform#getClasspathStats()}. A snapshot; it does not update by itself.
+ */
+public final class UefClasspathStats {
+    static final int LENGTH = 7;
+
+    private final long hits;
+    private final long misses;
+    private final long notFound;
+    private final long loadedBytes;
+    private final long evictions;
+    private final long cachedEntries;
+    private final long cachedBytes;
+
+    UefClasspathStats(long[] stats) {
+        hits = stats[0];
+        misses = stats[1];
+        notFound = stats[2];
+        loadedBytes = stats[3];
+        evictions = stats[4];
+        cachedEntries = stats[5];
+        cachedBytes = stats[6];
+    }
+
+    /**
+     * @return Files served from native memory without calling into Java
+     */
+    public long getHits() {
+        return hits;
+    }
+
+    /**
+     * @return Files read through the class loader
+     */
+    public long getMisses() {
+        return misses;
+    }
+
+    /**
+     * @return Share of opened files served from native memory, 0 before the first one
+     */
+    public double getHitRate() {
+        long opens = hits + misses;
+        return opens > 0 ? (double) hits / opens : 0;
+    }
+
+    /**
+     * @return Listed files the class loader could not read when they were opened
+     */
+    public long getNotFound() {
+        return notFound;
+    }
+
+    /**
+     * @return Bytes copied out of the class loader over all misses
+     */
+    public long getLoadedBytes() {
+        return loadedBytes;
+    }
+
+    /**
+     * @return Files dropped from native memory to stay within the budget
+     */
+    public long getEvictions() {
+        return evictions;
+    }
+
+    public long getCachedEntries() {
+        return cachedEntries;
+    }
+
+    public long getCachedBytes() {
+        return cachedBytes;
+    }
+}
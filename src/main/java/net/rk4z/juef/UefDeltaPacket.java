@@ -0,0 +1,75 @@
+package net.rk4z.juef;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * The changes between two frames of a View, see {@link UefView#encodeDelta()}.
+ *
+ * <p>{@link #getData()} holds the whole packet, little-endian:</p>
+ * <pre>
+ * header   "UEFD", u8 version (1), u8 flags (bit 0: keyframe), u16 0,
+ *          u32 frame, u32 width, u32 height, u32 spanCount
+ * span     u16 x, u16 y, u16 pixelCount, u32 payloadLength, payload
+ * payload  control byte c, then c + 1 literal bytes when c &lt; 0x80, otherwise c - 0x7E zero bytes
+ * </pre>
+ * <p>A receiver decodes each span's payload and XORs it into row {@code y} of its copy of the frame,
+ * starting at pixel {@code x}. Keyframes cover the whole frame and are applied to a zeroed buffer.
+ * Pixels are premultiplied BGRA like {@link UefSurface}.</p>
+ *
+ * <p>The buffer points at native memory reused by the next {@link UefView#encodeDelta()} call, so
+ * the packet must be sent or copied before then.</p>
+ */
+public final class UefDeltaPacket {
+    static final int INFO_LENGTH = 4;
+
+    private ByteBuffer data;
+    private int size;
+    private long frame;
+    private boolean keyframe;
+    private int spanCount;
+
+    UefDeltaPacket() {
+    }
+
+    void update(ByteBuffer newData, long[] info) {
+        // The native side only hands out a new buffer when the packet storage was reallocated.
+        if (newData != null) {
+            data = newData.order(ByteOrder.LITTLE_ENDIAN);
+        }
+        size = (int) info[0];
+        frame = info[1];
+        keyframe = info[2] != 0;
+        spanCount = (int) info[3];
+        data.clear().limit(size);
+    }
+
+    /**
+     * @return The encoded packet, positioned at 0 with its limit at the end of the packet
+     */
+    public ByteBuffer getData() {
+        return data;
+    }
+
+    public int getSize() {
+        return size;
+    }
+
+    /**
+     * @return Number of this packet, counting every packet produced for the View from 1
+     */
+    public long getFrame() {
+        return frame;
+    }
+
+    /**
+     * @return Whether this packet replaces the whole frame instead of patching the previous one
+     */
+    public boolean isKeyframe() {
+        return keyframe;
+    }
+
+    public int getSpanCount() {
+        return spanCount;
+    }
+}
@@ -0,0 +1,73 @@
+package net.rk4z.juef;
+
+/**
+ * Frame timing of one display driven by {@link UefRenderer#pumpDisplays(long)}, see
+ * {@link UefRenderer#getDisplayStats(int)}. A snapshot; it does not update by itself.
+ */
+public final class UefDisplayStats {
+    static final int LENGTH = 8;
+
+    private final long ticks;
+    private final long missedTicks;
+    private final long lastIntervalNanos;
+    private final long maxLatenessNanos;
+    private final long totalLatenessNanos;
+    private final long periodNanos;
+    private final boolean idle;
+
+    UefDisplayStats(long[] stats) {
+        ticks = stats[0];
+        missedTicks = stats[1];
+        lastIntervalNanos = stats[2];
+        maxLatenessNanos = stats[3];
+        totalLatenessNanos = stats[4];
+        periodNanos = stats[5];
+        idle = stats[6] != 0;
+    }
+
+    /**
+     * @return How many times RefreshDisplay was called for this display
+     */
+    public long getTicks() {
+        return ticks;
+    }
+
+    /**
+     * @return Refresh periods skipped because the renderer thread woke up more than a period late
+     */
+    public long getMissedTicks() {
+        return missedTicks;
+    }
+
+    /**
+     * @return Nanoseconds between the two most recent refreshes
+     */
+    public long getLastIntervalNanos() {
+        return lastIntervalNanos;
+    }
+
+    public long getMaxLatenessNanos() {
+        return maxLatenessNanos;
+    }
+
+    /**
+     * @return Average nanoseconds a refresh ran after its deadline
+     */
+    public long getAverageLatenessNanos() {
+        return ticks == 0 ? 0 : totalLatenessNanos / ticks;
+    }
+
+    /**
+     * @return The refresh period currently in effect, the idle one while {@link #isIdle()}
+     */
+    public long getPeriodNanos() {
+        return periodNanos;
+    }
+
+    /**
+     * @return Whether the display is throttled because none of its Views has anything to paint
+     */
+    public boolean isIdle() {
+        return idle;
+    }
+}
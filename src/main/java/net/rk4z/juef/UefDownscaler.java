@@ -0,0 +1,65 @@
+package net.rk4z.juef;
+
+import net.rk4z.juef.util.ScaleFilter;
+
+import java.nio.ByteBuffer;
+
+/**
+ * Native generation of several downscaled copies of one rendered image, e.g. all thumbnail sizes
+ * of a page from a single render. Sizes are derived through a chain of 2x reductions built once per
+ * call; the work is split in row bands across a native worker pool and the calling thread takes
+ * part, so call this off the renderer thread.
+ *
+ * <p>Input and output pixels are premultiplied BGRA. Each result is a direct buffer of
+ * {@code width * 4}-byte rows whose native memory is freed once it becomes unreachable.</p>
+ */
+public final class UefDownscaler {
+    private UefDownscaler() {
+    }
+
+    /**
+     * @param pixels Direct buffer of premultiplied BGRA pixels
+     * @param rowBytes Bytes per row of the pixels
+     * @param sizes Output sizes as width, height pairs, none larger than the source
+     * @return One image per size, in the same order
+     */
+    public static ByteBuffer[] downscale(ByteBuffer pixels, int rowBytes, int width, int height, int[] sizes, ScaleFilter filter) {
+        long[] blobs = downscaleImage(pixels, rowBytes, width, height, sizes, filter);
+        ByteBuffer[] images = new ByteBuffer[blobs.length];
+        for (int i = 0; i < blobs.length; i++) {
+            images[i] = NativeMemory.wrap(blobs[i]);
+        }
+        return images;
+    }
+
+    public static ByteBuffer[] downscale(UefFrame frame, int[] sizes, ScaleFilter filter) {
+        return downscale(frame.getPixels(), frame.getRowBytes(), frame.getWidth(), frame.getHeight(), sizes, filter);
+    }
+
+    public static ByteBuffer[] downscale(UefSurface surface, int[] sizes, ScaleFilter filter) {
+        return downscale(surface.getPixels(), surface.getRowBytes(), surface.getWidth(), surface.getHeight(), sizes, filter);
+    }
+
+    /**
+     * Size that fits an image within a square of {@code maxEdge} pixels, keeping its aspect ratio.
+     * Images already small enough keep their size.
+     *
+     * @return A width, height pair, to be appended to the sizes passed to {@code downscale}
+     */
+    public static int[] fit(int width, int height, int maxEdge) {
+        int longEdge = Math.max(width, height);
+        if (longEdge <= maxEdge) {
+            return new int[] {width, height};
+        }
+        return new int[] {
+            Math.max(1, (int) Math.round((double) width * maxEdge / longEdge)),
+            Math.max(1, (int) Math.round((double) height * maxEdge / longEdge)),
+        };
+    }
+
+//>------------------- Native methods --------------------<\\
+
+    private static native long[] downscaleImage(ByteBuffer pixels, int rowBytes, int width, int height, int[] sizes, ScaleFilter filter);
+
+//>------------------- Native methods --------------------<\\
+}
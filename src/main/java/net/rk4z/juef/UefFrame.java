@@ -0,0 +1,59 @@
+package net.rk4z.juef;
+
+import java.nio.ByteBuffer;
+
+/**
+ * A completed frame handed out by {@link UefFrameReader#acquire()}.
+ *
+ * <p>Pixels are premultiplied BGRA, 4 bytes per pixel, {@link #getRowBytes()} bytes per row.</p>
+ */
+public final class UefFrame {
+    private ByteBuffer pixels;
+    private int width;
+    private int height;
+    private int rowBytes;
+    private long number;
+    private boolean fresh;
+
+    UefFrame() {
+    }
+
+    void update(ByteBuffer pixels, long[] info) {
+        this.pixels = pixels;
+        width = (int) info[2];
+        height = (int) info[3];
+        rowBytes = (int) info[4];
+        number = info[5];
+        fresh = info[6] != 0;
+    }
+
+    public ByteBuffer getPixels() {
+        return pixels;
+    }
+
+    public int getWidth() {
+        return width;
+    }
+
+    public int getHeight() {
+        return height;
+    }
+
+    public int getRowBytes() {
+        return rowBytes;
+    }
+
+    /**
+     * @return The renderer's sequence number of this frame, starting at 1
+     */
+    public long getNumber() {
+        return number;
+    }
+
+    /**
+     * @return Whether this frame is new since the previous {@link UefFrameReader#acquire()}
+     */
+    public boolean isFresh() {
+        return fresh;
+    }
+}
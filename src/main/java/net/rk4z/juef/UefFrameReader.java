@@ -0,0 +1,176 @@
+package net.rk4z.juef;
+
+import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/**
+ * Reads completed frames of a View created with {@code SurfaceType.TripleBuffered}, see
+ * {@link UefView#openFrameReader()}.
+ *
+ * <p>The renderer publishes every painted frame into one of three native buffers and never waits for
+ * the reader, so {@link #acquire()} can be called from any single thread at any pace: a slow reader
+ * simply skips frames (counted by {@link #getSupersededFrames()}). The buffers stay valid after the
+ * View is released, until this reader is closed or becomes unreachable.</p>
+ *
+ * <p>{@link #close()} may race with the other methods from another thread; they throw
+ * {@link IllegalStateException} once the reader is closed. The native buffers are freed by whichever
+ * of close() and the last call still in progress finishes last, so no call takes a lock.</p>
+ */
+public final class UefFrameReader implements AutoCloseable {
+    private static final Cleaner CLEANER = Cleaner.create();
+    private static final int INFO_LENGTH = 7;
+    private static final int STATS_LENGTH = 6;
+    private static final int CLOSED = 1 << 31;
+
+    private final long readerPtr;
+    private final Cleaner.Cleanable cleanable;
+    private final long[] info = new long[INFO_LENGTH];
+    private final ByteBuffer[] buffers = new ByteBuffer[3];
+    private final int[] bufferGenerations = new int[3];
+    private final UefFrame frame = new UefFrame();
+    // The CLOSED bit plus the number of native calls in progress.
+    private final AtomicInteger state = new AtomicInteger();
+
+    UefFrameReader(long readerPtr) {
+        this.readerPtr = readerPtr;
+        this.cleanable = CLEANER.register(this, new Close(readerPtr));
+    }
+
+    /**
+     * Take the most recently completed frame. The returned object is reused by every call and its
+     * pixels stay untouched by the renderer until the next {@code acquire()}.
+     *
+     * @return The latest frame ({@link UefFrame#isFresh()} tells whether it is new since the previous
+     *         call), or null when nothing has been painted at the current size yet
+     */
+    public UefFrame acquire() {
+        enter();
+        try {
+            if (!acquire(readerPtr, info)) {
+                return null;
+            }
+
+            int index = (int) info[0];
+            int generation = (int) info[1];
+            // Each buffer is wrapped once per resize; in between the same ByteBuffer is handed out again.
+            if (buffers[index] == null || bufferGenerations[index] != generation) {
+                ByteBuffer buffer = buffer(readerPtr, index, generation);
+                buffers[index] = buffer == null ? null : buffer.order(ByteOrder.LITTLE_ENDIAN);
+                bufferGenerations[index] = generation;
+            }
+
+            frame.update(buffers[index], info);
+            return frame;
+        } finally {
+            exit();
+        }
+    }
+
+    /**
+     * @return How many frames the renderer has published
+     */
+    public long getPublishedFrames() {
+        return readStat(0);
+    }
+
+    /**
+     * @return How many new frames this reader has acquired
+     */
+    public long getAcquiredFrames() {
+        return readStat(1);
+    }
+
+    /**
+     * @return How many frames were replaced by a newer one before this reader got to them
+     */
+    public long getSupersededFrames() {
+        return readStat(2);
+    }
+
+    /**
+     * @return Nanoseconds between publishing and acquiring the most recently acquired frame
+     */
+    public long getLastLatencyNanos() {
+        return readStat(3);
+    }
+
+    public long getMaxLatencyNanos() {
+        return readStat(4);
+    }
+
+    public long getAverageLatencyNanos() {
+        long[] stats = readStats();
+        return stats[1] == 0 ? 0 : stats[5] / stats[1];
+    }
+
+    private long readStat(int index) {
+        return readStats()[index];
+    }
+
+    // Stats may be read from any thread, so every call gets an array of its own.
+    private long[] readStats() {
+        long[] stats = new long[STATS_LENGTH];
+        enter();
+        try {
+            stats(readerPtr, stats);
+        } finally {
+            exit();
+        }
+        return stats;
+    }
+
+    private void enter() {
+        int current;
+        do {
+            current = state.get();
+            if ((current & CLOSED) != 0) {
+                throw new IllegalStateException("The frame reader is closed");
+            }
+        } while (!state.compareAndSet(current, current + 1));
+    }
+
+    private void exit() {
+        if (state.decrementAndGet() == CLOSED) {
+            cleanable.clean();
+        }
+    }
+
+    /**
+     * Release the native buffers. Frames acquired earlier must not be used afterwards.
+     */
+    @Override
+    public void close() {
+        int previous = state.getAndAccumulate(CLOSED, (current, closed) -> current | closed);
+        // With calls still in progress, the last of them frees the buffers on its way out.
+        if (previous == 0) {
+            cleanable.clean();
+        }
+    }
+
+//>------------------- Native methods --------------------<\\
+
+    private static native boolean acquire(long readerPtr, long[] info);
+
+    private static native ByteBuffer buffer(long readerPtr, int index, int generation);
+
+    private static native void stats(long readerPtr, long[] stats);
+
+    private static native void close(long readerPtr);
+
+//>------------------- Native methods --------------------<\\
+
+    private static final class Close implements Runnable {
+        private final long readerPtr;
+
+        private Close(long readerPtr) {
+            this.readerPtr = readerPtr;
+        }
+
+        @Override
+        public void run() {
+            close(readerPtr);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+package net.rk4z.juef;
+
+/**
+ * Activity of View hibernation, see {@link UefRenderer#setHibernation}. A snapshot; it does not
+ * update by itself.
+ */
+public final class UefHibernationStats {
+    static final int LENGTH = 8;
+
+    private final int hibernatedViews;
+    private final long bytesSaved;
+    private final long hibernations;
+    private final long restores;
+    private final long lastRestoreNanos;
+    private final long maxRestoreNanos;
+    private final long totalRestoreNanos;
+    private final long purges;
+
+    UefHibernationStats(long[] stats) {
+        hibernatedViews = (int) stats[0];
+        bytesSaved = stats[1];
+        hibernations = stats[2];
+        restores = stats[3];
+        lastRestoreNanos = stats[4];
+        maxRestoreNanos = stats[5];
+        totalRestoreNanos = stats[6];
+        purges = stats[7];
+    }
+
+    /**
+     * @return Views hibernating right now
+     */
+    public int getHibernatedViews() {
+        return hibernatedViews;
+    }
+
+    /**
+     * @return Surface memory currently released by hibernating Views, net of their compressed copies
+     */
+    public long getBytesSaved() {
+        return bytesSaved;
+    }
+
+    public long getHibernations() {
+        return hibernations;
+    }
+
+    public long getRestores() {
+        return restores;
+    }
+
+    /**
+     * @return Nanoseconds the most recent restore took to bring the pixels back
+     */
+    public long getLastRestoreNanos() {
+        return lastRestoreNanos;
+    }
+
+    public long getMaxRestoreNanos() {
+        return maxRestoreNanos;
+    }
+
+    public long getAverageRestoreNanos() {
+        return restores == 0 ? 0 : totalRestoreNanos / restores;
+    }
+
+    /**
+     * @return How many times the Renderer was asked to purge its memory
+     */
+    public long getPurges() {
+        return purges;
+    }
+}
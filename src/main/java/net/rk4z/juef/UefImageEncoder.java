@@ -0,0 +1,35 @@
+package net.rk4z.juef;
+
+import net.rk4z.juef.util.ImageFormat;
+
+import java.nio.ByteBuffer;
+
+/**
+ * Native image encoding of premultiplied BGRA pixels, e.g. a {@link UefFrame} picked up on a
+ * consumer thread. PNG strips are deflated in parallel on a native worker pool; the calling thread
+ * takes part and returns once the image is complete, so call this off the renderer thread to keep
+ * encoding overlapped with rendering.
+ */
+public final class UefImageEncoder {
+    private UefImageEncoder() {
+    }
+
+    /**
+     * @param pixels Direct buffer of premultiplied BGRA pixels
+     * @param rowBytes Bytes per row of the pixels
+     * @return The encoded image in a direct buffer whose native memory is freed once it becomes unreachable
+     */
+    public static ByteBuffer encode(ByteBuffer pixels, int rowBytes, int width, int height, ImageFormat format) {
+        return NativeMemory.wrap(encodeImage(pixels, rowBytes, width, height, format));
+    }
+
+    public static ByteBuffer encode(UefFrame frame, ImageFormat format) {
+        return encode(frame.getPixels(), frame.getRowBytes(), frame.getWidth(), frame.getHeight(), format);
+    }
+
+//>------------------- Native methods --------------------<\\
+
+    private static native long encodeImage(ByteBuffer pixels, int rowBytes, int width, int height, ImageFormat format);
+
+//>------------------- Native methods --------------------<\\
+}
@@ -0,0 +1,70 @@
+package net.rk4z.juef;
+
+import net.rk4z.juef.util.PixelFormat;
+
+import java.nio.ByteBuffer;
+
+/**
+ * Native conversion of premultiplied BGRA pixels (a {@link UefSurface}, a {@link UefFrame} or a raw
+ * image from {@link UefRenderService}) into the layouts Java code works with. Swizzling,
+ * unpremultiplying and repacking happen in one SIMD pass, straight into the destination.
+ *
+ * <p>Offsets and strides are in elements of the destination: ints for {@code int[]}, bytes
+ * otherwise.</p>
+ */
+public final class UefPixels {
+    private UefPixels() {
+    }
+
+    /**
+     * Convert a rectangle into an {@code int[]}, e.g. the data array of a {@code TYPE_INT_ARGB}
+     * BufferedImage. Only 4-byte formats are allowed.
+     *
+     * @param source Direct buffer of premultiplied BGRA pixels
+     * @param sourceRowBytes Bytes per row of the source
+     */
+    public static void convert(ByteBuffer source, int sourceRowBytes, int x, int y, int width, int height,
+                               PixelFormat format, int[] destination, int offset, int stride) {
+        if (format == PixelFormat.Rgb) {
+            throw new IllegalArgumentException("PixelFormat.Rgb cannot be stored in an int[]");
+        }
+        convert(source, sourceRowBytes, x, y, width, height, format, destination, 2, null, offset * 4L, stride * 4L);
+    }
+
+    /**
+     * Convert a rectangle into a {@code byte[]}.
+     */
+    public static void convert(ByteBuffer source, int sourceRowBytes, int x, int y, int width, int height,
+                               PixelFormat format, byte[] destination, int offset, int stride) {
+        convert(source, sourceRowBytes, x, y, width, height, format, destination, 0, null, offset, stride);
+    }
+
+    /**
+     * Convert a rectangle into a direct ByteBuffer. The buffer's position and limit are ignored.
+     */
+    public static void convert(ByteBuffer source, int sourceRowBytes, int x, int y, int width, int height,
+                               PixelFormat format, ByteBuffer destination, int offset, int stride) {
+        convert(source, sourceRowBytes, x, y, width, height, format, null, 0, destination, offset, stride);
+    }
+
+    /**
+     * Convert a whole surface into a tightly packed {@code int[]}.
+     */
+    public static void convert(UefSurface surface, PixelFormat format, int[] destination) {
+        convert(surface.getPixels(), surface.getRowBytes(), 0, 0, surface.getWidth(), surface.getHeight(),
+                format, destination, 0, surface.getWidth());
+    }
+
+//>------------------- Native methods --------------------<\\
+
+    private static native void convert(ByteBuffer source, int sourceRowBytes, int x, int y, int width, int height,
+                                       PixelFormat format, Object destinationArray, int elementShift,
+                                       ByteBuffer destinationBuffer, long destinationOffset, long destinationRowBytes);
+
+    /**
+     * @return The instruction set the conversion kernels were selected for: avx2, sse4.1, neon or scalar
+     */
+    public static native String getInstructionSet();
+
+//>------------------- Native methods --------------------<\\
+}
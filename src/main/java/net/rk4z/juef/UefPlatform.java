@@ -1,11 +1,183 @@
 package net.rk4z.juef;
 
+import net.rk4z.juef.configuration.PackedConfig;
 import net.rk4z.juef.configuration.UefConfig;
+import net.rk4z.juef.util.SurfaceType;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
 
 public class UefPlatform {
+
+public static void setConfig(UefConfig config) {
+    PackedConfig packed = config.pack();
+    setConfig(packed.getBuffer(), packed.getVersion());
+}
+
+public static void setSurfaceFactory(SurfaceType type) {
+    setSurfaceFactory(type, 64);
+}
+
+public static UefSurfacePoolStats getSurfacePoolStats() {
+    long[] stats = new long[UefSurfacePoolStats.LENGTH];
+    getSurfacePoolStats(stats);
+    return new UefSurfacePoolStats(stats);
+}
+
+/**
+ * Serve {@code file:///} URLs from a directory on this library's classpath, 64 MiB of files kept in
+ * native memory. See {@link #mountClasspath(ClassLoader, String, long)}.
+ */
+public static void mountClasspath(String root) throws IOException {
+    mountClasspath(UefPlatform.class.getClassLoader(), root, 64L << 20);
+}
+
+/**
+ * Serve {@code file:///} URLs from a directory on the classpath, so assets inside a fat JAR need no
+ * extracting. What lies below the directory is listed once now; a file is read through the class
+ * loader the first time the engine opens it and then handed out from native memory, without calling
+ * into Java again until it is evicted. Mounts made later take precedence over earlier ones.
+ *
+ * <p>The first mount installs the native file system and must happen before {@link UefRenderer#create()}.</p>
+ *
+ * @param loader The class loader to list and read through
+ * @param root The directory, e.g. {@code "web"} for {@code web/index.html} to open as {@code file:///index.html}
+ * @param maxCachedBytes Memory kept in files read so far, least recently used dropped first
+ * @throws IllegalArgumentException When nothing lies below the directory
+ */
+public static void mountClasspath(ClassLoader loader, String root, long maxCachedBytes) throws IOException {
+    UefClasspathResources resources = UefClasspathResources.list(loader, root);
+    mountClasspath(resources.id, resources.names, resources.mimes, resources.charsets, maxCachedBytes);
+}
+
+/**
+ * Serve a file straight from a direct buffer, e.g. generated CSS or a font kept in a database. The
+ * engine reads the buffer's memory in place, between its position and limit at the time of this call,
+ * so those bytes must not change while the file is registered. The buffer stays reachable until the
+ * file is unregistered and the engine has let go of it. Registering a path again replaces the file.
+ *
+ * <p>Virtual files are served ahead of the file systems mounted before the first registration. If
+ * nothing is mounted yet, the first registration must happen before {@link UefRenderer#create()}.</p>
+ *
+ * @param path The path below {@code file:///}, e.g. {@code "theme.css"}
+ * @param buffer The contents, a direct buffer
+ * @param mime The mime type, optionally with a {@code charset} parameter; null to guess it from the extension
+ */
+public static void registerVirtualFile(String path, ByteBuffer buffer, String mime) {
+    if (!buffer.isDirect()) {
+        throw new IllegalArgumentException("The buffer must be a direct ByteBuffer");
+    }
+
+    String type = mime != null ? mime.trim() : UefAssetPacker.mimeType(path);
+    String charset = null;
+    int parameters = type.indexOf(';');
+    if (parameters >= 0) {
+        for (String parameter : type.substring(parameters + 1).split(";")) {
+            int equals = parameter.indexOf('=');
+            if (equals >= 0 && parameter.substring(0, equals).trim().equalsIgnoreCase("charset")) {
+                charset = parameter.substring(equals + 1).trim();
+            }
+        }
+        type = type.substring(0, parameters).trim();
+    }
+    if (charset == null) {
+        charset = UefAssetPacker.charset(type);
+    }
+    registerVirtualFile(path, buffer, buffer.position(), buffer.remaining(), type, charset);
+}
+
+public static UefClasspathStats getClasspathStats() {
+    long[] stats = new long[UefClasspathStats.LENGTH];
+    getClasspathStats(stats);
+    return new UefClasspathStats(stats);
+}
+
+/**
+ * What the engine's heap looks like to the allocator picked in {@link UefConfig}. Cheap enough to
+ * poll: rates come from comparing two snapshots, see {@link UefAllocatorStats#getAllocationRate}.
+ */
+public static UefAllocatorStats getAllocatorStats() {
+    long[] stats = new long[UefAllocatorStats.LENGTH];
+    getAllocatorStats(stats);
+    return new UefAllocatorStats(stats);
+}
+
 //>------------------- Native methods --------------------<\\
 
-public static native void setConfig(UefConfig config);
+private static native void setConfig(ByteBuffer config, long configVersion);
+
+/**
+ * Select the Surface implementation CPU-rendered Views paint into. Must be called before
+ * {@link UefRenderer#create()}.
+ *
+ * @param type The surface implementation
+ * @param tileSize Edge length in pixels of the damage tiles tracked by {@link SurfaceType#Tiled} surfaces
+ */
+public static native void setSurfaceFactory(SurfaceType type, int tileSize);
+
+/**
+ * Tune the pool that recycles the pixel buffers of {@link SurfaceType#Tiled} and
+ * {@link SurfaceType#TripleBuffered} surfaces, so resizing and recreating Views reuses memory
+ * instead of allocating and page-faulting it again.
+ *
+ * @param maxIdleBytes Memory kept in released buffers waiting for reuse, 0 to disable reuse (default 64 MiB)
+ * @param hugePages Whether buffers of 2 MiB and up are backed by huge pages when the system offers them (default true)
+ */
+public static native void setSurfacePool(long maxIdleBytes, boolean hugePages);
+
+/**
+ * Return every idle pooled buffer to the system, e.g. after closing many Views.
+ */
+public static native void trimSurfacePool();
+
+private static native void getSurfacePoolStats(long[] stats);
+
+/**
+ * Serve {@code file:///} URLs and the engine's own resources from an asset pack built by
+ * {@link UefAssetPacker}. The pack is mapped into memory once and files are handed to the engine
+ * without copying. Packs mounted later take precedence over earlier ones; they stay mapped for the
+ * life of the process.
+ *
+ * <p>The first mount installs the native file system and must happen before {@link UefRenderer#create()}.</p>
+ *
+ * @param path The pack file
+ * @throws IllegalArgumentException When the file is missing or not a valid pack
+ */
+public static native void mountAssetPack(String path);
+
+private static native void mountClasspath(int mount, String[] names, String[] mimes, String[] charsets,
+                                          long maxCachedBytes);
+
+private static native void getClasspathStats(long[] stats);
+
+private static native void registerVirtualFile(String path, ByteBuffer buffer, int offset, int length, String mime,
+                                               String charset);
+
+/**
+ * Remove a file registered with {@link #registerVirtualFile(String, ByteBuffer, String)}. Loads already
+ * reading it finish with the old contents.
+ *
+ * @return Whether a file was registered at the path
+ */
+public static native boolean unregisterVirtualFile(String path);
+
+/**
+ * Install the native font loader over every TrueType and OpenType font below the given directories.
+ * They are indexed once on a background thread, right away: families and styles for the fonts pages
+ * ask for, and which characters each font covers, so text no requested font can show falls back to a
+ * font that can without scanning the system. The index is kept below the config's cache path and only
+ * changed files are read again on the next start, so call {@link #setConfig(UefConfig)} first.
+ *
+ * <p>Must be called before {@link UefRenderer#create()}, and only once. Pages that need a font before
+ * the index is ready wait for it. If the directories hold no font, the operating system's are used.
+ * Only the first font of a {@code .ttc} collection is used.</p>
+ *
+ * @param directories The font directories; none for the operating system's own
+ * @throws IllegalStateException If the Renderer exists or the directories are already set
+ */
+public static native void setFontDirectories(String... directories);
+
+private static native void getAllocatorStats(long[] stats);
 
 //>------------------- Native methods --------------------<\\
 }
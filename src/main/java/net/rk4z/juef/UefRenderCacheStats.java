@@ -0,0 +1,84 @@
+package net.rk4z.juef;
+
+/**
+ * Hit rates and size of the render cache, see {@link UefRenderService#getCacheStats()}.
+ * A snapshot; it does not update by itself.
+ */
+public final class UefRenderCacheStats {
+    static final int LENGTH = 9;
+
+    private final long memoryHits;
+    private final long diskHits;
+    private final long misses;
+    private final long stores;
+    private final long evictions;
+    private final long memoryEntries;
+    private final long memoryBytes;
+    private final long diskEntries;
+    private final long diskBytes;
+
+    UefRenderCacheStats(long[] stats) {
+        memoryHits = stats[0];
+        diskHits = stats[1];
+        misses = stats[2];
+        stores = stats[3];
+        evictions = stats[4];
+        memoryEntries = stats[5];
+        memoryBytes = stats[6];
+        diskEntries = stats[7];
+        diskBytes = stats[8];
+    }
+
+    public long getMemoryHits() {
+        return memoryHits;
+    }
+
+    /**
+     * @return Hits served from the disk tier, each of which was promoted into memory
+     */
+    public long getDiskHits() {
+        return diskHits;
+    }
+
+    public long getMisses() {
+        return misses;
+    }
+
+    /**
+     * @return Share of lookups answered from either tier, 0 before the first lookup
+     */
+    public double getHitRate() {
+        long lookups = memoryHits + diskHits + misses;
+        return lookups > 0 ? (double) (memoryHits + diskHits) / lookups : 0;
+    }
+
+    /**
+     * @return Rendered images added to the cache
+     */
+    public long getStores() {
+        return stores;
+    }
+
+    /**
+     * @return Entries dropped from either tier to stay within its budget
+     */
+    public long getEvictions() {
+        return evictions;
+    }
+
+    public long getMemoryEntries() {
+        return memoryEntries;
+    }
+
+    public long getMemoryBytes() {
+        return memoryBytes;
+    }
+
+    public long getDiskEntries() {
+        return diskEntries;
+    }
+
+    public long getDiskBytes() {
+        return diskBytes;
+    }
+}
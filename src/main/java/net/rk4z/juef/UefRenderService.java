@@ -0,0 +1,158 @@
+package net.rk4z.juef;
+
+import net.rk4z.juef.util.ImageFormat;
+
+import java.nio.ByteBuffer;
+import java.util.Map;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.RejectedExecutionException;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * Headless HTML-to-image rendering.
+ *
+ * <p>Jobs can be submitted from any thread. They wait in a bounded native queue and are run on a pool
+ * of reusable Views by {@link #pump()}, which must be called regularly on the renderer thread. A
+ * job's View is painted, captured and encoded natively as soon as its page finishes loading, and
+ * the image is delivered as a direct ByteBuffer whose native memory is freed once it becomes
+ * unreachable. Futures are completed on the renderer thread; use the {@code *Async} stages for
+ * heavy follow-up work.</p>
+ *
+ * <p>Repeated HTML can be served from a content-addressed cache, see {@link #configureCache}.</p>
+ */
+public final class UefRenderService {
+    private static final AtomicLong NEXT_JOB_ID = new AtomicLong();
+    private static final Map<Long, CompletableFuture<ByteBuffer>> PENDING = new ConcurrentHashMap<>();
+    private static volatile long submitTimeoutNanos = 1_000_000_000L;
+
+    private UefRenderService() {
+    }
+
+    /**
+     * @param poolSize Number of Views jobs run on concurrently (default 4)
+     * @param queueCapacity Jobs that may wait for a View before submitters are held back (default 256)
+     * @param loadTimeoutMillis Time a page may take to load before its job fails, 0 for none (default 30000)
+     * @param submitTimeoutMillis Time a submit waits for room in a full queue before it is rejected (default 1000)
+     */
+    public static void configure(int poolSize, int queueCapacity, long loadTimeoutMillis, long submitTimeoutMillis) {
+        submitTimeoutNanos = Math.max(submitTimeoutMillis, 0) * 1_000_000L;
+        configure(poolSize, queueCapacity, loadTimeoutMillis);
+    }
+
+    /**
+     * Render an HTML document to an image.
+     *
+     * @param html The document
+     * @param width Width in pixels
+     * @param height Height in pixels
+     * @param scale Device scale the page is laid out at
+     * @param format Encoding of the result
+     * @return The encoded image. Fails with {@link RejectedExecutionException} when the queue stays
+     *         full for the submit timeout, or {@link IllegalStateException} when the page fails to load
+     */
+    public static CompletableFuture<ByteBuffer> submitHtml(String html, int width, int height, double scale, ImageFormat format) {
+        return submit(false, html, width, height, scale, format);
+    }
+
+    /**
+     * Render the page at a URL to an image, see {@link #submitHtml}.
+     */
+    public static CompletableFuture<ByteBuffer> submitUrl(String url, int width, int height, double scale, ImageFormat format) {
+        return submit(true, url, width, height, scale, format);
+    }
+
+    public static UefRenderCacheStats getCacheStats() {
+        long[] stats = new long[UefRenderCacheStats.LENGTH];
+        cacheStats(stats);
+        return new UefRenderCacheStats(stats);
+    }
+
+    public static UefRenderServiceStats getStats() {
+        long[] stats = new long[UefRenderServiceStats.LENGTH];
+        stats(stats);
+        return new UefRenderServiceStats(stats);
+    }
+
+    private static CompletableFuture<ByteBuffer> submit(boolean isUrl, String source, int width, int height, double scale, ImageFormat format) {
+        if (width <= 0 || height <= 0) {
+            throw new IllegalArgumentException("Image size must be positive: " + width + "x" + height);
+        }
+
+        CompletableFuture<ByteBuffer> future = new CompletableFuture<>();
+        long id = track(future);
+        if (!enqueue(id, isUrl, source, width, height, scale, format, submitTimeoutNanos)) {
+            PENDING.remove(id);
+            future.completeExceptionally(new RejectedExecutionException("UefRenderService queue is full"));
+        }
+        return future;
+    }
+
+    // Futures completed by complete/fail, shared with UefTemplateBatch.
+    static long track(CompletableFuture<ByteBuffer> future) {
+        long id = NEXT_JOB_ID.incrementAndGet();
+        PENDING.put(id, future);
+        return id;
+    }
+
+    // Forgets a tracked future whose job never reached native code.
+    static void untrack(long id) {
+        PENDING.remove(id);
+    }
+
+    // Called from native code on the renderer thread.
+    private static void complete(long id, ByteBuffer image, long blobPtr) {
+        NativeMemory.register(image, blobPtr);
+        CompletableFuture<ByteBuffer> future = PENDING.remove(id);
+        if (future != null) {
+            future.complete(image);
+        }
+    }
+
+    // Called from native code on the renderer thread.
+    private static void fail(long id, String message) {
+        CompletableFuture<ByteBuffer> future = PENDING.remove(id);
+        if (future != null) {
+            future.completeExceptionally(new IllegalStateException(message));
+        }
+    }
+
+//>------------------- Native methods --------------------<\\
+
+    private static native void configure(int poolSize, int queueCapacity, long loadTimeoutMillis);
+
+    private static native boolean enqueue(long id, boolean isUrl, String source, int width, int height, double scale, ImageFormat format, long waitNanos);
+
+    /**
+     * Start queued jobs on idle Views, advance loading pages and open {@link UefTemplateBatch}es, and
+     * deliver every finished image. Must be called on the renderer thread, e.g. once per iteration of
+     * its loop.
+     *
+     * @return How many jobs completed or failed during this call
+     */
+    public static native int pump();
+
+    private static native void stats(long[] stats);
+
+    /**
+     * Turn the render cache on, resize it, or turn it off with both budgets at 0 (the default).
+     *
+     * <p>HTML jobs are keyed by their document, size, scale and format; a job whose key was rendered
+     * before completes from the cache without loading a View. Entries are kept in memory and, with a
+     * disk budget, as files under {@code <cachePath>/render/} of the {@link net.rk4z.juef.configuration.UefConfig}
+     * that are found again after a restart. URL jobs are never cached.</p>
+     *
+     * @param memoryBytes Size of the in-memory tier, least recently used entries are dropped first
+     * @param diskBytes Size of the on-disk tier, 0 keeps the cache in memory only
+     */
+    public static native void configureCache(long memoryBytes, long diskBytes);
+
+    /**
+     * Drop every cached image, including the files of the disk tier.
+     */
+    public static native void clearCache();
+
+    private static native void cacheStats(long[] stats);
+
+//>------------------- Native methods --------------------<\\
+}
@@ -0,0 +1,79 @@
+package net.rk4z.juef;
+
+/**
+ * Counters and latency of {@link UefRenderService}, see {@link UefRenderService#getStats()}.
+ * A snapshot; it does not update by itself.
+ */
+public final class UefRenderServiceStats {
+    static final int LENGTH = 10;
+
+    private final long submitted;
+    private final long completed;
+    private final long failed;
+    private final long rejected;
+    private final long queued;
+    private final long active;
+    private final long p50LatencyNanos;
+    private final long p99LatencyNanos;
+    private final double jobsPerSecond;
+
+    UefRenderServiceStats(long[] stats) {
+        submitted = stats[0];
+        completed = stats[1];
+        failed = stats[2];
+        rejected = stats[3];
+        queued = stats[4];
+        active = stats[5];
+        p50LatencyNanos = stats[6];
+        p99LatencyNanos = stats[7];
+        jobsPerSecond = stats[9] > 0 ? stats[8] * 1_000_000_000.0 / stats[9] : 0;
+    }
+
+    public long getSubmitted() {
+        return submitted;
+    }
+
+    public long getCompleted() {
+        return completed;
+    }
+
+    public long getFailed() {
+        return failed;
+    }
+
+    /**
+     * @return Jobs refused because the queue stayed full for the whole submit timeout
+     */
+    public long getRejected() {
+        return rejected;
+    }
+
+    public long getQueued() {
+        return queued;
+    }
+
+    /**
+     * @return Jobs currently loading on a pooled View
+     */
+    public long getActive() {
+        return active;
+    }
+
+    /**
+     * @return Median submit-to-result latency over the last 1024 completed jobs
+     */
+    public long getP50LatencyNanos() {
+        return p50LatencyNanos;
+    }
+
+    public long getP99LatencyNanos() {
+        return p99LatencyNanos;
+    }
+
+    /**
+     * @return Completion rate over the last 1024 completed jobs
+     */
+    public double getJobsPerSecond() {
+        return jobsPerSecond;
+    }
+}
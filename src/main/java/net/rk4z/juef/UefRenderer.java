@@ -1,15 +1,125 @@
 package net.rk4z.juef;
 
+import net.rk4z.juef.configuration.PackedConfig;
 import net.rk4z.juef.configuration.ViewConfig;
+import net.rk4z.juef.util.HibernateMode;
+
+import java.nio.ByteBuffer;
 
 public class UefRenderer {
 
+public static UefView createView(int width, int height, ViewConfig config, UefSession session) {
+    PackedConfig packed = config.pack();
+    return createView(width, height, packed.getBuffer(), packed.getVersion(), session);
+}
+
+/**
+ * @param displayId A display configured with {@link #setDisplayClock}
+ * @return The display's frame timing, or null if it has no clock
+ */
+public static UefDisplayStats getDisplayStats(int displayId) {
+    long[] stats = new long[UefDisplayStats.LENGTH];
+    return getDisplayStats(displayId, stats) ? new UefDisplayStats(stats) : null;
+}
+
+public static UefHibernationStats getHibernationStats() {
+    long[] stats = new long[UefHibernationStats.LENGTH];
+    getHibernationStats(stats);
+    return new UefHibernationStats(stats);
+}
+
 //>------------------- Native methods --------------------<\\
 
-public static native UefView createView(int width, int height, ViewConfig config, UefSession session);
+public static native void create();
+
+private static native UefView createView(int width, int height, ByteBuffer config, long configVersion, UefSession session);
 
 public static native void refreshDisplay(int displayId);
 
+public static native void update();
+
+public static native void render();
+
+/**
+ * Configure {@link #renderFrame()}.
+ *
+ * @param budgetMillis Estimated paint time allowed per frame, 0 for unlimited (default 8)
+ * @param starvationFrames Frames a {@link net.rk4z.juef.util.ViewPriority#Background} View may be
+ *                         deferred before it is ranked like a visible one, 0 to never promote (default 30)
+ */
+public static native void setFrameBudget(double budgetMillis, int starvationFrames);
+
+/**
+ * Paint the Views that need it, by {@link UefView#setPriority priority} and within the frame
+ * budget, in a single pass. Use instead of {@link #render()} when many Views share the renderer.
+ *
+ * @return How many Views were painted
+ */
+public static native int renderFrame();
+
+/**
+ * Let {@link #pumpDisplays(long)} refresh a display natively instead of calling
+ * {@link #refreshDisplay(int)} from Java.
+ *
+ * @param displayId The display, matching {@code ViewConfig.displayId}
+ * @param hz Refresh rate, 0 or less to stop refreshing the display
+ * @param idleHz Rate used while none of the display's Views has anything to paint, 0 to never throttle
+ */
+public static native void setDisplayClock(int displayId, double hz, double idleHz);
+
+/**
+ * Sleep until the next display deadline (at most maxWaitNanos), then refresh every display that is
+ * due and call {@link #update()} once. Meant to be called in the renderer thread's loop.
+ *
+ * @param maxWaitNanos Longest time to sleep before returning without refreshing
+ * @return How many displays were refreshed
+ */
+public static native int pumpDisplays(long maxWaitNanos);
+
+private static native boolean getDisplayStats(int displayId, long[] stats);
+
+/**
+ * Bring a display that dropped to its idle rate back to full rate, so the next
+ * {@link #pumpDisplays(long)} refreshes it right away instead of after the rest of the idle period.
+ * Call it when input for one of the display's Views arrives. May be called from any thread; resizing,
+ * focusing or re-prioritizing a View already wakes its display.
+ *
+ * @param displayId A display configured with {@link #setDisplayClock}
+ */
+public static native void wakeDisplay(int displayId);
+
+/**
+ * Release the surface memory of Views that stay {@link net.rk4z.juef.util.ViewPriority#Hidden}.
+ * Views hibernate from {@link #renderFrame()} (or {@link #hibernateIdleViews()}) and are restored as
+ * soon as their priority changes or the engine paints them. Only Views on
+ * {@code SurfaceType.Tiled} surfaces hibernate.
+ *
+ * @param hiddenMillis How long a View must be hidden before it hibernates, 0 to only hibernate on
+ *                     {@link UefView#hibernate} (the default)
+ * @param mode Whether a compressed copy of the pixels is kept or they are painted again on restore
+ * @param purgeAfter Hibernations between two Renderer memory purges, 0 to never purge (default 16)
+ */
+public static native void setHibernation(long hiddenMillis, HibernateMode mode, int purgeAfter);
+
+/**
+ * Apply {@link #setHibernation} now; {@link #renderFrame()} already does this every frame.
+ *
+ * @return How many Views were hibernated
+ */
+public static native int hibernateIdleViews();
+
+private static native void getHibernationStats(long[] stats);
+
+/**
+ * Configure how {@link UefView#resize} requests are applied during interactive resizes.
+ *
+ * @param slack Whether {@link net.rk4z.juef.util.SurfaceType#Tiled} surfaces grow in 64 px steps and
+ *              keep their buffer while the size changes, instead of reallocating on every resize (default true)
+ * @param settleMillis How long a View's size must stay the same before its surface shrinks back to
+ *                     the exact size (default 250)
+ */
+public static native void setResizeCoalescing(boolean slack, int settleMillis);
+
 //>------------------- Native methods --------------------<\\
 
 }
@@ -0,0 +1,119 @@
+package net.rk4z.juef;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * The locked pixel buffer of a View rendered with the CPU renderer, see {@link UefView#lockSurface()}.
+ *
+ * <p>Pixels are premultiplied BGRA, 4 bytes per pixel, {@link #getRowBytes()} bytes per row. The
+ * buffer points straight at the native surface and is only valid until {@link #close()}.</p>
+ */
+public final class UefSurface implements AutoCloseable {
+    static final int INFO_LENGTH = 9;
+
+    private final UefView view;
+    private ByteBuffer pixels;
+    private int width;
+    private int height;
+    private int rowBytes;
+    private int dirtyLeft;
+    private int dirtyTop;
+    private int dirtyRight;
+    private int dirtyBottom;
+    private int[] dirtyTiles = new int[0];
+    private int dirtyTileCount;
+    private int tileSize;
+
+    UefSurface(UefView view) {
+        this.view = view;
+    }
+
+    void update(ByteBuffer newPixels, int[] info) {
+        // The native side only hands out a new buffer when the backing store was reallocated.
+        if (newPixels != null) {
+            pixels = newPixels.order(ByteOrder.LITTLE_ENDIAN);
+        }
+        width = info[0];
+        height = info[1];
+        rowBytes = info[2];
+        dirtyLeft = info[3];
+        dirtyTop = info[4];
+        dirtyRight = info[5];
+        dirtyBottom = info[6];
+        dirtyTileCount = info[7];
+        tileSize = info[8];
+        if (dirtyTiles.length < dirtyTileCount) {
+            dirtyTiles = new int[Math.max(dirtyTileCount, dirtyTiles.length * 2)];
+        }
+    }
+
+    public ByteBuffer getPixels() {
+        return pixels;
+    }
+
+    public int getWidth() {
+        return width;
+    }
+
+    public int getHeight() {
+        return height;
+    }
+
+    public int getRowBytes() {
+        return rowBytes;
+    }
+
+    /**
+     * @return Whether anything was painted since the previous lock
+     */
+    public boolean isDirty() {
+        return dirtyRight > dirtyLeft && dirtyBottom > dirtyTop;
+    }
+
+    public int getDirtyLeft() {
+        return dirtyLeft;
+    }
+
+    public int getDirtyTop() {
+        return dirtyTop;
+    }
+
+    public int getDirtyRight() {
+        return dirtyRight;
+    }
+
+    public int getDirtyBottom() {
+        return dirtyBottom;
+    }
+
+    /**
+     * The tiles painted since the previous lock, each packed as {@code (tileY << 16) | tileX}, in
+     * row-major order. Only the first {@link #getDirtyTileCount()} entries are valid; the array is
+     * reused between locks. Always empty unless {@code SurfaceType.Tiled} surfaces are in use.
+     *
+     * @return The dirty tile array
+     */
+    public int[] getDirtyTiles() {
+        return dirtyTiles;
+    }
+
+    public int getDirtyTileCount() {
+        return dirtyTileCount;
+    }
+
+    /**
+     * @return Edge length of a tile in pixels, or 0 if this surface does not track tiles
+     */
+    public int getTileSize() {
+        return tileSize;
+    }
+
+    /**
+     * Unlock the surface so the renderer can paint into it again.
+     */
+    @Override
+    public void close() {
+        view.unlockSurface();
+    }
+}
@@ -0,0 +1,74 @@
+package net.rk4z.juef;
+
+/**
+ * Activity of the surface buffer pool, see {@link UefPlatform#setSurfacePool}. A snapshot; it does
+ * not update by itself.
+ */
+public final class UefSurfacePoolStats {
+    static final int LENGTH = 7;
+
+    private final long acquires;
+    private final long hits;
+    private final long residentBytes;
+    private final long idleBytes;
+    private final long hugePageBytes;
+    private final long peakResidentBytes;
+    private final long evictions;
+
+    UefSurfacePoolStats(long[] stats) {
+        acquires = stats[0];
+        hits = stats[1];
+        residentBytes = stats[2];
+        idleBytes = stats[3];
+        hugePageBytes = stats[4];
+        peakResidentBytes = stats[5];
+        evictions = stats[6];
+    }
+
+    /**
+     * @return How many buffers surfaces asked for
+     */
+    public long getAcquires() {
+        return acquires;
+    }
+
+    /**
+     * @return How many of them were served from a released buffer
+     */
+    public long getHits() {
+        return hits;
+    }
+
+    public double getHitRate() {
+        return acquires == 0 ? 0 : (double) hits / acquires;
+    }
+
+    /**
+     * @return Memory held by the pool, in use or idle, rounded up to size classes
+     */
+    public long getResidentBytes() {
+        return residentBytes;
+    }
+
+    public long getIdleBytes() {
+        return idleBytes;
+    }
+
+    /**
+     * @return Part of the resident memory explicitly backed by huge pages (transparent huge pages are not counted)
+     */
+    public long getHugePageBytes() {
+        return hugePageBytes;
+    }
+
+    public long getPeakResidentBytes() {
+        return peakResidentBytes;
+    }
+
+    /**
+     * @return Idle buffers returned to the system to stay within the idle limit
+     */
+    public long getEvictions() {
+        return evictions;
+    }
+}
@@ -0,0 +1,106 @@
+package net.rk4z.juef;
+
+import net.rk4z.juef.util.ImageFormat;
+
+import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+import java.util.concurrent.CompletableFuture;
+
+/**
+ * Renders many variants of one HTML template, e.g. certificates that only differ by name and date.
+ *
+ * <p>The template is loaded once into a View of its own. Every record is then a JSON document passed
+ * to a function of the page, which updates the DOM in place; the View repaints what changed and is
+ * captured before the next record is applied. Captures are encoded on native worker threads while
+ * the next record renders, so a record costs a restyle and repaint instead of a full page load.</p>
+ *
+ * <p>The patch function must apply a record synchronously; images or fonts it starts loading are not
+ * waited for. Like {@link UefRenderService} jobs, records advance in {@link UefRenderService#pump()}
+ * and their futures complete on the renderer thread.</p>
+ */
+public final class UefTemplateBatch implements AutoCloseable {
+    private static final Cleaner CLEANER = Cleaner.create();
+
+    private final long batchPtr;
+    private final Cleaner.Cleanable cleanable;
+
+    /**
+     * @param templateHtml The template document
+     * @param patchFunction Expression evaluated once the template loaded, which must yield the function
+     *                      records are passed to, e.g. {@code "applyRecord"}
+     * @param width Width in pixels
+     * @param height Height in pixels
+     * @param scale Device scale the page is laid out at
+     * @param format Encoding of every result
+     */
+    public UefTemplateBatch(String templateHtml, String patchFunction, int width, int height, double scale, ImageFormat format) {
+        if (width <= 0 || height <= 0) {
+            throw new IllegalArgumentException("Image size must be positive: " + width + "x" + height);
+        }
+        this.batchPtr = open(templateHtml, patchFunction, width, height, scale, format);
+        this.cleanable = CLEANER.register(this, new Close(batchPtr));
+    }
+
+    /**
+     * Queue one record. Records render in submission order.
+     *
+     * @param json The record, parsed as JSON and passed to the patch function as its only argument
+     * @return The encoded image. Fails with {@link IllegalStateException} when the template fails to
+     *         load, the JSON is malformed or the patch function throws
+     * @throws IllegalStateException If the batch is closed
+     */
+    public CompletableFuture<ByteBuffer> render(String json) {
+        CompletableFuture<ByteBuffer> future = new CompletableFuture<>();
+        long id = UefRenderService.track(future);
+        try {
+            enqueue(batchPtr, id, json);
+        } catch (IllegalStateException e) {
+            UefRenderService.untrack(id);
+            throw e;
+        }
+        return future;
+    }
+
+    /**
+     * @throws IllegalStateException If the batch is closed
+     */
+    public UefTemplateBatchStats getStats() {
+        long[] stats = new long[UefTemplateBatchStats.LENGTH];
+        stats(batchPtr, stats);
+        return new UefTemplateBatchStats(stats);
+    }
+
+    /**
+     * Release the batch once the records submitted so far are delivered. No records may be submitted
+     * afterwards.
+     */
+    @Override
+    public void close() {
+        cleanable.clean();
+    }
+
+//>------------------- Native methods --------------------<\\
+
+    private static native long open(String html, String function, int width, int height, double scale, ImageFormat format);
+
+    private static native void enqueue(long batchPtr, long id, String json);
+
+    private static native void stats(long batchPtr, long[] stats);
+
+    private static native void close(long batchPtr);
+
+//>------------------- Native methods --------------------<\\
+
+    private static final class Close implements Runnable {
+        private final long batchPtr;
+
+        private Close(long batchPtr) {
+            this.batchPtr = batchPtr;
+        }
+
+        @Override
+        public void run() {
+            close(batchPtr);
+        }
+    }
+}
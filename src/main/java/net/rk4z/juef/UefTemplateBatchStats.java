@@ -0,0 +1,66 @@
+package net.rk4z.juef;
+
+/**
+ * Progress and throughput of a {@link UefTemplateBatch}, see {@link UefTemplateBatch#getStats()}.
+ * A snapshot; it does not update by itself.
+ */
+public final class UefTemplateBatchStats {
+    static final int LENGTH = 6;
+
+    private final long submitted;
+    private final long completed;
+    private final long failed;
+    private final long queued;
+    private final long elapsedNanos;
+    private final long rendererNanos;
+
+    UefTemplateBatchStats(long[] stats) {
+        submitted = stats[0];
+        completed = stats[1];
+        failed = stats[2];
+        queued = stats[3];
+        elapsedNanos = stats[4];
+        rendererNanos = stats[5];
+    }
+
+    public long getSubmitted() {
+        return submitted;
+    }
+
+    public long getCompleted() {
+        return completed;
+    }
+
+    public long getFailed() {
+        return failed;
+    }
+
+    /**
+     * @return Records not yet applied to the template
+     */
+    public long getQueued() {
+        return queued;
+    }
+
+    /**
+     * @return Time from applying the first record to delivering the latest image
+     */
+    public long getElapsedNanos() {
+        return elapsedNanos;
+    }
+
+    /**
+     * @return Delivered records per second over {@link #getElapsedNanos()}
+     */
+    public double getRecordsPerSecond() {
+        return elapsedNanos > 0 ? completed * 1_000_000_000.0 / elapsedNanos : 0;
+    }
+
+    /**
+     * @return Average renderer thread time a record took to patch, paint and capture, encoding excluded
+     */
+    public long getAverageRendererNanos() {
+        long rendered = completed + failed;
+        return rendered > 0 ? rendererNanos / rendered : 0;
+    }
+}
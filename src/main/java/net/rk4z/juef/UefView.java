@@ -1,25 +1,261 @@
 package net.rk4z.juef;
 
-public class UefView {
-    private long viewPtr;
+import net.rk4z.juef.util.HibernateMode;
+import net.rk4z.juef.util.PixelFormat;
+import net.rk4z.juef.util.ViewPriority;
 
-    public UefView(int viewPtr) {
+import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+
+/**
+ * A View created by {@link UefRenderer#createView}.
+ *
+ * <p>The native View is owned by a handle in the native view registry. It is released as soon as
+ * {@link #close()} is called or this object becomes unreachable, whichever comes first. A release
+ * requested from any thread other than the renderer thread is applied on the renderer's next call.</p>
+ */
+public class UefView implements AutoCloseable {
+    private static final Cleaner CLEANER = Cleaner.create();
+
+    private final long viewPtr;
+    private final Cleaner.Cleanable cleanable;
+    private final UefSurface surface = new UefSurface(this);
+    private final int[] surfaceInfo = new int[UefSurface.INFO_LENGTH];
+    private final UefDeltaPacket deltaPacket = new UefDeltaPacket();
+    private final long[] deltaInfo = new long[UefDeltaPacket.INFO_LENGTH];
+
+    UefView(long viewPtr) {
         this.viewPtr = viewPtr;
+        this.cleanable = CLEANER.register(this, new Release(viewPtr));
+    }
+
+    /**
+     * Give this View input focus.
+     */
+    public void focus() {
+        focus(viewPtr);
+    }
+
+    /**
+     * Remove input focus from this View.
+     */
+    public void unFocus() {
+        unFocus(viewPtr);
+    }
+
+    /**
+     * @return Whether this View has input focus
+     */
+    public boolean hasFocus() {
+        return hasFocus(viewPtr);
+    }
+
+    /**
+     * Request a new size for this View. Only the latest request counts: it is applied once, right
+     * before the next {@link UefRenderer#update()} (or display pump), so a window drag firing many
+     * resize events per frame costs a single relayout. See {@link UefRenderer#setResizeCoalescing}.
+     */
+    public void resize(int width, int height) {
+        resize(viewPtr, width, height);
+    }
+
+    /**
+     * Set how urgently {@link UefRenderer#renderFrame()} paints this View.
+     *
+     * @param priority The new priority, {@link ViewPriority#Visible} by default
+     */
+    public void setPriority(ViewPriority priority) {
+        setPriority(viewPtr, priority);
+    }
+
+    /**
+     * Lock this View's CPU Surface and expose its pixels without copying them. The dirty rectangle
+     * reported by the returned surface is cleared in the same call, so each lock reports only what
+     * changed since the previous one.
+     *
+     * <p>The returned object is reused by every call on this View and must be closed (unlocked)
+     * before the renderer paints again. Only available when {@code ViewConfig.isAccelerated} is false.</p>
+     *
+     * @return This View's surface, locked
+     */
+    public UefSurface lockSurface() {
+        ByteBuffer pixels = lockSurface(viewPtr, surfaceInfo);
+        surface.update(pixels, surfaceInfo);
+        if (surface.getDirtyTileCount() > 0) {
+            copyDirtyTiles(viewPtr, surface.getDirtyTiles());
+        }
+        return surface;
+    }
+
+    void unlockSurface() {
+        unlockSurface(viewPtr);
+    }
+
+    /**
+     * Open a reader for the frames of this View's triple-buffered surface. Unlike every other method,
+     * the returned reader may be used from any thread. Only available with
+     * {@code SurfaceType.TripleBuffered}; such Views cannot use {@link #lockSurface()}.
+     *
+     * @return A new reader, to be closed when no longer needed
+     */
+    public UefFrameReader openFrameReader() {
+        return new UefFrameReader(openFrameReader(viewPtr));
+    }
+
+    /**
+     * Copy a rectangle of this View's CPU Surface into a direct buffer, converted to the given format
+     * on the way. Only the rectangle is read; the rest of the surface is never touched.
+     *
+     * @param destination Direct buffer receiving tightly packed rows ({@code width} pixels each),
+     *                    starting at index 0; its position and limit are ignored
+     */
+    public void readRegion(int x, int y, int width, int height, PixelFormat format, ByteBuffer destination) {
+        readRegion(viewPtr, x, y, width, height, format, destination);
+    }
+
+    /**
+     * Find the first element matching a CSS selector and return its on-screen bounds in surface
+     * pixels, clipped to this View.
+     *
+     * @return {x, y, width, height}, or null if nothing matches or the element is outside the View
+     * @throws IllegalArgumentException If the selector is invalid
+     */
+    public int[] getElementBounds(String selector) {
+        int[] bounds = new int[4];
+        return getElementBounds(viewPtr, selector, bounds) ? bounds : null;
+    }
+
+    /**
+     * Read the part of this View covered by the first element matching a CSS selector, e.g. for
+     * element screenshots. Equivalent to {@link #getElementBounds} followed by {@link #readRegion}.
+     *
+     * @param destination Direct buffer large enough for the element's bounds in the given format
+     * @return The bounds that were read as {x, y, width, height}, or null if nothing was read
+     */
+    public int[] readElement(String selector, PixelFormat format, ByteBuffer destination) {
+        int[] bounds = getElementBounds(selector);
+        if (bounds != null) {
+            readRegion(bounds[0], bounds[1], bounds[2], bounds[3], format, destination);
+        }
+        return bounds;
+    }
+
+    /**
+     * Encode what changed on this View's CPU Surface since the previous call, for mirroring the View
+     * on a remote client. Only the surface's dirty rectangle is compared. It is tracked apart from the
+     * one {@link #lockSurface()} reports, so a View can be locked and encoded side by side.
+     *
+     * <p>The first packet, the first one after a resize and those requested with
+     * {@link #requestKeyframe()} or due by {@link #setKeyframeInterval(int)} are keyframes.</p>
+     *
+     * @return The packet, reused by every call on this View, or null when nothing changed
+     */
+    public UefDeltaPacket encodeDelta() {
+        ByteBuffer data = encodeDelta(viewPtr, deltaInfo);
+        if (deltaInfo[0] == 0 && data == null) {
+            return null;
+        }
+        deltaPacket.update(data, deltaInfo);
+        return deltaInfo[0] == 0 ? null : deltaPacket;
+    }
+
+    /**
+     * Set how often {@link #encodeDelta()} emits a keyframe, so clients joining late or dropping a
+     * packet recover on their own.
+     *
+     * @param frames Packets between keyframes, 300 by default; 0 for keyframes only on request
+     */
+    public void setKeyframeInterval(int frames) {
+        setKeyframeInterval(viewPtr, frames);
+    }
+
+    /**
+     * Make the next packet produced by {@link #encodeDelta()} a keyframe, e.g. when a client connects.
+     */
+    public void requestKeyframe() {
+        requestKeyframe(viewPtr);
+    }
+
+    /**
+     * Release this View's surface memory now instead of waiting for
+     * {@link UefRenderer#setHibernation}. The View wakes up when its priority changes or the engine
+     * paints it. Only Views on {@code SurfaceType.Tiled} surfaces, and not while the surface is locked.
+     *
+     * @return Whether the View hibernated
+     */
+    public boolean hibernate(HibernateMode mode) {
+        return hibernate(viewPtr, mode);
+    }
+
+    public boolean isHibernating() {
+        return isHibernating(viewPtr);
+    }
+
+    /**
+     * Release the native View. Calling any other method afterwards throws {@link IllegalStateException}.
+     */
+    @Override
+    public void close() {
+        cleanable.clean();
     }
 
 //>------------------- Native methods --------------------<\\
 
-    public static native void focus();
+    private static native void focus(long viewPtr);
+
+    private static native void unFocus(long viewPtr);
+
+    private static native boolean hasFocus(long viewPtr);
+
+    private static native void setPriority(long viewPtr, ViewPriority priority);
+
+    private static native void resize(long viewPtr, int width, int height);
+
+    private static native void readRegion(long viewPtr, int x, int y, int width, int height, PixelFormat format, ByteBuffer destination);
+
+    private static native boolean getElementBounds(long viewPtr, String selector, int[] bounds);
+
+    private static native ByteBuffer lockSurface(long viewPtr, int[] info);
+
+    private static native void unlockSurface(long viewPtr);
+
+    private static native void copyDirtyTiles(long viewPtr, int[] tiles);
+
+    private static native long openFrameReader(long viewPtr);
+
+    private static native ByteBuffer encodeDelta(long viewPtr, long[] info);
+
+    private static native void setKeyframeInterval(long viewPtr, int frames);
+
+    private static native void requestKeyframe(long viewPtr);
+
+    private static native boolean hibernate(long viewPtr, HibernateMode mode);
+
+    private static native boolean isHibernating(long viewPtr);
+
+    private static native void release(long viewPtr);
 
 //>------------------- Native methods --------------------<\\
 
     /**
-     * @deprecated This is a low-level function that directly returns the View's Ptr and should not be used unless really necessary
+     * @deprecated This is a low-level function that directly returns the View's handle and should not be used unless really necessary
      *
-     * @return The View's Ptr
+     * @return The View's handle in the native view registry
      */
     public long getViewPtr() {
         return viewPtr;
     }
 
+    private static final class Release implements Runnable {
+        private final long viewPtr;
+
+        private Release(long viewPtr) {
+            this.viewPtr = viewPtr;
+        }
+
+        @Override
+        public void run() {
+            release(viewPtr);
+        }
+    }
 }
@@ -0,0 +1,30 @@
+package net.rk4z.juef.configuration;
+
+import java.nio.ByteBuffer;
+
+/**
+ * A configuration serialized into the compact layout the native side decodes in a single call.
+ *
+ * <p>The version stamp identifies this exact packing; the native side caches decoded configs by it,
+ * so handing the same instance over repeatedly is free after the first time.</p>
+ */
+public final class PackedConfig {
+    private final ByteBuffer buffer;
+    private final long version;
+
+    PackedConfig(ByteBuffer buffer, long version) {
+        this.buffer = buffer;
+        this.version = version;
+    }
+
+    /**
+     * @return A read-only view of the direct buffer holding the packed bytes
+     */
+    public ByteBuffer getBuffer() {
+        return buffer;
+    }
+
+    public long getVersion() {
+        return version;
+    }
+}
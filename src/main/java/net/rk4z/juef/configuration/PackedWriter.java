@@ -0,0 +1,70 @@
+package net.rk4z.juef.configuration;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * Writes the layout read by the native {@code PackedReader}: native-endian scalars, enums as one
+ * ordinal byte, and strings as an int byte length (-1 for null) followed by UTF-8.
+ */
+final class PackedWriter {
+    private static final AtomicLong NEXT_VERSION = new AtomicLong(1);
+
+    private ByteBuffer buffer = ByteBuffer.allocate(256).order(ByteOrder.nativeOrder());
+
+    PackedWriter putInt(int value) {
+        ensure(Integer.BYTES).putInt(value);
+        return this;
+    }
+
+    PackedWriter putLong(long value) {
+        ensure(Long.BYTES).putLong(value);
+        return this;
+    }
+
+    PackedWriter putDouble(double value) {
+        ensure(Double.BYTES).putDouble(value);
+        return this;
+    }
+
+    PackedWriter putBoolean(boolean value) {
+        ensure(1).put((byte) (value ? 1 : 0));
+        return this;
+    }
+
+    PackedWriter putEnum(Enum<?> value) {
+        ensure(1).put((byte) (value == null ? -1 : value.ordinal()));
+        return this;
+    }
+
+    PackedWriter putString(String value) {
+        if (value == null) {
+            return putInt(-1);
+        }
+
+        byte[] bytes = value.getBytes(StandardCharsets.UTF_8);
+        putInt(bytes.length);
+        ensure(bytes.length).put(bytes);
+        return this;
+    }
+
+    PackedConfig finish() {
+        buffer.flip();
+        ByteBuffer direct = ByteBuffer.allocateDirect(buffer.remaining()).order(ByteOrder.nativeOrder());
+        direct.put(buffer).flip();
+        return new PackedConfig(direct.asReadOnlyBuffer(), NEXT_VERSION.getAndIncrement());
+    }
+
+    private ByteBuffer ensure(int bytes) {
+        if (buffer.remaining() < bytes) {
+            ByteBuffer grown = ByteBuffer.allocate(Math.max(buffer.capacity() * 2, buffer.position() + bytes))
+                    .order(ByteOrder.nativeOrder());
+            buffer.flip();
+            grown.put(buffer);
+            buffer = grown;
+        }
+        return buffer;
+    }
+}
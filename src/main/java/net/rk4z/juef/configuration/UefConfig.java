@@ -1,5 +1,6 @@
 package net.rk4z.juef.configuration;
 
+import net.rk4z.juef.util.AllocatorMode;
 import net.rk4z.juef.util.EffectQuality;
 import net.rk4z.juef.util.FaceWinding;
 import net.rk4z.juef.util.FontHinting;
@@ -24,6 +25,8 @@ public class UefConfig {
     private final double maxUpdateTime;
     private final long bitmapAlignment;
     private final EffectQuality effectQuality;
+    private final AllocatorMode allocatorMode;
+    private PackedConfig packed;
 
     public UefConfig() {
         this.cachePath = ".cache/";
@@ -45,6 +48,7 @@ public class UefConfig {
         this.maxUpdateTime = 1.0 / 200.0;
         this.bitmapAlignment = 16;
         this.effectQuality = EffectQuality.Medium;
+        this.allocatorMode = AllocatorMode.System;
     }
 
     public UefConfig(String cachePath, String resourcePathPrefix, FaceWinding faceWinding, FontHinting fontHinting,
@@ -52,6 +56,23 @@ public class UefConfig {
                      double scrollTimerDelay, double recycleDelay, long memoryCacheSize, long pageCacheSize,
                      long overrideRamSize, long minLargeHeapSize, long minSmallHeapSize, long numRendererThreads,
                      double maxUpdateTime, long bitmapAlignment, EffectQuality effectQuality) {
+        this(cachePath, resourcePathPrefix, faceWinding, fontHinting, fontGamma, userStylesheet, forceRepaint,
+             animationTimerDelay, scrollTimerDelay, recycleDelay, memoryCacheSize, pageCacheSize, overrideRamSize,
+             minLargeHeapSize, minSmallHeapSize, numRendererThreads, maxUpdateTime, bitmapAlignment, effectQuality,
+             AllocatorMode.System);
+    }
+
+    /**
+     * @param allocatorMode The allocator behind the engine's heap, installed by {@code UefPlatform.setConfig}.
+     *                      Best chosen in the first call, as the engine allocates from then on; it cannot
+     *                      change once the Renderer exists, and {@link AllocatorMode#Pool} not at all.
+     */
+    public UefConfig(String cachePath, String resourcePathPrefix, FaceWinding faceWinding, FontHinting fontHinting,
+                     double fontGamma, String userStylesheet, boolean forceRepaint, double animationTimerDelay,
+                     double scrollTimerDelay, double recycleDelay, long memoryCacheSize, long pageCacheSize,
+                     long overrideRamSize, long minLargeHeapSize, long minSmallHeapSize, long numRendererThreads,
+                     double maxUpdateTime, long bitmapAlignment, EffectQuality effectQuality,
+                     AllocatorMode allocatorMode) {
         this.cachePath = cachePath;
         this.resourcePathPrefix = resourcePathPrefix;
         this.faceWinding = faceWinding;
@@ -71,6 +92,39 @@ public class UefConfig {
         this.maxUpdateTime = maxUpdateTime;
         this.bitmapAlignment = bitmapAlignment;
         this.effectQuality = effectQuality;
+        this.allocatorMode = allocatorMode;
     }
-}
 
+    /**
+     * Serializes this config for the native side. UefConfig is immutable, so it is packed once.
+     *
+     * @return The packed form of this config
+     */
+    public synchronized PackedConfig pack() {
+        if (packed == null) {
+            packed = new PackedWriter()
+                    .putString(cachePath)
+                    .putString(resourcePathPrefix)
+                    .putString(userStylesheet)
+                    .putEnum(faceWinding)
+                    .putEnum(fontHinting)
+                    .putEnum(effectQuality)
+                    .putBoolean(forceRepaint)
+                    .putDouble(fontGamma)
+                    .putDouble(animationTimerDelay)
+                    .putDouble(scrollTimerDelay)
+                    .putDouble(recycleDelay)
+                    .putDouble(maxUpdateTime)
+                    .putLong(memoryCacheSize)
+                    .putLong(pageCacheSize)
+                    .putLong(overrideRamSize)
+                    .putLong(minLargeHeapSize)
+                    .putLong(minSmallHeapSize)
+                    .putLong(numRendererThreads)
+                    .putLong(bitmapAlignment)
+                    .putEnum(allocatorMode)
+                    .finish();
+        }
+        return packed;
+    }
+}
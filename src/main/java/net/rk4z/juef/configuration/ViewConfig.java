@@ -5,6 +5,8 @@ import net.rk4z.juef.UefPlatform;
 import net.rk4z.juef.UefRenderer;
 import net.rk4z.juef.UefView;
 
+import java.util.Objects;
+
 /**
  * View-specific configuration settings.
  *
@@ -104,4 +106,71 @@ public class ViewConfig {
     public String userAgent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64) "
             + "AppleWebKit/615.1.18.100.1 (KHTML, like Gecko) "
             + "Ultralight/1.4.0 Version/16.4.1 Safari/615.1.18.100.1";
+
+    private ViewConfig packedFrom;
+    private PackedConfig packed;
+
+    /**
+     * Serializes this config for the native side. The previous packing (and its version stamp) is
+     * reused for as long as none of the fields above have changed, so creating many views from one
+     * config marshals it only once.
+     *
+     * @return The packed form of the current field values
+     */
+    public synchronized PackedConfig pack() {
+        if (packed == null || !sameAs(packedFrom)) {
+            packed = new PackedWriter()
+                    .putInt(displayId)
+                    .putDouble(initialDeviceScale)
+                    .putBoolean(isAccelerated)
+                    .putBoolean(isTransparent)
+                    .putBoolean(initialFocus)
+                    .putBoolean(enableImages)
+                    .putBoolean(enableJavaScript)
+                    .putBoolean(enableCompositor)
+                    .putString(fontFamilyStandard)
+                    .putString(fontFamilyFixed)
+                    .putString(fontFamilySerif)
+                    .putString(fontFamilySansSerif)
+                    .putString(userAgent)
+                    .finish();
+            packedFrom = copy();
+        }
+        return packed;
+    }
+
+    private ViewConfig copy() {
+        ViewConfig copy = new ViewConfig();
+        copy.displayId = displayId;
+        copy.isAccelerated = isAccelerated;
+        copy.initialDeviceScale = initialDeviceScale;
+        copy.isTransparent = isTransparent;
+        copy.initialFocus = initialFocus;
+        copy.enableImages = enableImages;
+        copy.enableJavaScript = enableJavaScript;
+        copy.enableCompositor = enableCompositor;
+        copy.fontFamilyStandard = fontFamilyStandard;
+        copy.fontFamilyFixed = fontFamilyFixed;
+        copy.fontFamilySerif = fontFamilySerif;
+        copy.fontFamilySansSerif = fontFamilySansSerif;
+        copy.userAgent = userAgent;
+        return copy;
+    }
+
+    private boolean sameAs(ViewConfig other) {
+        return other != null
+                && displayId == other.displayId
+                && isAccelerated == other.isAccelerated
+                && Double.compare(initialDeviceScale, other.initialDeviceScale) == 0
+                && isTransparent == other.isTransparent
+                && initialFocus == other.initialFocus
+                && enableImages == other.enableImages
+                && enableJavaScript == other.enableJavaScript
+                && enableCompositor == other.enableCompositor
+                && Objects.equals(fontFamilyStandard, other.fontFamilyStandard)
+                && Objects.equals(fontFamilyFixed, other.fontFamilyFixed)
+                && Objects.equals(fontFamilySerif, other.fontFamilySerif)
+                && Objects.equals(fontFamilySansSerif, other.fontFamilySansSerif)
+                && Objects.equals(userAgent, other.userAgent);
+    }
 }
@@ -0,0 +1,25 @@
+package net.rk4z.juef.util;
+
+/**
+ * Which allocator serves the engine's own heap, see {@code UefConfig} and
+ * {@code UefPlatform.getAllocatorStats()}. Only library builds with allocator overrides enabled call
+ * into it; otherwise every mode behaves like {@link #System} and nothing is counted.
+ */
+public enum AllocatorMode {
+    /**
+     * The library's default allocator. Nothing is counted.
+     */
+    System,
+
+    /**
+     * Size-class pools with a free list per thread, which keep small allocations off the system
+     * allocator's locks. Memory taken for the pool is never returned to the system. Once installed
+     * the pool stays for the life of the process.
+     */
+    Pool,
+
+    /**
+     * The library's default allocator, with every allocation counted.
+     */
+    Instrumented
+}
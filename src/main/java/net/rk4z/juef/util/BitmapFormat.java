@@ -0,0 +1,16 @@
+package net.rk4z.juef.util;
+
+/**
+ * The various Bitmap formats.
+ */
+public enum BitmapFormat {
+    /**
+     * Alpha channel only, 8-bits per pixel. Linear color-space (no gamma), alpha-coverage only.
+     */
+    A8_UNORM,
+
+    /**
+     * Blue Green Red Alpha channels, 32-bits per pixel. sRGB gamma with premultiplied linear alpha.
+     */
+    BGRA8_UNORM_SRGB
+}
@@ -0,0 +1,17 @@
+package net.rk4z.juef.util;
+
+/**
+ * What happens to a View's pixels while it hibernates, see {@code UefRenderer.setHibernation}.
+ */
+public enum HibernateMode {
+    /**
+     * Keep a losslessly compressed copy and decode it on restore.
+     */
+    Compress,
+
+    /**
+     * Keep nothing and have the engine paint the whole View again on restore. Frees the most memory,
+     * but restoring costs a layout and a full paint, and the page sees a resize.
+     */
+    Drop
+}
@@ -0,0 +1,22 @@
+package net.rk4z.juef.util;
+
+/**
+ * Output encoding of images produced natively, e.g. by {@code UefRenderService}.
+ */
+public enum ImageFormat {
+    /**
+     * Premultiplied BGRA, 4 bytes per pixel, rows tightly packed (width * 4 bytes).
+     */
+    Raw,
+
+    /**
+     * PNG with straight-alpha RGBA pixels, deflated in parallel strips.
+     */
+    Png,
+
+    /**
+     * QOI-style fast lossless encoding of the premultiplied BGRA bytes as they are. Meant for
+     * internal caches; other QOI decoders will see swapped red/blue and premultiplied alpha.
+     */
+    Qoi
+}
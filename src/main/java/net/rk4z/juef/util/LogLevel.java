@@ -0,0 +1,10 @@
+package net.rk4z.juef.util;
+
+/**
+ * Log levels used by the engine's logger.
+ */
+public enum LogLevel {
+    Error,
+    Warning,
+    Info
+}
@@ -0,0 +1,12 @@
+package net.rk4z.juef.util;
+
+/**
+ * Severity of a console message.
+ */
+public enum MessageLevel {
+    Log,
+    Warning,
+    Error,
+    Debug,
+    Info
+}
@@ -0,0 +1,24 @@
+package net.rk4z.juef.util;
+
+/**
+ * Where a console message originated from.
+ */
+public enum MessageSource {
+    XML,
+    JS,
+    Network,
+    ConsoleAPI,
+    Storage,
+    AppCache,
+    Rendering,
+    CSS,
+    Security,
+    ContentBlocker,
+    Media,
+    MediaSource,
+    WebRTC,
+    ITPDebug,
+    PrivateClickMeasurement,
+    PaymentRequest,
+    Other
+}
@@ -0,0 +1,27 @@
+package net.rk4z.juef.util;
+
+/**
+ * Destination layouts of {@code UefPixels#convert}. Surfaces are premultiplied BGRA; every format
+ * except {@link #IntArgbPre} and {@link #Rgb} is converted to straight alpha.
+ */
+public enum PixelFormat {
+    /**
+     * Straight-alpha R, G, B, A bytes.
+     */
+    Rgba,
+
+    /**
+     * Straight-alpha ARGB ints, as used by {@code BufferedImage.TYPE_INT_ARGB}.
+     */
+    IntArgb,
+
+    /**
+     * Premultiplied ARGB ints, as used by {@code BufferedImage.TYPE_INT_ARGB_PRE}. A plain copy.
+     */
+    IntArgbPre,
+
+    /**
+     * Opaque R, G, B bytes, 3 per pixel. Translucent pixels come out composited over black.
+     */
+    Rgb
+}
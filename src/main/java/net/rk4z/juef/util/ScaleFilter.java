@@ -0,0 +1,16 @@
+package net.rk4z.juef.util;
+
+/**
+ * Resampling filter used by {@code UefDownscaler}.
+ */
+public enum ScaleFilter {
+    /**
+     * Area average: each output pixel is the mean of the source pixels it covers. Fast, slightly soft.
+     */
+    Box,
+
+    /**
+     * Three-lobe Lanczos windowed sinc. Sharper, at a few times the cost of {@link #Box}.
+     */
+    Lanczos
+}
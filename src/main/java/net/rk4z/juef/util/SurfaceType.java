@@ -0,0 +1,23 @@
+package net.rk4z.juef.util;
+
+/**
+ * The kind of Surface CPU-rendered Views paint into.
+ */
+public enum SurfaceType {
+    /**
+     * The engine's own bitmap surfaces. Damage is reported only as a single union rectangle.
+     */
+    Bitmap,
+
+    /**
+     * Surfaces that additionally record damage per tile, see {@code UefSurface#getDirtyTiles()}.
+     */
+    Tiled,
+
+    /**
+     * Tiled surfaces whose frames are triple-buffered, so a reader on another thread can pick up
+     * the latest complete frame without ever blocking the renderer, see
+     * {@code UefView#openFrameReader()}.
+     */
+    TripleBuffered
+}
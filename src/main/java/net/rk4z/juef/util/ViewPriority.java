@@ -0,0 +1,27 @@
+package net.rk4z.juef.util;
+
+/**
+ * How urgently a View should be painted by {@code UefRenderer#renderFrame()}.
+ */
+public enum ViewPriority {
+    /**
+     * Painted every frame it has damage, regardless of the frame budget.
+     */
+    Focused,
+
+    /**
+     * Painted while the frame budget allows. This is the default.
+     */
+    Visible,
+
+    /**
+     * Painted only when budget is left over after Visible Views, or once it has been deferred for
+     * the configured number of starvation frames.
+     */
+    Background,
+
+    /**
+     * Never painted; damage is kept until the priority changes.
+     */
+    Hidden
+}
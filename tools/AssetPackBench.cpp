@@ -0,0 +1,89 @@
+// Compares serving files from an asset pack against loose files through AppCore's platform file
+// system. Built with -DUEF_BUILD_BENCHMARKS=ON:
+//
+//   uef-asset-pack-bench <directory> <pack> [rounds]
+//
+// where <pack> was built from <directory> by UefAssetPacker (./gradlew packAssets). Every round opens
+// each file of the pack once through both file systems and reads every cache line of it.
+
+#include "AssetPack.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <AppCore/Platform.h>
+
+struct Result {
+    double seconds;
+    uint64_t bytes;
+    uint64_t checksum;
+    size_t missing;
+};
+
+static Result Run(FileSystem &fileSystem, const std::vector<String> &paths, int rounds) {
+    Result result{0, 0, 0, 0};
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (const String &path : paths) {
+            RefPtr<Buffer> buffer = fileSystem.OpenFile(path);
+            if (!buffer) {
+                result.missing++;
+                continue;
+            }
+            auto data = static_cast<const uint8_t *>(buffer->data());
+            for (size_t i = 0; i < buffer->size(); i += 64) {
+                result.checksum += data[i];
+            }
+            result.bytes += buffer->size();
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+static void Report(const char *name, const Result &result, size_t opens) {
+    printf("%-6s %10.2f us/file %10.1f MiB/s  (checksum %llu, %zu missing)\n", name,
+           result.seconds * 1e6 / static_cast<double>(opens), static_cast<double>(result.bytes) / result.seconds / (1 << 20),
+           static_cast<unsigned long long>(result.checksum), result.missing);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <directory> <pack> [rounds]\n", argv[0]);
+        return 2;
+    }
+    int rounds = argc > 3 ? std::max(atoi(argv[3]), 1) : 20;
+
+    std::string error;
+    std::shared_ptr<AssetPack> pack = AssetPack::open(argv[2], error);
+    if (!pack) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<String> paths;
+    for (uint32_t i = 0; i < pack->size(); i++) {
+        std::string path = pack->path(pack->entry(i));
+        paths.emplace_back(path.data(), path.size());
+    }
+
+    std::string directory = argv[1];
+    if (!directory.empty() && directory.back() != '/') {
+        directory += '/';
+    }
+    FileSystem *loose = GetPlatformFileSystem(directory.c_str());
+
+    // One warm-up round each, so both sides are measured with a hot page cache.
+    Run(*loose, paths, 1);
+    Run(*pack, paths, 1);
+
+    size_t opens = paths.size() * static_cast<size_t>(rounds);
+    printf("%zu files, %d rounds\n", paths.size(), rounds);
+    Report("loose", Run(*loose, paths, rounds), opens);
+    Report("pack", Run(*pack, paths, rounds), opens);
+    return 0;
+}